@@ -0,0 +1,251 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+// Block faces, in the order every per-face table uses. The opposite face of f is f ^ 1.
+enum BlockFace : uint8_t
+{
+    FaceNegX,
+    FacePosX,
+    FaceNegY,
+    FacePosY,
+    FaceNegZ,
+    FacePosZ
+};
+
+constexpr int FACE_DIRS[6][3] = {{-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}};
+
+constexpr int faceFromNormal(int nx, int ny, int nz)
+{
+    if (nx != 0)
+        return nx > 0 ? FacePosX : FaceNegX;
+    if (ny != 0)
+        return ny > 0 ? FacePosY : FaceNegY;
+    return nz > 0 ? FacePosZ : FaceNegZ;
+}
+
+// Atlas tiles in atlas order: one base tile per block type, then the extra face tiles. The sign/HUD
+// glyph tiles start at TILE_COUNT.
+enum AtlasTile : uint8_t
+{
+    TileGrass,
+    TileDirt,
+    TileStone,
+    TileWood,
+    TileLeaves,
+    TileWater,
+    TilePlank,
+    TileSand,
+    TileAir,
+    TileGlass,
+    TileAnd,
+    TileOr,
+    TileNot,
+    TileXor,
+    TileLed,
+    TileButton,
+    TileWire,
+    TileSign,
+    TileDff,
+    TileAdd,
+    TileCounter,
+    TileSplitter,
+    TileMerger,
+    TileDecoder,
+    TileMux,
+    TileComparator,
+    TileClock,
+    TileGrassTop,
+    TileAndTop,
+    TileOrTop,
+    TileNotTop,
+    TileXorTop,
+    TileDffTop,
+    TileAddTop,
+    TileAddBottom,
+    TileAddBack,
+    TileCounterTop,
+    TileSplitterTop,
+    TileMergerTop,
+    TileDecoderTop,
+    TileMuxTop,
+    TileMuxIn0,
+    TileMuxIn1,
+    TileMuxIn2,
+    TileMuxIn3,
+    TileComparatorTop,
+    TileComparatorInLeft,
+    TileComparatorInRight,
+    TileComparatorGt,
+    TileComparatorEq,
+    TileComparatorLt,
+    TileClockTop,
+    TILE_COUNT
+};
+
+// How the mesher tints a block from its power level
+enum class PowerLook : uint8_t
+{
+    None,
+    Lamp,  // bright + emissive when lit, desaturated when off
+    Wire,  // glows when carrying a signal
+    Latch, // faint glow while holding a value
+    Adder  // accent when a neighbouring input is powered
+};
+
+constexpr int NO_PORT = -1;
+
+// Logic ports as faces of the block. The order inside `in` / `out` is the port's role, see BLOCK_TRAITS.
+struct PortLayout
+{
+    std::array<int8_t, 5> in{{NO_PORT, NO_PORT, NO_PORT, NO_PORT, NO_PORT}};
+    std::array<int8_t, 3> out{{NO_PORT, NO_PORT, NO_PORT}};
+    bool anyFace = false; // wires, buttons and LEDs connect on every face
+};
+
+struct BlockTraits
+{
+    const char *name;
+    bool solid;       // collision, raycast and surface height
+    bool occludes;    // hides the faces of neighbouring blocks
+    bool transparent; // can be seen through
+    std::array<float, 3> color;
+    bool colorInTile; // the tile already carries the color; the vertex color only shades it
+    uint8_t tile;     // base tile, also used for icons
+    std::array<uint8_t, 6> faceTiles;
+    PowerLook look;
+    float emissive; // added to the face light while powered
+    PortLayout ports;
+};
+
+constexpr std::array<uint8_t, 6> tilesAll(uint8_t t) { return {{t, t, t, t, t, t}}; }
+
+constexpr std::array<uint8_t, 6> tilesWithTop(uint8_t side, uint8_t top) { return {{side, side, side, top, side, side}}; }
+
+constexpr PortLayout ports(std::initializer_list<int> in, std::initializer_list<int> out)
+{
+    PortLayout p;
+    size_t i = 0;
+    for (int f : in)
+        p.in[i++] = static_cast<int8_t>(f);
+    i = 0;
+    for (int f : out)
+        p.out[i++] = static_cast<int8_t>(f);
+    return p;
+}
+
+constexpr PortLayout anyFacePorts()
+{
+    PortLayout p;
+    p.anyFace = true;
+    return p;
+}
+
+constexpr int BLOCK_TYPE_COUNT = static_cast<int>(BlockType::Clock) + 1;
+
+// Indexed by BlockType. Port roles: AND/OR/XOR in {A, B} out {Y}; NOT in {A} out {Y}; D flip-flop in {D, CLK}
+// out {Q}; adder in {P, Q, Cin} out {Sum, Cout}; counter in {value}; splitter in {bus} out {B1, B2}; merger
+// in {B1, B2} out {bus}; decoder in {SEL, EN} out {Y}; mux in {SEL, D0, D1, D2, D3} out {Y}; comparator
+// in {B, A} out {>, =, <}; clock out {Y}.
+inline constexpr std::array<BlockTraits, BLOCK_TYPE_COUNT> BLOCK_TRAITS = {{
+    {"Air", false, false, true, {0.7f, 0.85f, 1.0f}, false, TileAir, tilesAll(TileAir), PowerLook::None, 0.0f, {}},
+    {"Grass", true, true, false, {0.2f, 0.7f, 0.2f}, true, TileGrass,
+     {{TileGrass, TileGrass, TileDirt, TileGrassTop, TileGrass, TileGrass}}, PowerLook::None, 0.0f, {}},
+    {"Dirt", true, true, false, {0.62f, 0.4f, 0.22f}, true, TileDirt, tilesAll(TileDirt), PowerLook::None, 0.0f, {}},
+    {"Stone", true, true, false, {0.78f, 0.78f, 0.78f}, false, TileStone, tilesAll(TileStone), PowerLook::None, 0.0f,
+     {}},
+    {"Wood", true, true, false, {0.8f, 0.65f, 0.45f}, false, TileWood, tilesAll(TileWood), PowerLook::None, 0.0f, {}},
+    {"Leaves", true, true, false, {0.25f, 0.6f, 0.25f}, false, TileLeaves, tilesAll(TileLeaves), PowerLook::None, 0.0f,
+     {}},
+    {"Water", false, false, true, {0.2f, 0.4f, 0.9f}, false, TileWater, tilesAll(TileWater), PowerLook::None, 0.0f, {}},
+    {"Plank", true, true, false, {0.75f, 0.6f, 0.4f}, false, TilePlank, tilesAll(TilePlank), PowerLook::None, 0.0f, {}},
+    {"Sand", true, true, false, {0.9f, 0.8f, 0.6f}, false, TileSand, tilesAll(TileSand), PowerLook::None, 0.0f, {}},
+    {"Glass", true, false, true, {0.82f, 0.93f, 0.98f}, false, TileGlass, tilesAll(TileGlass), PowerLook::None, 0.0f,
+     {}},
+    {"AND", true, true, false, {0.18f, 0.7f, 0.32f}, false, TileAnd, tilesWithTop(TileAnd, TileAndTop), PowerLook::None,
+     0.0f, ports({FaceNegX, FacePosX}, {FacePosZ})},
+    {"OR", true, true, false, {0.92f, 0.56f, 0.18f}, false, TileOr, tilesWithTop(TileOr, TileOrTop), PowerLook::None,
+     0.0f, ports({FaceNegX, FacePosX}, {FacePosZ})},
+    {"NOT", true, true, false, {0.45f, 0.25f, 0.7f}, false, TileNot, tilesWithTop(TileNot, TileNotTop), PowerLook::None,
+     0.0f, ports({FacePosX}, {FaceNegX})},
+    {"XOR", true, true, false, {0.2f, 0.5f, 0.9f}, false, TileXor, tilesWithTop(TileXor, TileXorTop), PowerLook::None,
+     0.0f, ports({FaceNegX, FacePosX}, {FacePosZ})},
+    {"LED", true, true, false, {0.95f, 0.9f, 0.2f}, false, TileLed, tilesAll(TileLed), PowerLook::Lamp, 0.25f,
+     anyFacePorts()},
+    {"Button", true, true, false, {0.6f, 0.2f, 0.2f}, false, TileButton, tilesAll(TileButton), PowerLook::None, 0.0f,
+     anyFacePorts()},
+    {"Wire", true, false, true, {0.55f, 0.57f, 0.6f}, false, TileWire, tilesAll(TileWire), PowerLook::Wire, 0.6f,
+     anyFacePorts()},
+    {"Sign", false, false, true, {0.85f, 0.7f, 0.45f}, false, TileSign, tilesAll(TileSign), PowerLook::None, 0.0f, {}},
+    {"FLIPFLOP D", true, true, false, {0.2f, 0.78f, 0.72f}, false, TileDff, tilesWithTop(TileDff, TileDffTop),
+     PowerLook::Latch, 0.08f, ports({FacePosX, FaceNegX}, {FacePosZ})},
+    {"ADD", true, true, false, {0.9f, 0.42f, 0.3f}, false, TileAdd,
+     {{TileAdd, TileAdd, TileAddBottom, TileAddTop, TileAddBack, TileAdd}}, PowerLook::Adder, 0.0f,
+     ports({FaceNegX, FacePosX, FaceNegZ}, {FacePosZ, FaceNegY})},
+    {"Counter", true, true, false, {0.8f, 0.8f, 0.25f}, false, TileCounter, tilesWithTop(TileCounter, TileCounterTop),
+     PowerLook::None, 0.0f, ports({FacePosX}, {})},
+    {"Splitter", true, true, false, {0.2f, 0.75f, 0.7f}, false, TileSplitter,
+     tilesWithTop(TileSplitter, TileSplitterTop), PowerLook::None, 0.0f, ports({FaceNegZ}, {FaceNegX, FacePosX})},
+    {"Merger", true, true, false, {0.75f, 0.4f, 0.85f}, false, TileMerger, tilesWithTop(TileMerger, TileMergerTop),
+     PowerLook::None, 0.0f, ports({FaceNegX, FacePosX}, {FacePosZ})},
+    {"Decoder", true, true, false, {0.35f, 0.55f, 0.85f}, false, TileDecoder, tilesWithTop(TileDecoder, TileDecoderTop),
+     PowerLook::None, 0.0f, ports({FaceNegX, FacePosX}, {FacePosZ})},
+    {"Mux", true, true, false, {0.55f, 0.35f, 0.85f}, false, TileMux,
+     {{TileMux, TileMux, TileMuxIn2, TileMuxTop, TileMuxIn0, TileMuxIn1}}, PowerLook::None, 0.0f,
+     ports({FaceNegX, FaceNegZ, FacePosZ, FaceNegY, FacePosY}, {FacePosX})},
+    {"Comparator", true, true, false, {0.25f, 0.52f, 0.86f}, false, TileComparator,
+     {{TileComparatorInLeft, TileComparatorInRight, TileComparatorLt, TileComparatorTop, TileComparatorGt,
+       TileComparatorEq}},
+     PowerLook::None, 0.0f, ports({FaceNegX, FacePosX}, {FaceNegZ, FacePosZ, FaceNegY})},
+    {"CLK", true, true, false, {0.9f, 0.82f, 0.25f}, false, TileClock, tilesWithTop(TileClock, TileClockTop),
+     PowerLook::None, 0.0f, ports({}, {FacePosZ})},
+}};
+
+constexpr const BlockTraits &blockTraits(BlockType b) { return BLOCK_TRAITS[static_cast<size_t>(b)]; }
+
+constexpr bool isSolid(BlockType b) { return blockTraits(b).solid; }
+constexpr bool occludesFaces(BlockType b) { return blockTraits(b).occludes; }
+constexpr bool isTransparent(BlockType b) { return blockTraits(b).transparent; }
+
+// True if the block takes part in logic at all (has a port, or connects on every face)
+constexpr bool hasPorts(BlockType b)
+{
+    const PortLayout &p = blockTraits(b).ports;
+    return p.anyFace || p.in[0] != NO_PORT || p.out[0] != NO_PORT;
+}
+
+// True if something on face `face` of block b is wired to it
+constexpr bool connectsOnFace(BlockType b, int face)
+{
+    const PortLayout &p = blockTraits(b).ports;
+    if (p.anyFace)
+        return true;
+    for (int8_t f : p.in)
+        if (f == face)
+            return true;
+    for (int8_t f : p.out)
+        if (f == face)
+            return true;
+    return false;
+}
+
+// Neighbouring cell feeding input `port` / driven by output `port` of a block of type b at (x, y, z)
+constexpr std::array<int, 3> inputCell(BlockType b, int port, int x, int y, int z)
+{
+    const int *d = FACE_DIRS[blockTraits(b).ports.in[port]];
+    return {{x + d[0], y + d[1], z + d[2]}};
+}
+
+constexpr std::array<int, 3> outputCell(BlockType b, int port, int x, int y, int z)
+{
+    const int *d = FACE_DIRS[blockTraits(b).ports.out[port]];
+    return {{x + d[0], y + d[1], z + d[2]}};
+}
+
+static_assert(blockTraits(BlockType::Clock).tile == TileClock, "BLOCK_TRAITS must follow BlockType order");
+static_assert(!occludesFaces(BlockType::Glass) && isTransparent(BlockType::Wire), "see-through blocks");
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Byte buffers of the file formats (.bulldog, journals, replays)
+
+// Values are stored in host byte order, as the header always has been
+template <typename T> inline void put(std::vector<char> &out, const T &v)
+{
+    const char *p = reinterpret_cast<const char *>(&v);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+// Bounds-checked cursor over a file loaded in one read; any overrun clears ok and every later read fails
+struct ByteReader
+{
+    const char *pos;
+    const char *end;
+    bool ok = true;
+
+    const char *take(size_t n)
+    {
+        if (!ok || static_cast<size_t>(end - pos) < n)
+        {
+            ok = false;
+            return nullptr;
+        }
+        const char *p = pos;
+        pos += n;
+        return p;
+    }
+    bool read(void *dst, size_t n)
+    {
+        const char *p = take(n);
+        if (p)
+            std::memcpy(dst, p, n);
+        return p != nullptr;
+    }
+    template <typename T> T get()
+    {
+        T v{};
+        read(&v, sizeof(T));
+        return v;
+    }
+};
@@ -0,0 +1,112 @@
+#include "clipboard.hpp"
+
+#include "blocks.hpp"
+
+#include <algorithm>
+
+void copyToClipboard(const World &world, int ax, int ay, int az, int bx, int by, int bz, Clipboard &out)
+{
+    const int x0 = std::clamp(std::min(ax, bx), 0, world.getWidth() - 1);
+    const int y0 = std::clamp(std::min(ay, by), 0, world.getHeight() - 1);
+    const int z0 = std::clamp(std::min(az, bz), 0, world.getDepth() - 1);
+    out.nx = std::clamp(std::max(ax, bx), 0, world.getWidth() - 1) - x0 + 1;
+    out.ny = std::clamp(std::max(ay, by), 0, world.getHeight() - 1) - y0 + 1;
+    out.nz = std::clamp(std::max(az, bz), 0, world.getDepth() - 1) - z0 + 1;
+    const size_t n = static_cast<size_t>(out.nx) * out.ny * out.nz;
+
+    std::vector<uint8_t> planes(n * DENSE_PLANE_COUNT);
+    world.exportRegion(x0, y0, z0, out.nx, out.ny, out.nz, planes.data());
+    const BlockType *types = reinterpret_cast<const BlockType *>(planes.data() + PlaneTiles * n);
+    out.tiles.assign(types, types + n);
+
+    // keep the attributes a paste of the bare types would not reproduce; power on blocks without ports (wires) is
+    // recomputed by the next logic pass anyway
+    std::vector<uint8_t> fresh(n * DENSE_PLANE_COUNT);
+    World::defaultPlanes(out.tiles.data(), static_cast<int>(n), fresh.data());
+    out.attributes.clear();
+    out.signs.clear();
+    for (size_t i = 0; i < n; ++i)
+    {
+        Clipboard::CellAttributes attrs;
+        bool differs = false;
+        const int first = hasPorts(out.tiles[i]) ? PlanePower : PlaneButtonState;
+        for (int p = PlanePower; p < first; ++p)
+            attrs.planes[p - PlanePower] = fresh[p * n + i];
+        for (int p = first; p < DENSE_PLANE_COUNT; ++p)
+        {
+            attrs.planes[p - PlanePower] = planes[p * n + i];
+            differs |= planes[p * n + i] != fresh[p * n + i];
+        }
+        if (differs)
+        {
+            attrs.cell = static_cast<int>(i);
+            out.attributes.push_back(attrs);
+        }
+        if (out.tiles[i] == BlockType::Sign)
+        {
+            const int x = x0 + static_cast<int>(i % out.nx);
+            const int y = y0 + static_cast<int>(i / (static_cast<size_t>(out.nx) * out.nz));
+            const int z = z0 + static_cast<int>((i / out.nx) % out.nz);
+            const std::string &text = world.getSignText(x, y, z);
+            if (!text.empty())
+                out.signs.emplace_back(static_cast<int>(i), text);
+        }
+    }
+}
+
+// Moves every cell to newIndex(x, y, z) in a box of the new dimensions
+template <typename Remap> static void remapClipboard(Clipboard &clip, int nx, int ny, int nz, Remap newIndex)
+{
+    const int n = static_cast<int>(clip.tiles.size());
+    std::vector<int> to(n);
+    std::vector<BlockType> tiles(n);
+    for (int i = 0; i < n; ++i)
+    {
+        to[i] = newIndex(i % clip.nx, i / (clip.nx * clip.nz), (i / clip.nx) % clip.nz);
+        tiles[to[i]] = clip.tiles[i];
+    }
+    clip.tiles.swap(tiles);
+    for (auto &attrs : clip.attributes)
+        attrs.cell = to[attrs.cell];
+    for (auto &sign : clip.signs)
+        sign.first = to[sign.first];
+    clip.nx = nx;
+    clip.ny = ny;
+    clip.nz = nz;
+}
+
+void rotateClipboard(Clipboard &clip)
+{
+    // +X turns to +Z: (x, z) -> (nz - 1 - z, x)
+    const int nx = clip.nz, ny = clip.ny, nz = clip.nx;
+    const int oldNz = clip.nz;
+    remapClipboard(clip, nx, ny, nz, [&](int x, int y, int z) { return (oldNz - 1 - z) + nx * (x + nz * y); });
+}
+
+void mirrorClipboard(Clipboard &clip)
+{
+    const int nx = clip.nx, ny = clip.ny, nz = clip.nz;
+    remapClipboard(clip, nx, ny, nz, [&](int x, int y, int z) { return (nx - 1 - x) + nx * (z + nz * y); });
+}
+
+bool pasteClipboard(World &world, const Clipboard &clip, int x, int y, int z)
+{
+    if (clip.empty() || !world.inside(x, y, z) || !world.inside(x + clip.nx - 1, y + clip.ny - 1, z + clip.nz - 1))
+        return false;
+    const size_t n = clip.tiles.size();
+    std::vector<uint8_t> planes(n * DENSE_PLANE_COUNT);
+    World::defaultPlanes(clip.tiles.data(), static_cast<int>(n), planes.data());
+    for (const auto &attrs : clip.attributes)
+    {
+        for (int p = PlanePower; p < DENSE_PLANE_COUNT; ++p)
+            planes[p * n + attrs.cell] = attrs.planes[p - PlanePower];
+    }
+    world.importRegion(x, y, z, clip.nx, clip.ny, clip.nz, planes.data());
+    for (const auto &sign : clip.signs)
+    {
+        const int cell = sign.first;
+        world.setSignText(x + cell % clip.nx, y + cell / (clip.nx * clip.nz), z + (cell / clip.nx) % clip.nz,
+                          sign.second);
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "world.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A copied box of the world, kept compact: one type byte per cell, the attribute planes only for cells that differ
+// from a freshly placed block of their type (buttons with a value, clocks off 60 Hz, latched flip-flops...), and
+// the sign texts. Cells are in y, z, x order like World planes.
+struct Clipboard
+{
+    struct CellAttributes
+    {
+        int cell;
+        uint8_t planes[DENSE_PLANE_COUNT - 1]; // PlanePower onward
+    };
+
+    int nx = 0, ny = 0, nz = 0;
+    std::vector<BlockType> tiles;
+    std::vector<CellAttributes> attributes;
+    std::vector<std::pair<int, std::string>> signs;
+
+    bool empty() const { return tiles.empty(); }
+};
+
+// Copies the box between two corner cells (inclusive, any order, clamped to the world)
+void copyToClipboard(const World &world, int ax, int ay, int az, int bx, int by, int bz, Clipboard &out);
+// Quarter turn clockwise seen from above / flip along X. Only cells move: logic blocks keep their fixed port faces
+// (BLOCK_TRAITS), so a turned or mirrored circuit usually needs its gates rewired.
+void rotateClipboard(Clipboard &clip);
+void mirrorClipboard(Clipboard &clip);
+// Stamps the clipboard with its minimum corner at (x, y, z) as one World::importRegion: planes are copied a row at
+// a time and edits/redraws are noted once per chunk. The logic picks the new blocks up on its next pass. False
+// (nothing written) if the box does not fit inside the world.
+bool pasteClipboard(World &world, const Clipboard &clip, int x, int y, int z);
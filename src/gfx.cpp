@@ -0,0 +1,1048 @@
+#include "gfx.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <vector>
+
+GfxBackend gGfxBackend = GfxBackend::Legacy;
+
+namespace
+{
+const char *WORLD_VS = R"(#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aUv;
+layout(location = 2) in vec3 aColor;
+uniform mat4 uViewProj;
+out vec2 vUv;
+out vec3 vColor;
+void main()
+{
+    vUv = aUv;
+    vColor = aColor;
+    gl_Position = uViewProj * vec4(aPos, 1.0);
+}
+)";
+
+const char *WORLD_FS = R"(#version 330 core
+in vec2 vUv;
+in vec3 vColor;
+uniform sampler2D uTex;
+out vec4 fragColor;
+void main()
+{
+    fragColor = texture(uTex, vUv) * vec4(vColor, 1.0);
+    // transparent atlas texels (sign glyph cells) must not write depth
+    if (fragColor.a < 0.01)
+        discard;
+}
+)";
+
+const char *IMM_VS = R"(#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aUv;
+layout(location = 2) in vec4 aColor;
+uniform mat4 uViewProj;
+out vec2 vUv;
+out vec4 vColor;
+void main()
+{
+    vUv = aUv;
+    vColor = aColor;
+    gl_Position = uViewProj * vec4(aPos, 1.0);
+}
+)";
+
+const char *IMM_FS = R"(#version 330 core
+in vec2 vUv;
+in vec4 vColor;
+uniform sampler2D uTex;
+uniform int uUseTex;
+out vec4 fragColor;
+void main()
+{
+    vec4 c = vColor;
+    if (uUseTex != 0)
+        c *= texture(uTex, vUv);
+    fragColor = c;
+}
+)";
+
+const char *SKY_VS = R"(#version 330 core
+layout(location = 0) in vec3 aDir;
+layout(location = 1) in vec3 aPos;
+uniform mat4 uProj;
+uniform mat4 uView;
+uniform float uHalf;
+out vec3 vDir;
+void main()
+{
+    vDir = aDir;
+    // rotation only, so the box stays centered on the camera
+    gl_Position = uProj * mat4(mat3(uView)) * vec4(aPos * uHalf, 1.0);
+}
+)";
+
+const char *SKY_FS = R"(#version 330 core
+in vec3 vDir;
+uniform samplerCube uSky;
+out vec4 fragColor;
+void main()
+{
+    fragColor = texture(uSky, vDir);
+}
+)";
+
+Mat4 gProj = mat4Identity();
+Mat4 gView = mat4Identity();
+
+GLuint gWorldProgram = 0;
+GLint gWorldViewProjLoc = -1;
+GLuint gImmProgram = 0;
+GLint gImmViewProjLoc = -1;
+GLint gImmUseTexLoc = -1;
+GLuint gSkyProgram = 0;
+GLint gSkyProjLoc = -1;
+GLint gSkyViewLoc = -1;
+GLint gSkyHalfLoc = -1;
+
+GLuint gQuadEbo = 0;
+size_t gQuadEboQuads = 0;
+
+GLuint gImmVao = 0;
+GLuint gImmVbo = 0;
+GLuint gImmEbo = 0;
+GLuint gSkyVao = 0;
+GLuint gSkyVbo = 0;
+
+// shared chunk vertex arena
+GLuint gArenaVbo = 0;
+GLuint gArenaVao = 0;      // core only
+GLuint gArenaGlassEbo = 0; // core only, streamed sorted glass indices
+size_t gArenaCapacity = 0; // in vertices
+std::map<size_t, size_t> gArenaFree; // free blocks, first vertex -> count
+const size_t ARENA_MIN_VERTICES = 1 << 18;
+
+// immediate-mode emulation state (core only)
+std::vector<ImmVertex> gImmVerts;
+std::vector<GLuint> gImmIndices;
+GLenum gImmPrim = GL_TRIANGLES;
+std::vector<ImmVertex> gPrimVerts;
+GLenum gPrimMode = GL_QUADS;
+ImmVertex gCurrent{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+float gLineWidth = 1.0f;
+bool gTexEnabled = false;
+GLuint gBoundTex = 0;
+
+// retained UI recording (both backends), see gfxBeginRecording
+ImmMesh *gRecording = nullptr;
+bool gTexEnabledBeforeRecording = false;
+float gWhiteU = 0.0f;
+float gWhiteV = 0.0f;
+
+bool isCore()
+{
+    return gGfxBackend == GfxBackend::Core;
+}
+
+GLuint compileShader(GLenum type, const char *src)
+{
+    GLuint sh = glCreateShader(type);
+    glShaderSource(sh, 1, &src, nullptr);
+    glCompileShader(sh);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(sh, GL_COMPILE_STATUS, &ok);
+    if (!ok)
+    {
+        char log[1024];
+        glGetShaderInfoLog(sh, sizeof(log), nullptr, log);
+        std::cerr << "Shader compile error: " << log << "\n";
+        glDeleteShader(sh);
+        return 0;
+    }
+    return sh;
+}
+
+GLuint linkProgram(const char *vsSrc, const char *fsSrc)
+{
+    GLuint vs = compileShader(GL_VERTEX_SHADER, vsSrc);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, fsSrc);
+    if (!vs || !fs)
+    {
+        if (vs)
+            glDeleteShader(vs);
+        if (fs)
+            glDeleteShader(fs);
+        return 0;
+    }
+    GLuint prog = glCreateProgram();
+    glAttachShader(prog, vs);
+    glAttachShader(prog, fs);
+    glLinkProgram(prog);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    GLint ok = GL_FALSE;
+    glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok)
+    {
+        char log[1024];
+        glGetProgramInfoLog(prog, sizeof(log), nullptr, log);
+        std::cerr << "Shader link error: " << log << "\n";
+        glDeleteProgram(prog);
+        return 0;
+    }
+    return prog;
+}
+
+void ensureQuadIndices(size_t quads)
+{
+    if (quads <= gQuadEboQuads)
+        return;
+    size_t cap = std::max<size_t>(quads, std::max<size_t>(gQuadEboQuads * 2, 4096));
+    std::vector<GLuint> idx(cap * 6);
+    for (size_t q = 0; q < cap; ++q)
+    {
+        GLuint base = static_cast<GLuint>(q * 4);
+        idx[q * 6 + 0] = base;
+        idx[q * 6 + 1] = base + 1;
+        idx[q * 6 + 2] = base + 2;
+        idx[q * 6 + 3] = base;
+        idx[q * 6 + 4] = base + 2;
+        idx[q * 6 + 5] = base + 3;
+    }
+    // upload through COPY_WRITE so the element binding of whichever VAO is bound stays untouched
+    glBindBuffer(GL_COPY_WRITE_BUFFER, gQuadEbo);
+    glBufferData(GL_COPY_WRITE_BUFFER, idx.size() * sizeof(GLuint), idx.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    gQuadEboQuads = cap;
+}
+
+void pushTriangleIndex(std::vector<GLuint> &indices, GLuint a, GLuint b, GLuint c)
+{
+    indices.push_back(a);
+    indices.push_back(b);
+    indices.push_back(c);
+}
+
+void emitTriangles(std::vector<ImmVertex> &verts, std::vector<GLuint> &indices)
+{
+    const size_t n = gPrimVerts.size();
+    GLuint base = static_cast<GLuint>(verts.size());
+    verts.insert(verts.end(), gPrimVerts.begin(), gPrimVerts.end());
+    switch (gPrimMode)
+    {
+    case GL_QUADS:
+        for (size_t i = 0; i + 3 < n; i += 4)
+        {
+            GLuint q = base + static_cast<GLuint>(i);
+            pushTriangleIndex(indices, q, q + 1, q + 2);
+            pushTriangleIndex(indices, q, q + 2, q + 3);
+        }
+        break;
+    case GL_TRIANGLES:
+        for (size_t i = 0; i + 2 < n; i += 3)
+            pushTriangleIndex(indices, base + i, base + i + 1, base + i + 2);
+        break;
+    case GL_TRIANGLE_STRIP:
+        for (size_t i = 0; i + 2 < n; ++i)
+        {
+            if (i % 2 == 0)
+                pushTriangleIndex(indices, base + i, base + i + 1, base + i + 2);
+            else
+                pushTriangleIndex(indices, base + i + 1, base + i, base + i + 2);
+        }
+        break;
+    default: // GL_TRIANGLE_FAN, GL_POLYGON
+        for (size_t i = 1; i + 1 < n; ++i)
+            pushTriangleIndex(indices, base, base + i, base + i + 1);
+        break;
+    }
+}
+
+// thin: width-1 lines stay GL_LINES segments; otherwise every segment is extruded into a quad
+void emitLines(std::vector<ImmVertex> &verts, std::vector<GLuint> &indices, bool thin)
+{
+    std::vector<std::pair<size_t, size_t>> segs;
+    const size_t n = gPrimVerts.size();
+    if (gPrimMode == GL_LINES)
+    {
+        for (size_t i = 0; i + 1 < n; i += 2)
+            segs.emplace_back(i, i + 1);
+    }
+    else
+    {
+        for (size_t i = 0; i + 1 < n; ++i)
+            segs.emplace_back(i, i + 1);
+        if (gPrimMode == GL_LINE_LOOP && n > 2)
+            segs.emplace_back(n - 1, 0);
+    }
+
+    if (thin)
+    {
+        GLuint base = static_cast<GLuint>(verts.size());
+        verts.insert(verts.end(), gPrimVerts.begin(), gPrimVerts.end());
+        for (const auto &s : segs)
+        {
+            indices.push_back(base + static_cast<GLuint>(s.first));
+            indices.push_back(base + static_cast<GLuint>(s.second));
+        }
+        return;
+    }
+
+    // Wide lines are only used by the 2D HUD: extrude each segment into a quad in the XY plane
+    float halfW = gLineWidth * 0.5f;
+    for (const auto &s : segs)
+    {
+        const ImmVertex &a = gPrimVerts[s.first];
+        const ImmVertex &b = gPrimVerts[s.second];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float len = std::sqrt(dx * dx + dy * dy);
+        if (len < 1e-6f)
+            continue;
+        float nx = -dy / len * halfW;
+        float ny = dx / len * halfW;
+        GLuint base = static_cast<GLuint>(verts.size());
+        ImmVertex v0 = a, v1 = b, v2 = b, v3 = a;
+        v0.x += nx;
+        v0.y += ny;
+        v1.x += nx;
+        v1.y += ny;
+        v2.x -= nx;
+        v2.y -= ny;
+        v3.x -= nx;
+        v3.y -= ny;
+        verts.push_back(v0);
+        verts.push_back(v1);
+        verts.push_back(v2);
+        verts.push_back(v3);
+        pushTriangleIndex(indices, base, base + 1, base + 2);
+        pushTriangleIndex(indices, base, base + 2, base + 3);
+    }
+}
+
+bool isLineMode(GLenum mode)
+{
+    return mode == GL_LINES || mode == GL_LINE_LOOP || mode == GL_LINE_STRIP;
+}
+} // namespace
+
+Mat4 mat4Identity()
+{
+    Mat4 r{};
+    r.m[0] = r.m[5] = r.m[10] = r.m[15] = 1.0f;
+    return r;
+}
+
+Mat4 mat4Multiply(const Mat4 &a, const Mat4 &b)
+{
+    Mat4 r{};
+    for (int col = 0; col < 4; ++col)
+    {
+        for (int row = 0; row < 4; ++row)
+        {
+            float s = 0.0f;
+            for (int k = 0; k < 4; ++k)
+                s += a.m[k * 4 + row] * b.m[col * 4 + k];
+            r.m[col * 4 + row] = s;
+        }
+    }
+    return r;
+}
+
+Mat4 mat4Perspective(float fovyDeg, float aspect, float zNear, float zFar)
+{
+    // same matrix as gluPerspective
+    float f = 1.0f / std::tan(fovyDeg * 3.14159265f / 360.0f);
+    Mat4 r{};
+    r.m[0] = f / aspect;
+    r.m[5] = f;
+    r.m[10] = (zFar + zNear) / (zNear - zFar);
+    r.m[11] = -1.0f;
+    r.m[14] = 2.0f * zFar * zNear / (zNear - zFar);
+    return r;
+}
+
+Mat4 mat4Ortho(float left, float right, float bottom, float top, float zNear, float zFar)
+{
+    Mat4 r = mat4Identity();
+    r.m[0] = 2.0f / (right - left);
+    r.m[5] = 2.0f / (top - bottom);
+    r.m[10] = -2.0f / (zFar - zNear);
+    r.m[12] = -(right + left) / (right - left);
+    r.m[13] = -(top + bottom) / (top - bottom);
+    r.m[14] = -(zFar + zNear) / (zFar - zNear);
+    return r;
+}
+
+Mat4 mat4LookAt(float ex, float ey, float ez, float cx, float cy, float cz, float ux, float uy, float uz)
+{
+    // same matrix as gluLookAt
+    float fx = cx - ex, fy = cy - ey, fz = cz - ez;
+    float fl = std::sqrt(fx * fx + fy * fy + fz * fz);
+    fx /= fl;
+    fy /= fl;
+    fz /= fl;
+    float sx = fy * uz - fz * uy;
+    float sy = fz * ux - fx * uz;
+    float sz = fx * uy - fy * ux;
+    float sl = std::sqrt(sx * sx + sy * sy + sz * sz);
+    sx /= sl;
+    sy /= sl;
+    sz /= sl;
+    float vx = sy * fz - sz * fy;
+    float vy = sz * fx - sx * fz;
+    float vz = sx * fy - sy * fx;
+
+    Mat4 r = mat4Identity();
+    r.m[0] = sx;
+    r.m[4] = sy;
+    r.m[8] = sz;
+    r.m[1] = vx;
+    r.m[5] = vy;
+    r.m[9] = vz;
+    r.m[2] = -fx;
+    r.m[6] = -fy;
+    r.m[10] = -fz;
+    r.m[12] = -(sx * ex + sy * ey + sz * ez);
+    r.m[13] = -(vx * ex + vy * ey + vz * ez);
+    r.m[14] = fx * ex + fy * ey + fz * ez;
+    return r;
+}
+
+bool gfxInitCore()
+{
+    gWorldProgram = linkProgram(WORLD_VS, WORLD_FS);
+    gImmProgram = linkProgram(IMM_VS, IMM_FS);
+    gSkyProgram = linkProgram(SKY_VS, SKY_FS);
+    if (!gWorldProgram || !gImmProgram || !gSkyProgram)
+    {
+        gfxShutdown();
+        return false;
+    }
+    gWorldViewProjLoc = glGetUniformLocation(gWorldProgram, "uViewProj");
+    gImmViewProjLoc = glGetUniformLocation(gImmProgram, "uViewProj");
+    gImmUseTexLoc = glGetUniformLocation(gImmProgram, "uUseTex");
+    gSkyProjLoc = glGetUniformLocation(gSkyProgram, "uProj");
+    gSkyViewLoc = glGetUniformLocation(gSkyProgram, "uView");
+    gSkyHalfLoc = glGetUniformLocation(gSkyProgram, "uHalf");
+    glUseProgram(gWorldProgram);
+    glUniform1i(glGetUniformLocation(gWorldProgram, "uTex"), 0);
+    glUseProgram(gImmProgram);
+    glUniform1i(glGetUniformLocation(gImmProgram, "uTex"), 0);
+    glUseProgram(gSkyProgram);
+    glUniform1i(glGetUniformLocation(gSkyProgram, "uSky"), 0);
+    glUseProgram(0);
+
+    glGenBuffers(1, &gQuadEbo);
+    ensureQuadIndices(4096);
+
+    glGenVertexArrays(1, &gImmVao);
+    glGenBuffers(1, &gImmVbo);
+    glGenBuffers(1, &gImmEbo);
+    glBindVertexArray(gImmVao);
+    glBindBuffer(GL_ARRAY_BUFFER, gImmVbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ImmVertex), reinterpret_cast<void *>(0));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ImmVertex), reinterpret_cast<void *>(sizeof(float) * 3));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ImmVertex), reinterpret_cast<void *>(sizeof(float) * 5));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gImmEbo);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    gImmVerts.reserve(16384);
+    gImmIndices.reserve(24576);
+    gGfxBackend = GfxBackend::Core;
+    return true;
+}
+
+void gfxShutdown()
+{
+    if (gWorldProgram)
+        glDeleteProgram(gWorldProgram);
+    if (gImmProgram)
+        glDeleteProgram(gImmProgram);
+    if (gSkyProgram)
+        glDeleteProgram(gSkyProgram);
+    gWorldProgram = gImmProgram = gSkyProgram = 0;
+    GLuint bufs[] = {gQuadEbo, gImmVbo, gImmEbo, gSkyVbo, gArenaVbo, gArenaGlassEbo};
+    for (GLuint b : bufs)
+    {
+        if (b)
+            glDeleteBuffers(1, &b);
+    }
+    gQuadEbo = gImmVbo = gImmEbo = gSkyVbo = gArenaVbo = gArenaGlassEbo = 0;
+    gQuadEboQuads = 0;
+    gArenaCapacity = 0;
+    gArenaFree.clear();
+    GLuint vaos[] = {gImmVao, gSkyVao, gArenaVao};
+    for (GLuint v : vaos)
+    {
+        if (v)
+            glDeleteVertexArrays(1, &v);
+    }
+    gImmVao = gSkyVao = gArenaVao = 0;
+}
+
+void gfxSetProjection(const Mat4 &m)
+{
+    if (isCore())
+    {
+        gfxFlush();
+    }
+    else
+    {
+        glMatrixMode(GL_PROJECTION);
+        glLoadMatrixf(m.m);
+        glMatrixMode(GL_MODELVIEW);
+    }
+    gProj = m;
+}
+
+void gfxSetView(const Mat4 &m)
+{
+    if (isCore())
+    {
+        gfxFlush();
+    }
+    else
+    {
+        glMatrixMode(GL_MODELVIEW);
+        glLoadMatrixf(m.m);
+    }
+    gView = m;
+}
+
+const Mat4 &gfxProjection()
+{
+    return gProj;
+}
+
+const Mat4 &gfxView()
+{
+    return gView;
+}
+
+void gfxEnable(GLenum cap)
+{
+    if (gRecording)
+    {
+        // recorded geometry is drawn later under the caller's state; only texturing is per vertex
+        if (cap == GL_TEXTURE_2D)
+            gTexEnabled = true;
+        return;
+    }
+    if (!isCore())
+    {
+        glEnable(cap);
+        return;
+    }
+    gfxFlush();
+    if (cap == GL_TEXTURE_2D)
+        gTexEnabled = true;
+    else
+        glEnable(cap);
+}
+
+void gfxDisable(GLenum cap)
+{
+    if (gRecording)
+    {
+        if (cap == GL_TEXTURE_2D)
+            gTexEnabled = false;
+        return;
+    }
+    if (!isCore())
+    {
+        glDisable(cap);
+        return;
+    }
+    gfxFlush();
+    if (cap == GL_TEXTURE_2D)
+        gTexEnabled = false;
+    else
+        glDisable(cap);
+}
+
+void gfxDepthMask(bool write)
+{
+    if (isCore())
+        gfxFlush();
+    glDepthMask(write ? GL_TRUE : GL_FALSE);
+}
+
+void gfxBlendFunc(GLenum src, GLenum dst)
+{
+    if (isCore())
+        gfxFlush();
+    glBlendFunc(src, dst);
+}
+
+void gfxBindTexture(GLuint tex)
+{
+    if (gRecording)
+        return;
+    if (!isCore())
+    {
+        glBindTexture(GL_TEXTURE_2D, tex);
+        return;
+    }
+    if (tex != gBoundTex)
+        gfxFlush();
+    gBoundTex = tex;
+}
+
+void gfxBegin(GLenum mode)
+{
+    if (gRecording)
+    {
+        gPrimMode = mode;
+        gPrimVerts.clear();
+        return;
+    }
+    if (!isCore())
+    {
+        glBegin(mode);
+        return;
+    }
+    GLenum prim = (isLineMode(mode) && gLineWidth <= 1.0f) ? GL_LINES : GL_TRIANGLES;
+    if (prim != gImmPrim)
+    {
+        gfxFlush();
+        gImmPrim = prim;
+    }
+    gPrimMode = mode;
+    gPrimVerts.clear();
+}
+
+void gfxEnd()
+{
+    if (gRecording)
+    {
+        if (isLineMode(gPrimMode))
+            emitLines(gRecording->verts, gRecording->indices, false);
+        else
+            emitTriangles(gRecording->verts, gRecording->indices);
+        gPrimVerts.clear();
+        return;
+    }
+    if (!isCore())
+    {
+        glEnd();
+        return;
+    }
+    if (isLineMode(gPrimMode))
+        emitLines(gImmVerts, gImmIndices, gImmPrim == GL_LINES);
+    else
+        emitTriangles(gImmVerts, gImmIndices);
+    gPrimVerts.clear();
+}
+
+void gfxColor3f(float r, float g, float b)
+{
+    if (!isCore() && !gRecording)
+    {
+        glColor3f(r, g, b);
+        return;
+    }
+    gCurrent.r = r;
+    gCurrent.g = g;
+    gCurrent.b = b;
+    gCurrent.a = 1.0f;
+}
+
+void gfxColor4f(float r, float g, float b, float a)
+{
+    if (!isCore() && !gRecording)
+    {
+        glColor4f(r, g, b, a);
+        return;
+    }
+    gCurrent.r = r;
+    gCurrent.g = g;
+    gCurrent.b = b;
+    gCurrent.a = a;
+}
+
+void gfxTexCoord2f(float u, float v)
+{
+    if (!isCore() && !gRecording)
+    {
+        glTexCoord2f(u, v);
+        return;
+    }
+    gCurrent.u = u;
+    gCurrent.v = v;
+}
+
+void gfxVertex2f(float x, float y)
+{
+    gfxVertex3f(x, y, 0.0f);
+}
+
+void gfxVertex3f(float x, float y, float z)
+{
+    if (!isCore() && !gRecording)
+    {
+        glVertex3f(x, y, z);
+        return;
+    }
+    ImmVertex v = gCurrent;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    if (gRecording && !gTexEnabled)
+    {
+        v.u = gWhiteU;
+        v.v = gWhiteV;
+    }
+    gPrimVerts.push_back(v);
+}
+
+void gfxVertex3fv(const float *v)
+{
+    gfxVertex3f(v[0], v[1], v[2]);
+}
+
+void gfxLineWidth(float w)
+{
+    gLineWidth = w;
+    if (!isCore() && !gRecording)
+        glLineWidth(w);
+}
+
+static void drawImmBuffers(const std::vector<ImmVertex> &verts, const std::vector<GLuint> &indices, GLenum prim,
+                           GLuint tex)
+{
+    Mat4 viewProj = mat4Multiply(gProj, gView);
+    glUseProgram(gImmProgram);
+    glUniformMatrix4fv(gImmViewProjLoc, 1, GL_FALSE, viewProj.m);
+    glUniform1i(gImmUseTexLoc, tex != 0 ? 1 : 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, tex);
+
+    glBindVertexArray(gImmVao);
+    glBindBuffer(GL_ARRAY_BUFFER, gImmVbo);
+    // orphan then fill, so the driver never stalls on last flush's draw
+    glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(ImmVertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, verts.size() * sizeof(ImmVertex), verts.data());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(GLuint), indices.data());
+    glDrawElements(prim, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+}
+
+void gfxFlush()
+{
+    if (!isCore() || gImmIndices.empty())
+        return;
+    bool useTex = gTexEnabled && gBoundTex != 0;
+    drawImmBuffers(gImmVerts, gImmIndices, gImmPrim, useTex ? gBoundTex : 0);
+    gImmVerts.clear();
+    gImmIndices.clear();
+}
+
+void gfxSetUiWhiteTexel(float u, float v)
+{
+    gWhiteU = u;
+    gWhiteV = v;
+}
+
+void gfxBeginRecording(ImmMesh &out)
+{
+    if (!gRecording)
+        gTexEnabledBeforeRecording = gTexEnabled;
+    gRecording = &out;
+    gTexEnabled = false;
+}
+
+void gfxEndRecording()
+{
+    gRecording = nullptr;
+    gTexEnabled = gTexEnabledBeforeRecording;
+}
+
+void gfxDrawImmMesh(const ImmMesh &mesh, GLuint tex)
+{
+    if (mesh.indices.empty())
+        return;
+    if (!isCore())
+    {
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(3, GL_FLOAT, sizeof(ImmVertex), &mesh.verts[0].x);
+        glTexCoordPointer(2, GL_FLOAT, sizeof(ImmVertex), &mesh.verts[0].u);
+        glColorPointer(4, GL_FLOAT, sizeof(ImmVertex), &mesh.verts[0].r);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.indices.size()), GL_UNSIGNED_INT, mesh.indices.data());
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDisable(GL_TEXTURE_2D);
+        return;
+    }
+    gfxFlush();
+    drawImmBuffers(mesh.verts, mesh.indices, GL_TRIANGLES, tex);
+}
+
+static void setupArenaVao()
+{
+    if (gArenaVao == 0)
+        glGenVertexArrays(1, &gArenaVao);
+    glBindVertexArray(gArenaVao);
+    glBindBuffer(GL_ARRAY_BUFFER, gArenaVbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(0));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(sizeof(float) * 3));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(sizeof(float) * 5));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gQuadEbo);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+static void arenaAddFree(size_t first, size_t count)
+{
+    auto next = gArenaFree.lower_bound(first);
+    if (next != gArenaFree.end() && first + count == next->first)
+    {
+        count += next->second;
+        next = gArenaFree.erase(next);
+    }
+    if (next != gArenaFree.begin())
+    {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == first)
+        {
+            prev->second += count;
+            return;
+        }
+    }
+    gArenaFree.emplace(first, count);
+}
+
+static void arenaGrow(size_t minExtra)
+{
+    size_t newCap = std::max(std::max(gArenaCapacity * 2, gArenaCapacity + minExtra), ARENA_MIN_VERTICES);
+    GLuint newVbo = 0;
+    glGenBuffers(1, &newVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, newVbo);
+    glBufferData(GL_ARRAY_BUFFER, newCap * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+    if (gArenaVbo != 0)
+    {
+        GLsizeiptr bytes = static_cast<GLsizeiptr>(gArenaCapacity * sizeof(Vertex));
+        if (isCore())
+        {
+            glBindBuffer(GL_COPY_READ_BUFFER, gArenaVbo);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ARRAY_BUFFER, 0, 0, bytes);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+        else
+        {
+            // 2.1 has no buffer-to-buffer copy: go through system memory (growth is rare)
+            std::vector<Vertex> old(gArenaCapacity);
+            glBindBuffer(GL_ARRAY_BUFFER, gArenaVbo);
+            glGetBufferSubData(GL_ARRAY_BUFFER, 0, bytes, old.data());
+            glBindBuffer(GL_ARRAY_BUFFER, newVbo);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, old.data());
+        }
+        glDeleteBuffers(1, &gArenaVbo);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    arenaAddFree(gArenaCapacity, newCap - gArenaCapacity);
+    gArenaVbo = newVbo;
+    gArenaCapacity = newCap;
+    if (isCore())
+        setupArenaVao();
+}
+
+void gfxArenaRelease(ArenaRange &range)
+{
+    if (range.count > 0)
+        arenaAddFree(static_cast<size_t>(range.first), static_cast<size_t>(range.count));
+    range = ArenaRange{};
+}
+
+void gfxArenaStore(ArenaRange &range, const Vertex *verts, size_t count)
+{
+    gfxArenaRelease(range);
+    if (count == 0)
+        return;
+    auto fit = std::find_if(gArenaFree.begin(), gArenaFree.end(), [&](const std::pair<const size_t, size_t> &blk)
+                            { return blk.second >= count; });
+    if (fit == gArenaFree.end())
+    {
+        arenaGrow(count);
+        fit = std::find_if(gArenaFree.begin(), gArenaFree.end(), [&](const std::pair<const size_t, size_t> &blk)
+                           { return blk.second >= count; });
+    }
+    size_t first = fit->first;
+    size_t left = fit->second - count;
+    gArenaFree.erase(fit);
+    if (left > 0)
+        gArenaFree.emplace(first + count, left);
+
+    glBindBuffer(GL_ARRAY_BUFFER, gArenaVbo);
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(first * sizeof(Vertex)),
+                    static_cast<GLsizeiptr>(count * sizeof(Vertex)), verts);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (isCore())
+        ensureQuadIndices(count / 4);
+    range.first = static_cast<GLint>(first);
+    range.count = static_cast<GLsizei>(count);
+}
+
+void gfxBeginChunkPass(GLuint atlas)
+{
+    if (!isCore())
+    {
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, atlas);
+        glAlphaFunc(GL_GREATER, 0.01f);
+        glEnable(GL_ALPHA_TEST);
+        // every chunk shares the arena, so the pointers are set once per pass
+        glBindBuffer(GL_ARRAY_BUFFER, gArenaVbo);
+        glVertexPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void *>(0));
+        glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void *>(sizeof(float) * 3));
+        glColorPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void *>(sizeof(float) * 5));
+        return;
+    }
+    gfxFlush();
+    Mat4 viewProj = mat4Multiply(gProj, gView);
+    glUseProgram(gWorldProgram);
+    glUniformMatrix4fv(gWorldViewProjLoc, 1, GL_FALSE, viewProj.m);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glBindVertexArray(gArenaVao);
+}
+
+void gfxDrawChunkRanges(const std::vector<ArenaRange> &ranges)
+{
+    if (ranges.empty() || gArenaVbo == 0)
+        return;
+    if (!isCore())
+    {
+        static std::vector<GLint> firsts;
+        static std::vector<GLsizei> counts;
+        firsts.clear();
+        counts.clear();
+        for (const ArenaRange &r : ranges)
+        {
+            firsts.push_back(r.first);
+            counts.push_back(r.count);
+        }
+        glMultiDrawArrays(GL_QUADS, firsts.data(), counts.data(), static_cast<GLsizei>(ranges.size()));
+        return;
+    }
+    // every range indexes the shared quad EBO from 0; the base vertex moves it to the chunk's slice
+    static std::vector<GLsizei> counts;
+    static std::vector<const void *> offsets;
+    static std::vector<GLint> bases;
+    counts.clear();
+    offsets.assign(ranges.size(), nullptr);
+    bases.clear();
+    for (const ArenaRange &r : ranges)
+    {
+        counts.push_back(r.count / 4 * 6);
+        bases.push_back(r.first);
+    }
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(),
+                                  static_cast<GLsizei>(ranges.size()), bases.data());
+}
+
+void gfxDrawArenaTriangles(const std::vector<GLuint> &indices)
+{
+    if (indices.empty() || gArenaVbo == 0)
+        return;
+    if (!isCore())
+    {
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, indices.data());
+        return;
+    }
+    if (gArenaGlassEbo == 0)
+        glGenBuffers(1, &gArenaGlassEbo);
+    // temporarily swap the arena VAO's element buffer for the streamed one
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gArenaGlassEbo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(GLuint), indices.data());
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gQuadEbo);
+}
+
+void gfxEndChunkPass()
+{
+    if (!isCore())
+    {
+        glDisable(GL_ALPHA_TEST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDisable(GL_TEXTURE_2D);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        return;
+    }
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+}
+
+void gfxDrawSky(GLuint cubemap, float half, const float *verts, int vertexCount)
+{
+    if (!isCore() || cubemap == 0)
+        return;
+    gfxFlush();
+    if (gSkyVao == 0)
+    {
+        glGenVertexArrays(1, &gSkyVao);
+        glGenBuffers(1, &gSkyVbo);
+        glBindVertexArray(gSkyVao);
+        glBindBuffer(GL_ARRAY_BUFFER, gSkyVbo);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * 6 * sizeof(float), verts, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6, reinterpret_cast<void *>(0));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6, reinterpret_cast<void *>(sizeof(float) * 3));
+        ensureQuadIndices(static_cast<size_t>(vertexCount / 4));
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gQuadEbo);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    GLboolean depthEnabled = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean cullEnabled = glIsEnabled(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+
+    glUseProgram(gSkyProgram);
+    glUniformMatrix4fv(gSkyProjLoc, 1, GL_FALSE, gProj.m);
+    glUniformMatrix4fv(gSkyViewLoc, 1, GL_FALSE, gView.m);
+    glUniform1f(gSkyHalfLoc, half);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+    glBindVertexArray(gSkyVao);
+    glDrawElements(GL_TRIANGLES, vertexCount / 4 * 6, GL_UNSIGNED_INT, nullptr);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    glUseProgram(0);
+
+    if (cullEnabled)
+        glEnable(GL_CULL_FACE);
+    if (depthEnabled)
+        glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <cstddef>
+
+// Rendering backend. Core is an OpenGL 3.3 core-profile context (VAOs, shaders, indexed triangles);
+// Legacy is the original 2.1 fixed-function path, kept as a fallback for old drivers.
+enum class GfxBackend
+{
+    Legacy,
+    Core
+};
+
+extern GfxBackend gGfxBackend;
+
+struct ImmVertex
+{
+    float x, y, z;
+    float u, v;
+    float r, g, b, a;
+};
+
+// Tessellated immediate-mode geometry, always indexed triangles
+struct ImmMesh
+{
+    std::vector<ImmVertex> verts;
+    std::vector<GLuint> indices;
+};
+
+// Column-major 4x4 matrix, same memory layout as glLoadMatrixf
+struct Mat4
+{
+    float m[16];
+};
+
+Mat4 mat4Identity();
+Mat4 mat4Multiply(const Mat4 &a, const Mat4 &b);
+Mat4 mat4Perspective(float fovyDeg, float aspect, float zNear, float zFar);
+Mat4 mat4Ortho(float left, float right, float bottom, float top, float zNear, float zFar);
+Mat4 mat4LookAt(float ex, float ey, float ez, float cx, float cy, float cz, float ux, float uy, float uz);
+
+// Compiles the shader set and creates the shared buffers. Returns false if the context cannot run it,
+// in which case the caller falls back to a 2.1 context.
+bool gfxInitCore();
+void gfxShutdown();
+
+void gfxSetProjection(const Mat4 &m);
+void gfxSetView(const Mat4 &m);
+const Mat4 &gfxProjection();
+const Mat4 &gfxView();
+
+// Fixed-function style state. In core mode pending immediate geometry is flushed before a change.
+void gfxEnable(GLenum cap);
+void gfxDisable(GLenum cap);
+void gfxDepthMask(bool write);
+void gfxBlendFunc(GLenum src, GLenum dst);
+void gfxBindTexture(GLuint tex);
+
+// glBegin/glEnd replacement. Legacy forwards to GL; core accumulates everything into one streamed
+// buffer (quads become indexed triangles, wide lines become quads) and draws it on gfxFlush().
+void gfxBegin(GLenum mode);
+void gfxEnd();
+void gfxColor3f(float r, float g, float b);
+void gfxColor4f(float r, float g, float b, float a);
+void gfxTexCoord2f(float u, float v);
+void gfxVertex2f(float x, float y);
+void gfxVertex3f(float x, float y, float z);
+void gfxVertex3fv(const float *v);
+void gfxLineWidth(float w);
+void gfxFlush();
+
+// Retained UI: between gfxBeginRecording and gfxEndRecording the gfxBegin/gfxVertex/gfxEnd calls above are
+// tessellated into `out` instead of drawn (lines extruded, quads split), on either backend. Untextured
+// vertices sample the white texel set by gfxSetUiWhiteTexel, so a whole recording draws with one texture.
+// Calling gfxBeginRecording again while recording just switches the target.
+void gfxSetUiWhiteTexel(float u, float v);
+void gfxBeginRecording(ImmMesh &out);
+void gfxEndRecording();
+void gfxDrawImmMesh(const ImmMesh &mesh, GLuint tex);
+
+// Chunk geometry lives in one shared vertex arena: a large VBO sub-allocated per chunk (first-fit free list,
+// neighbouring free blocks merged on release). Stores replace `range` with a fresh slice; count 0 releases it.
+void gfxArenaStore(ArenaRange &range, const Vertex *verts, size_t count);
+void gfxArenaRelease(ArenaRange &range);
+
+// Chunk pass: quads (4 vertices each) drawn straight from the arena, GL_QUADS (legacy) or indexed
+// triangles (core). Each draw call submits every range at once.
+void gfxBeginChunkPass(GLuint atlas);
+void gfxDrawChunkRanges(const std::vector<ArenaRange> &ranges);
+// Triangles by absolute arena vertex index, in the given order (sorted glass)
+void gfxDrawArenaTriangles(const std::vector<GLuint> &indices);
+void gfxEndChunkPass();
+
+// Core-profile skybox. verts holds interleaved {tex xyz, pos xyz} for 6 quads on a unit cube.
+void gfxDrawSky(GLuint cubemap, float half, const float *verts, int vertexCount);
@@ -11,7 +11,6 @@
 #include <GL/glew.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
-#include <GL/glu.h>
 #include <algorithm>
 #include <array>
 #include <cctype>
@@ -26,10 +25,17 @@
 #include <map>
 #include <random>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "clipboard.hpp"
+#include "gfx.hpp"
+#include "probe.hpp"
 #include "render.hpp"
+#include "replay.hpp"
+#include "save.hpp"
 #include "types.hpp"
+#include "undo.hpp"
 #include "world.hpp"
 
 static std::filesystem::path gResourceRoot = std::filesystem::current_path();
@@ -167,119 +173,119 @@ void drawBlockFaces(const World &world, int x, int y, int z, float s, const std:
         return isTransparent(world.get(nx, ny, nz));
     };
 
-    glColor3f(color[0], color[1], color[2]);
-    glBegin(GL_QUADS);
+    gfxColor3f(color[0], color[1], color[2]);
+    gfxBegin(GL_QUADS);
     // back (-z)
     if (neighborTransparent(x, y, z - 1))
     {
-        glVertex3fv(vx[0]);
-        glVertex3fv(vx[1]);
-        glVertex3fv(vx[2]);
-        glVertex3fv(vx[3]);
+        gfxVertex3fv(vx[0]);
+        gfxVertex3fv(vx[1]);
+        gfxVertex3fv(vx[2]);
+        gfxVertex3fv(vx[3]);
     }
     // front (+z)
     if (neighborTransparent(x, y, z + 1))
     {
-        glVertex3fv(vx[4]);
-        glVertex3fv(vx[5]);
-        glVertex3fv(vx[6]);
-        glVertex3fv(vx[7]);
+        gfxVertex3fv(vx[4]);
+        gfxVertex3fv(vx[5]);
+        gfxVertex3fv(vx[6]);
+        gfxVertex3fv(vx[7]);
     }
     // left (-x)
     if (neighborTransparent(x - 1, y, z))
     {
-        glVertex3fv(vx[0]);
-        glVertex3fv(vx[4]);
-        glVertex3fv(vx[7]);
-        glVertex3fv(vx[3]);
+        gfxVertex3fv(vx[0]);
+        gfxVertex3fv(vx[4]);
+        gfxVertex3fv(vx[7]);
+        gfxVertex3fv(vx[3]);
     }
     // right (+x)
     if (neighborTransparent(x + 1, y, z))
     {
-        glVertex3fv(vx[1]);
-        glVertex3fv(vx[5]);
-        glVertex3fv(vx[6]);
-        glVertex3fv(vx[2]);
+        gfxVertex3fv(vx[1]);
+        gfxVertex3fv(vx[5]);
+        gfxVertex3fv(vx[6]);
+        gfxVertex3fv(vx[2]);
     }
     // bottom (-y)
     if (neighborTransparent(x, y - 1, z))
     {
-        glVertex3fv(vx[0]);
-        glVertex3fv(vx[1]);
-        glVertex3fv(vx[5]);
-        glVertex3fv(vx[4]);
+        gfxVertex3fv(vx[0]);
+        gfxVertex3fv(vx[1]);
+        gfxVertex3fv(vx[5]);
+        gfxVertex3fv(vx[4]);
     }
     // top (+y)
     if (neighborTransparent(x, y + 1, z))
     {
-        glVertex3fv(vx[3]);
-        glVertex3fv(vx[2]);
-        glVertex3fv(vx[6]);
-        glVertex3fv(vx[7]);
+        gfxVertex3fv(vx[3]);
+        gfxVertex3fv(vx[2]);
+        gfxVertex3fv(vx[6]);
+        gfxVertex3fv(vx[7]);
     }
-    glEnd();
+    gfxEnd();
 
-    glColor3f(0.05f, 0.05f, 0.05f);
-    glLineWidth(1.0f);
+    gfxColor3f(0.05f, 0.05f, 0.05f);
+    gfxLineWidth(1.0f);
     // back (-z)
     if (neighborTransparent(x, y, z - 1))
     {
-        glBegin(GL_LINE_LOOP);
-        glVertex3fv(vx[0]);
-        glVertex3fv(vx[1]);
-        glVertex3fv(vx[2]);
-        glVertex3fv(vx[3]);
-        glEnd();
+        gfxBegin(GL_LINE_LOOP);
+        gfxVertex3fv(vx[0]);
+        gfxVertex3fv(vx[1]);
+        gfxVertex3fv(vx[2]);
+        gfxVertex3fv(vx[3]);
+        gfxEnd();
     }
     // front (+z)
     if (neighborTransparent(x, y, z + 1))
     {
-        glBegin(GL_LINE_LOOP);
-        glVertex3fv(vx[4]);
-        glVertex3fv(vx[5]);
-        glVertex3fv(vx[6]);
-        glVertex3fv(vx[7]);
-        glEnd();
+        gfxBegin(GL_LINE_LOOP);
+        gfxVertex3fv(vx[4]);
+        gfxVertex3fv(vx[5]);
+        gfxVertex3fv(vx[6]);
+        gfxVertex3fv(vx[7]);
+        gfxEnd();
     }
     // left (-x)
     if (neighborTransparent(x - 1, y, z))
     {
-        glBegin(GL_LINE_LOOP);
-        glVertex3fv(vx[0]);
-        glVertex3fv(vx[4]);
-        glVertex3fv(vx[7]);
-        glVertex3fv(vx[3]);
-        glEnd();
+        gfxBegin(GL_LINE_LOOP);
+        gfxVertex3fv(vx[0]);
+        gfxVertex3fv(vx[4]);
+        gfxVertex3fv(vx[7]);
+        gfxVertex3fv(vx[3]);
+        gfxEnd();
     }
     // right (+x)
     if (neighborTransparent(x + 1, y, z))
     {
-        glBegin(GL_LINE_LOOP);
-        glVertex3fv(vx[1]);
-        glVertex3fv(vx[5]);
-        glVertex3fv(vx[6]);
-        glVertex3fv(vx[2]);
-        glEnd();
+        gfxBegin(GL_LINE_LOOP);
+        gfxVertex3fv(vx[1]);
+        gfxVertex3fv(vx[5]);
+        gfxVertex3fv(vx[6]);
+        gfxVertex3fv(vx[2]);
+        gfxEnd();
     }
     // bottom (-y)
     if (neighborTransparent(x, y - 1, z))
     {
-        glBegin(GL_LINE_LOOP);
-        glVertex3fv(vx[0]);
-        glVertex3fv(vx[1]);
-        glVertex3fv(vx[5]);
-        glVertex3fv(vx[4]);
-        glEnd();
+        gfxBegin(GL_LINE_LOOP);
+        gfxVertex3fv(vx[0]);
+        gfxVertex3fv(vx[1]);
+        gfxVertex3fv(vx[5]);
+        gfxVertex3fv(vx[4]);
+        gfxEnd();
     }
     // top (+y)
     if (neighborTransparent(x, y + 1, z))
     {
-        glBegin(GL_LINE_LOOP);
-        glVertex3fv(vx[3]);
-        glVertex3fv(vx[2]);
-        glVertex3fv(vx[6]);
-        glVertex3fv(vx[7]);
-        glEnd();
+        gfxBegin(GL_LINE_LOOP);
+        gfxVertex3fv(vx[3]);
+        gfxVertex3fv(vx[2]);
+        gfxVertex3fv(vx[6]);
+        gfxVertex3fv(vx[7]);
+        gfxEnd();
     }
 }
 
@@ -287,15 +293,15 @@ void drawOutlinedCube(float x, float y, float z, float s)
 {
     float hs = s * 0.5f;
     float vx[8][3] = {{x - hs, y - hs, z - hs}, {x + hs, y - hs, z - hs}, {x + hs, y + hs, z - hs}, {x - hs, y + hs, z - hs}, {x - hs, y - hs, z + hs}, {x + hs, y - hs, z + hs}, {x + hs, y + hs, z + hs}, {x - hs, y + hs, z + hs}};
-    glColor3f(1.0f, 0.9f, 0.2f);
-    glBegin(GL_LINES);
+    gfxColor3f(1.0f, 0.9f, 0.2f);
+    gfxBegin(GL_LINES);
     int edges[12][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
     for (auto &e : edges)
     {
-        glVertex3fv(vx[e[0]]);
-        glVertex3fv(vx[e[1]]);
+        gfxVertex3fv(vx[e[0]]);
+        gfxVertex3fv(vx[e[1]]);
     }
-    glEnd();
+    gfxEnd();
 }
 
 void drawBlockOutlineExact(int bx, int by, int bz)
@@ -306,47 +312,65 @@ void drawBlockOutlineExact(int bx, int by, int bz)
     float maxY = static_cast<float>(by + 1);
     float minZ = static_cast<float>(bz);
     float maxZ = static_cast<float>(bz + 1);
-    glColor3f(1.0f, 0.9f, 0.2f);
-    glBegin(GL_LINES);
+    gfxColor3f(1.0f, 0.9f, 0.2f);
+    gfxBegin(GL_LINES);
     // bottom square
-    glVertex3f(minX, minY, minZ);
-    glVertex3f(maxX, minY, minZ);
+    gfxVertex3f(minX, minY, minZ);
+    gfxVertex3f(maxX, minY, minZ);
 
-    glVertex3f(maxX, minY, minZ);
-    glVertex3f(maxX, minY, maxZ);
+    gfxVertex3f(maxX, minY, minZ);
+    gfxVertex3f(maxX, minY, maxZ);
 
-    glVertex3f(maxX, minY, maxZ);
-    glVertex3f(minX, minY, maxZ);
+    gfxVertex3f(maxX, minY, maxZ);
+    gfxVertex3f(minX, minY, maxZ);
 
-    glVertex3f(minX, minY, maxZ);
-    glVertex3f(minX, minY, minZ);
+    gfxVertex3f(minX, minY, maxZ);
+    gfxVertex3f(minX, minY, minZ);
 
     // top square
-    glVertex3f(minX, maxY, minZ);
-    glVertex3f(maxX, maxY, minZ);
+    gfxVertex3f(minX, maxY, minZ);
+    gfxVertex3f(maxX, maxY, minZ);
 
-    glVertex3f(maxX, maxY, minZ);
-    glVertex3f(maxX, maxY, maxZ);
+    gfxVertex3f(maxX, maxY, minZ);
+    gfxVertex3f(maxX, maxY, maxZ);
 
-    glVertex3f(maxX, maxY, maxZ);
-    glVertex3f(minX, maxY, maxZ);
+    gfxVertex3f(maxX, maxY, maxZ);
+    gfxVertex3f(minX, maxY, maxZ);
 
-    glVertex3f(minX, maxY, maxZ);
-    glVertex3f(minX, maxY, minZ);
+    gfxVertex3f(minX, maxY, maxZ);
+    gfxVertex3f(minX, maxY, minZ);
 
     // verticals
-    glVertex3f(minX, minY, minZ);
-    glVertex3f(minX, maxY, minZ);
+    gfxVertex3f(minX, minY, minZ);
+    gfxVertex3f(minX, maxY, minZ);
 
-    glVertex3f(maxX, minY, minZ);
-    glVertex3f(maxX, maxY, minZ);
+    gfxVertex3f(maxX, minY, minZ);
+    gfxVertex3f(maxX, maxY, minZ);
 
-    glVertex3f(maxX, minY, maxZ);
-    glVertex3f(maxX, maxY, maxZ);
+    gfxVertex3f(maxX, minY, maxZ);
+    gfxVertex3f(maxX, maxY, maxZ);
 
-    glVertex3f(minX, minY, maxZ);
-    glVertex3f(minX, maxY, maxZ);
-    glEnd();
+    gfxVertex3f(minX, minY, maxZ);
+    gfxVertex3f(minX, maxY, maxZ);
+    gfxEnd();
+}
+
+// Edges of the cell box [x0, x1) x [y0, y1) x [z0, z1), pushed out a little so they are not hidden by the faces
+void drawRegionOutline(int x0, int y0, int z0, int x1, int y1, int z1, float r, float g, float b)
+{
+    const float e = 0.01f;
+    float vx[8][3] = {{x0 - e, y0 - e, z0 - e}, {x1 + e, y0 - e, z0 - e}, {x1 + e, y1 + e, z0 - e},
+                      {x0 - e, y1 + e, z0 - e}, {x0 - e, y0 - e, z1 + e}, {x1 + e, y0 - e, z1 + e},
+                      {x1 + e, y1 + e, z1 + e}, {x0 - e, y1 + e, z1 + e}};
+    gfxColor3f(r, g, b);
+    gfxBegin(GL_LINES);
+    int edges[12][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+    for (auto &edge : edges)
+    {
+        gfxVertex3fv(vx[edge[0]]);
+        gfxVertex3fv(vx[edge[1]]);
+    }
+    gfxEnd();
 }
 
 void drawBlockHighlight(int bx, int by, int bz)
@@ -357,49 +381,49 @@ void drawBlockHighlight(int bx, int by, int bz)
     float maxY = static_cast<float>(by + 1);
     float minZ = static_cast<float>(bz);
     float maxZ = static_cast<float>(bz + 1);
-    glColor4f(0.3f, 0.3f, 0.3f, 0.35f);
-    glBegin(GL_QUADS);
+    gfxColor4f(0.3f, 0.3f, 0.3f, 0.35f);
+    gfxBegin(GL_QUADS);
     // back (-z)
-    glVertex3f(minX, minY, minZ);
-    glVertex3f(maxX, minY, minZ);
-    glVertex3f(maxX, maxY, minZ);
-    glVertex3f(minX, maxY, minZ);
+    gfxVertex3f(minX, minY, minZ);
+    gfxVertex3f(maxX, minY, minZ);
+    gfxVertex3f(maxX, maxY, minZ);
+    gfxVertex3f(minX, maxY, minZ);
     // front (+z)
-    glVertex3f(minX, minY, maxZ);
-    glVertex3f(maxX, minY, maxZ);
-    glVertex3f(maxX, maxY, maxZ);
-    glVertex3f(minX, maxY, maxZ);
+    gfxVertex3f(minX, minY, maxZ);
+    gfxVertex3f(maxX, minY, maxZ);
+    gfxVertex3f(maxX, maxY, maxZ);
+    gfxVertex3f(minX, maxY, maxZ);
     // left (-x)
-    glVertex3f(minX, minY, minZ);
-    glVertex3f(minX, minY, maxZ);
-    glVertex3f(minX, maxY, maxZ);
-    glVertex3f(minX, maxY, minZ);
+    gfxVertex3f(minX, minY, minZ);
+    gfxVertex3f(minX, minY, maxZ);
+    gfxVertex3f(minX, maxY, maxZ);
+    gfxVertex3f(minX, maxY, minZ);
     // right (+x)
-    glVertex3f(maxX, minY, minZ);
-    glVertex3f(maxX, minY, maxZ);
-    glVertex3f(maxX, maxY, maxZ);
-    glVertex3f(maxX, maxY, minZ);
+    gfxVertex3f(maxX, minY, minZ);
+    gfxVertex3f(maxX, minY, maxZ);
+    gfxVertex3f(maxX, maxY, maxZ);
+    gfxVertex3f(maxX, maxY, minZ);
     // bottom (-y)
-    glVertex3f(minX, minY, minZ);
-    glVertex3f(maxX, minY, minZ);
-    glVertex3f(maxX, minY, maxZ);
-    glVertex3f(minX, minY, maxZ);
+    gfxVertex3f(minX, minY, minZ);
+    gfxVertex3f(maxX, minY, minZ);
+    gfxVertex3f(maxX, minY, maxZ);
+    gfxVertex3f(minX, minY, maxZ);
     // top (+y)
-    glVertex3f(minX, maxY, minZ);
-    glVertex3f(maxX, maxY, minZ);
-    glVertex3f(maxX, maxY, maxZ);
-    glVertex3f(minX, maxY, maxZ);
-    glEnd();
+    gfxVertex3f(minX, maxY, minZ);
+    gfxVertex3f(maxX, maxY, minZ);
+    gfxVertex3f(maxX, maxY, maxZ);
+    gfxVertex3f(minX, maxY, maxZ);
+    gfxEnd();
 }
 
 void drawFaceHighlight(const HitInfo &hit)
 {
     if (!hit.hit)
         return;
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDepthMask(GL_FALSE);
-    glColor4f(0.35f, 0.35f, 0.35f, 0.34f);
+    gfxEnable(GL_BLEND);
+    gfxBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gfxDepthMask(false);
+    gfxColor4f(0.35f, 0.35f, 0.35f, 0.34f);
 
     Vec3 n{static_cast<float>(hit.nx), static_cast<float>(hit.ny), static_cast<float>(hit.nz)};
     Vec3 u{0.0f, 0.0f, 0.0f};
@@ -438,52 +462,104 @@ void drawFaceHighlight(const HitInfo &hit)
     Vec3 p3 = add(add(center, scale(uHalf, -1.0f)), scale(vHalf, -1.0f));
     Vec3 p4 = add(add(center, scale(uHalf, -1.0f)), vHalf);
 
-    glBegin(GL_QUADS);
-    glVertex3f(p1.x, p1.y, p1.z);
-    glVertex3f(p2.x, p2.y, p2.z);
-    glVertex3f(p3.x, p3.y, p3.z);
-    glVertex3f(p4.x, p4.y, p4.z);
-    glEnd();
-    glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
+    gfxBegin(GL_QUADS);
+    gfxVertex3f(p1.x, p1.y, p1.z);
+    gfxVertex3f(p2.x, p2.y, p2.z);
+    gfxVertex3f(p3.x, p3.y, p3.z);
+    gfxVertex3f(p4.x, p4.y, p4.z);
+    gfxEnd();
+    gfxDepthMask(true);
+    gfxDisable(GL_BLEND);
+}
+
+// HUD helpers for 2D overlay. Everything drawn between beginHud and endHud is recorded into one mesh
+// (textured from the block atlas) and drawn with a single call in endHud.
+static Mat4 gHudSavedProj = mat4Identity();
+static Mat4 gHudSavedView = mat4Identity();
+static ImmMesh gHudFrame;
+
+// Retained widget: its recorded geometry is replayed until its content key changes
+struct HudWidget
+{
+    std::string key;
+    ImmMesh mesh;
+    bool valid = false;
+};
+static std::unordered_map<std::string, HudWidget> gHudWidgets;
+static HudWidget *gHudActiveWidget = nullptr;
+
+static void appendImmMesh(ImmMesh &dst, const ImmMesh &src)
+{
+    GLuint base = static_cast<GLuint>(dst.verts.size());
+    dst.verts.insert(dst.verts.end(), src.verts.begin(), src.verts.end());
+    dst.indices.reserve(dst.indices.size() + src.indices.size());
+    for (GLuint i : src.indices)
+        dst.indices.push_back(base + i);
+}
+
+// Returns true if the caller has to draw the widget (first use or key changed); otherwise the cached
+// geometry is reused and the caller skips drawing. Always pair with hudEndWidget().
+bool hudBeginWidget(const std::string &id, const std::string &key)
+{
+    HudWidget &w = gHudWidgets[id];
+    gHudActiveWidget = &w;
+    if (w.valid && w.key == key)
+        return false;
+    w.key = key;
+    w.mesh.verts.clear();
+    w.mesh.indices.clear();
+    gfxBeginRecording(w.mesh);
+    return true;
+}
+
+void hudEndWidget()
+{
+    if (!gHudActiveWidget)
+        return;
+    gHudActiveWidget->valid = true;
+    appendImmMesh(gHudFrame, gHudActiveWidget->mesh);
+    gHudActiveWidget = nullptr;
+    gfxBeginRecording(gHudFrame);
 }
 
-// HUD helpers for 2D overlay
 void beginHud(int w, int h)
 {
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    glOrtho(0, w, h, 0, -1, 1);
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gHudSavedProj = gfxProjection();
+    gHudSavedView = gfxView();
+    gfxSetProjection(mat4Ortho(0.0f, static_cast<float>(w), static_cast<float>(h), 0.0f, -1.0f, 1.0f));
+    gfxSetView(mat4Identity());
+    gfxDisable(GL_DEPTH_TEST);
+    gfxDisable(GL_CULL_FACE);
+    gfxDisable(GL_TEXTURE_2D);
+    gfxEnable(GL_BLEND);
+    gfxBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    float whiteU = 0.0f;
+    float whiteV = 0.0f;
+    atlasWhiteTexel(whiteU, whiteV);
+    gfxSetUiWhiteTexel(whiteU, whiteV);
+    gHudFrame.verts.clear();
+    gHudFrame.indices.clear();
+    gfxBeginRecording(gHudFrame);
 }
 
 void endHud()
 {
-    glEnable(GL_DEPTH_TEST);
-    glMatrixMode(GL_MODELVIEW);
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
+    gfxEndRecording();
+    gfxDrawImmMesh(gHudFrame, gAtlasTex);
+    gfxEnable(GL_DEPTH_TEST);
+    gfxSetProjection(gHudSavedProj);
+    gfxSetView(gHudSavedView);
 }
 
 void drawQuad(float x, float y, float w, float h, float r, float g, float b, float a)
 {
-    glColor4f(r, g, b, a);
-    glBegin(GL_QUADS);
-    glVertex2f(x, y);
-    glVertex2f(x + w, y);
-    glVertex2f(x + w, y + h);
-    glVertex2f(x, y + h);
-    glEnd();
+    gfxColor4f(r, g, b, a);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(x, y);
+    gfxVertex2f(x + w, y);
+    gfxVertex2f(x + w, y + h);
+    gfxVertex2f(x, y + h);
+    gfxEnd();
 }
 
 void drawOutline(float x, float y, float w, float h, float r, float g, float b, float a, float thickness = 2.0f)
@@ -544,6 +620,7 @@ void drawNumber(float x, float y, int value, float size, float r, float g, float
     }
 }
 
+// Emits the segments as quads into the current gfxBegin(GL_QUADS) batch
 void drawDigitBillboard(const Vec3 &pos, float size, int digit, const Vec3 &right, const Vec3 &up, float r, float g,
                         float b, float a)
 {
@@ -563,13 +640,11 @@ void drawDigitBillboard(const Vec3 &pos, float size, int digit, const Vec3 &righ
         Vec3 p3{p0.x + oh * up.x, p0.y + oh * up.y, p0.z + oh * up.z};
         Vec3 p2{p1.x + oh * up.x, p1.y + oh * up.y, p1.z + oh * up.z};
 
-        glBegin(GL_QUADS);
-        glColor4f(r, g, b, a);
-        glVertex3f(p0.x, p0.y, p0.z);
-        glVertex3f(p1.x, p1.y, p1.z);
-        glVertex3f(p2.x, p2.y, p2.z);
-        glVertex3f(p3.x, p3.y, p3.z);
-        glEnd();
+        gfxColor4f(r, g, b, a);
+        gfxVertex3f(p0.x, p0.y, p0.z);
+        gfxVertex3f(p1.x, p1.y, p1.z);
+        gfxVertex3f(p2.x, p2.y, p2.z);
+        gfxVertex3f(p3.x, p3.y, p3.z);
     };
 
     if (segMap[digit][0])
@@ -691,9 +766,7 @@ void drawInventoryBar(int winW, int winH, const std::vector<ItemStack> &hotbar,
         float x = barX + padding + gap * (i + 1) + slotSize * i;
         float y = barY + padding;
         BlockType b = hotbar[i].type;
-        if (!BLOCKS.count(b))
-            b = BlockType::Air;
-        auto col = BLOCKS.at(b).color;
+        auto col = blockTraits(b).color;
 
         // slot shell (metal frame + glass insert)
         drawQuad(x - 3.0f, y - 3.0f, slotSize + 6.0f, slotSize + 6.0f, 0.0f, 0.0f, 0.0f, 0.3f);
@@ -720,6 +793,157 @@ void drawInventoryBar(int winW, int winH, const std::vector<ItemStack> &hotbar,
     }
 }
 
+// F3 overlay: chunk culling counters from the last frame
+void drawDebugOverlay(float y)
+{
+    char lines[5][48];
+    std::snprintf(lines[0], sizeof(lines[0]), "DRAWN: %d GLASS: %d", gChunkStats.drawn, gChunkStats.glassDrawn);
+    std::snprintf(lines[1], sizeof(lines[1]), "CULLED: %d FRUSTUM %d DIST", gChunkStats.frustumCulled,
+                  gChunkStats.distanceCulled);
+    std::snprintf(lines[2], sizeof(lines[2]), "OCCLUDED: %d LOD: %d", gChunkStats.occlusionCulled,
+                  gChunkStats.lodDrawn);
+    std::snprintf(lines[3], sizeof(lines[3]), "VERTS: %zu", gChunkStats.vertices);
+    std::snprintf(lines[4], sizeof(lines[4]), "REMESH: %d QUEUED: %d", gChunkStats.remeshed,
+                  gChunkStats.remeshQueued);
+    const int lineCount = 5;
+    const float lineH = 16.0f;
+    std::string key = std::to_string(y);
+    for (const auto &ln : lines)
+        key += std::string("|") + ln;
+    if (hudBeginWidget("debug", key))
+    {
+        drawQuad(10.0f, y, 300.0f, 12.0f + lineH * lineCount, 0.04f, 0.04f, 0.06f, 0.65f);
+        drawOutline(10.0f, y, 300.0f, 12.0f + lineH * lineCount, 1.0f, 1.0f, 1.0f, 0.12f, 2.0f);
+        for (int i = 0; i < lineCount; ++i)
+            drawTextTiny(16.0f, y + 6.0f + lineH * i, 2.0f, lines[i], 0.85f, 1.0f, 0.85f, 1.0f);
+    }
+    hudEndWidget();
+}
+
+// Simulation counters of the last tick (F6)
+void drawSimStatsPanel(float x, float y)
+{
+    std::vector<std::string> lines;
+    char buf[64];
+    if (!SIM_STATS_BUILT)
+        lines.push_back("STATS SIM NON COMPILEES");
+    else
+    {
+        const SimStats &s = gSimStats;
+        double tickMs = 0.0;
+        for (double ms : s.phaseMs)
+            tickMs += ms;
+        if (s.skipped)
+            std::snprintf(buf, sizeof(buf), "TICK: SAUTE (STABLE)");
+        else
+            std::snprintf(buf, sizeof(buf), "TICK: %.2f MS  FRONTS %u", tickMs, s.clockEdges);
+        lines.push_back(buf);
+        std::snprintf(buf, sizeof(buf), "SCAN %.2f OUT %.2f WIRE %.2f", s.phaseMs[SimGateScan],
+                      s.phaseMs[SimOutputWrites], s.phaseMs[SimWirePropagation]);
+        lines.push_back(buf);
+        std::snprintf(buf, sizeof(buf), "LED %.2f DFF %.2f DIRTY %.2f", s.phaseMs[SimLedPass], s.phaseMs[SimDffCommit],
+                      s.phaseMs[SimDirtyScan]);
+        lines.push_back(buf);
+        std::snprintf(buf, sizeof(buf), "PUSH %u POP %u PEAK %u", s.wirePushes, s.wirePops, s.peakQueue);
+        lines.push_back(buf);
+        std::snprintf(buf, sizeof(buf), "CHANGED %u CHUNKS %u", s.changedVoxels, s.dirtyChunks);
+        lines.push_back(buf);
+        std::string row;
+        for (int t = 0; t < BLOCK_TYPE_COUNT; ++t)
+        {
+            if (s.evaluated[t] == 0)
+                continue;
+            std::snprintf(buf, sizeof(buf), "%s %u", blockTraits(static_cast<BlockType>(t)).name, s.evaluated[t]);
+            if (!row.empty() && row.size() + std::strlen(buf) > 30)
+            {
+                lines.push_back(row);
+                row.clear();
+            }
+            row += (row.empty() ? "" : "  ") + std::string(buf);
+        }
+        if (!row.empty())
+            lines.push_back(row);
+    }
+    const float lineH = 16.0f;
+    std::string key = std::to_string(x) + "," + std::to_string(y);
+    for (const auto &ln : lines)
+        key += "|" + ln;
+    if (hudBeginWidget("simstats", key))
+    {
+        const float h = 12.0f + lineH * lines.size();
+        drawQuad(x, y, 300.0f, h, 0.04f, 0.04f, 0.06f, 0.65f);
+        drawOutline(x, y, 300.0f, h, 1.0f, 1.0f, 1.0f, 0.12f, 2.0f);
+        for (size_t i = 0; i < lines.size(); ++i)
+            drawTextTiny(x + 6.0f, y + 6.0f + lineH * i, 2.0f, lines[i], 1.0f, 0.9f, 0.75f, 1.0f);
+    }
+    hudEndWidget();
+}
+
+// Waveform panel (F4): the last WAVEFORM_TICKS ticks of every probe, one row each, newest tick on the right
+constexpr uint64_t WAVEFORM_TICKS = 240;
+
+void drawWaveformPanel(int winW, int winH, const std::vector<ProbeTrace> &traces)
+{
+    const uint64_t now = probeTick();
+    const float rowH = 26.0f;
+    const float labelW = 130.0f;
+    const float panelW = std::min(660.0f, winW * 0.6f);
+    const int rows = std::min(static_cast<int>(traces.size()), std::max(1, static_cast<int>((winH - 140) / rowH)));
+    const float panelH = 34.0f + rowH * std::max(rows, 1);
+    const float x = winW - panelW - 10.0f;
+    const float y = 10.0f;
+    std::string key = std::to_string(winW) + "x" + std::to_string(winH) + ":" + std::to_string(now) + ":" +
+                      std::to_string(traces.size());
+    if (!hudBeginWidget("waveform", key))
+    {
+        hudEndWidget();
+        return;
+    }
+    drawQuad(x, y, panelW, panelH, 0.04f, 0.04f, 0.06f, 0.75f);
+    drawOutline(x, y, panelW, panelH, 1.0f, 1.0f, 1.0f, 0.12f, 2.0f);
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "SONDES: %d  TICK %llu", probeCount(), static_cast<unsigned long long>(now));
+    drawTextTiny(x + 8.0f, y + 8.0f, 2.0f, buf, 1.0f, 0.95f, 0.9f, 1.0f);
+    if (traces.empty())
+        drawTextTiny(x + 8.0f, y + 34.0f, 1.6f, "P: sonde sur le bloc vise", 0.85f, 0.85f, 0.85f, 1.0f);
+
+    const float traceX = x + labelW;
+    const float traceW = panelW - labelW - 10.0f;
+    const float scale = traceW / static_cast<float>(WAVEFORM_TICKS);
+    const uint64_t from = now > WAVEFORM_TICKS ? now - WAVEFORM_TICKS : 0;
+    auto tickX = [&](uint64_t t) { return traceX + traceW - static_cast<float>(now - std::max(t, from)) * scale; };
+    for (int r = 0; r < rows; ++r)
+    {
+        const ProbeTrace &t = traces[r];
+        const float rowY = y + 30.0f + rowH * r;
+        std::snprintf(buf, sizeof(buf), "%d,%d,%d", t.x, t.y, t.z);
+        drawTextTiny(x + 8.0f, rowY + 7.0f, 1.5f, buf, 0.85f, 0.85f, 0.85f, 1.0f);
+        for (size_t k = 0; k < t.changes.size(); ++k)
+        {
+            const float x0 = tickX(t.changes[k].first);
+            const float x1 = k + 1 < t.changes.size() ? tickX(t.changes[k + 1].first) : traceX + traceW;
+            const uint8_t value = t.changes[k].second;
+            if (t.width <= 1)
+            {
+                const float level = (value & 1) ? rowY + 3.0f : rowY + rowH - 7.0f;
+                drawQuad(x0, level, std::max(x1 - x0, 1.0f), 2.0f, 0.4f, 1.0f, 0.45f, 1.0f);
+                if (k > 0)
+                    drawQuad(x0, rowY + 3.0f, 2.0f, rowH - 8.0f, 0.4f, 1.0f, 0.45f, 1.0f);
+            }
+            else
+            {
+                drawQuad(x0 + 1.0f, rowY + 3.0f, std::max(x1 - x0 - 2.0f, 1.0f), rowH - 8.0f, 0.3f, 0.6f, 1.0f, 0.35f);
+                if (x1 - x0 > 24.0f)
+                {
+                    std::snprintf(buf, sizeof(buf), "%X", static_cast<unsigned>(value));
+                    drawTextTiny(x0 + 4.0f, rowY + 7.0f, 1.5f, buf, 1.0f, 1.0f, 1.0f, 1.0f);
+                }
+            }
+        }
+    }
+    hudEndWidget();
+}
+
 void drawCrosshair(int winW, int winH)
 {
     float cx = winW * 0.5f;
@@ -916,6 +1140,19 @@ void drawSaveMenu(int winW, int winH, const SaveMenuLayout &s, int highlightedIn
                    hoverLoad ? 1.0f : 0.9f);
     centerTinyText(s.backX, s.backY + s.backH * 0.33f, s.backW, labelSize, "RETURN", 1.0f, 1.0f, 1.0f,
                    hoverBack ? 1.0f : 0.9f);
+
+    bool saving = asyncSaveRunning();
+    if (saving || streamingLoadActive())
+    {
+        float barY = s.createY + s.createH + 12.0f;
+        float barH = 16.0f;
+        float progress = std::clamp(saving ? asyncSaveProgress() : streamingLoadProgress(), 0.0f, 1.0f);
+        drawQuad(s.inputX, barY, s.inputW, barH, 0.12f, 0.12f, 0.15f, 0.9f);
+        drawQuad(s.inputX, barY, s.inputW * progress, barH, 0.18f, 0.55f, 0.25f, 0.9f);
+        drawOutline(s.inputX, barY, s.inputW, barH, 1.0f, 1.0f, 1.0f, 0.2f, 2.0f);
+        std::string label = (saving ? "SAUVEGARDE " : "CHARGEMENT ") + std::to_string(static_cast<int>(progress * 100.0f)) + "%";
+        centerTinyText(s.inputX, barY + 4.0f, s.inputW, 1.4f, label, 1.0f, 1.0f, 1.0f, 0.95f);
+    }
 }
 
 bool pointInRect(float mx, float my, float x, float y, float w, float h)
@@ -926,21 +1163,24 @@ bool pointInRect(float mx, float my, float x, float y, float w, float h)
 void drawCharTiny(float x, float y, float size, char c, float r, float g, float b, float a)
 {
     c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
-    auto it = FONT5x4.find(c);
-    if (it == FONT5x4.end())
+    float u0, v0, u1, v1;
+    if (!atlasGlyphRect(c, u0, v0, u1, v1))
         return;
-    glColor4f(r, g, b, a);
-    const auto &rows = it->second;
-    for (int row = 0; row < 5; ++row)
-    {
-        for (int col = 0; col < 4; ++col)
-        {
-            if (rows[row] & (1 << (3 - col)))
-            {
-                drawQuad(x + col * size, y + row * size, size, size, r, g, b, a);
-            }
-        }
-    }
+    // one quad per character, sampling the font cells of the block atlas
+    gfxBindTexture(gAtlasTex);
+    gfxEnable(GL_TEXTURE_2D);
+    gfxColor4f(r, g, b, a);
+    gfxBegin(GL_QUADS);
+    gfxTexCoord2f(u0, v0);
+    gfxVertex2f(x, y);
+    gfxTexCoord2f(u1, v0);
+    gfxVertex2f(x + 4 * size, y);
+    gfxTexCoord2f(u1, v1);
+    gfxVertex2f(x + 4 * size, y + 5 * size);
+    gfxTexCoord2f(u0, v1);
+    gfxVertex2f(x, y + 5 * size);
+    gfxEnd();
+    gfxDisable(GL_TEXTURE_2D);
 }
 
 void drawTextTiny(float x, float y, float size, const std::string &text, float r, float g, float b, float a)
@@ -997,6 +1237,11 @@ struct Config
     bool fullscreenDefault = false;
     bool showFps = false;
     bool vsync = true;
+    bool coreProfile = true; // OpenGL 3.3 core renderer; false forces the 2.1 fallback
+    float remeshBudgetMs = 4.0f; // chunk rebuild time per frame
+    bool mappedSaves = false;    // saves are memory-mapped map files the world lives in (see save.hpp)
+    float autosaveSeconds = 30.0f; // autosave journal flush interval, 0 turns autosave off
+    float undoMemoryMb = 32.0f;    // undo/redo history cap
 };
 
 struct MainMenuLayout
@@ -1290,230 +1535,67 @@ void loadConfig(Config &cfg)
         {
             cfg.vsync = (val == "1" || val == "true" || val == "yes");
         }
-    }
-}
-
-void saveConfig(const Config &cfg)
-{
-    std::ofstream out(CONFIG_FILE);
-    if (!out)
-        return;
-    out << "mouse_sensitivity=" << cfg.mouseSensitivity << "\n";
-    out << "fullscreen=" << (cfg.fullscreenDefault ? 1 : 0) << "\n";
-    out << "show_fps=" << (cfg.showFps ? 1 : 0) << "\n";
-    out << "vsync=" << (cfg.vsync ? 1 : 0) << "\n";
-}
-
-// ---------- Save / Load ----------
-struct SaveHeader
-{
-    char magic[8] = {'B', 'U', 'L', 'L', 'D', 'O', 'G', '\0'};
-    uint32_t version = 10;
-    uint32_t w = 0, h = 0, d = 0;
-    uint32_t seed = 0;
-};
-
-bool saveWorldToFile(const World &world, const std::string &path, uint32_t seed)
-{
-    std::filesystem::create_directories(std::filesystem::path(path).parent_path());
-    std::ofstream out(path, std::ios::binary);
-    if (!out)
-        return false;
-    SaveHeader hdr;
-    hdr.w = static_cast<uint32_t>(world.getWidth());
-    hdr.h = static_cast<uint32_t>(world.getHeight());
-    hdr.d = static_cast<uint32_t>(world.getDepth());
-    hdr.seed = seed;
-    out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
-    int total = world.totalSize();
-    for (int i = 0; i < total; ++i)
-    {
-        int x = i % world.getWidth();
-        int y = (i / world.getWidth()) / world.getDepth();
-        int z = (i / world.getWidth()) % world.getDepth();
-        uint8_t b = static_cast<uint8_t>(world.get(x, y, z));
-        uint8_t p = world.getPower(x, y, z);
-        uint8_t btn = world.getButtonState(x, y, z);
-        uint8_t btnVal = world.getButtonValue(x, y, z);
-        uint8_t btnWidth = world.getButtonWidth(x, y, z);
-        uint8_t splitWidth = world.getSplitterWidth(x, y, z);
-        uint8_t splitOrder = world.getSplitterOrder(x, y, z);
-        uint8_t clkFreq = world.getClockFreq(x, y, z);
-        out.write(reinterpret_cast<const char *>(&b), 1);
-        out.write(reinterpret_cast<const char *>(&p), 1);
-        out.write(reinterpret_cast<const char *>(&btn), 1);
-        out.write(reinterpret_cast<const char *>(&btnVal), 1);
-        out.write(reinterpret_cast<const char *>(&btnWidth), 1);
-        out.write(reinterpret_cast<const char *>(&splitWidth), 1);
-        out.write(reinterpret_cast<const char *>(&splitOrder), 1);
-        out.write(reinterpret_cast<const char *>(&clkFreq), 1);
-    }
-
-    // Save sign texts (only for version >= 2)
-    std::vector<std::pair<uint32_t, std::string>> signs;
-    signs.reserve(128);
-    for (int i = 0; i < total; ++i)
-    {
-        int x = i % world.getWidth();
-        int y = (i / world.getWidth()) / world.getDepth();
-        int z = (i / world.getWidth()) % world.getDepth();
-        if (world.get(x, y, z) != BlockType::Sign)
-            continue;
-        const std::string &txt = world.getSignText(x, y, z);
-        if (txt.empty())
-            continue;
-        signs.emplace_back(static_cast<uint32_t>(i), txt);
-    }
-    uint32_t signCount = static_cast<uint32_t>(signs.size());
-    out.write(reinterpret_cast<const char *>(&signCount), sizeof(signCount));
-    for (const auto &s : signs)
-    {
-        uint32_t idx = s.first;
-        const std::string &txt = s.second;
-        uint16_t len = static_cast<uint16_t>(std::min<size_t>(txt.size(), 65535));
-        out.write(reinterpret_cast<const char *>(&idx), sizeof(idx));
-        out.write(reinterpret_cast<const char *>(&len), sizeof(len));
-        if (len > 0)
-            out.write(txt.data(), len);
-    }
-    return static_cast<bool>(out);
-}
-
-bool loadWorldFromFile(World &world, const std::string &path, uint32_t &seedOut)
-{
-    std::ifstream in(path, std::ios::binary);
-    if (!in)
-        return false;
-    SaveHeader hdr{};
-    in.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
-    if (!in || std::string(hdr.magic, hdr.magic + 7) != "BULLDOG")
-        return false;
-    if (hdr.version != 1 && hdr.version != 2 && hdr.version != 3 && hdr.version != 4 && hdr.version != 5 &&
-        hdr.version != 6 && hdr.version != 7 && hdr.version != 8 && hdr.version != 9 && hdr.version != 10)
-        return false;
-    if (hdr.w != static_cast<uint32_t>(world.getWidth()) || hdr.h != static_cast<uint32_t>(world.getHeight()) ||
-        hdr.d != static_cast<uint32_t>(world.getDepth()))
-        return false;
-
-    int total = world.totalSize();
-    for (int i = 0; i < total; ++i)
-    {
-        uint8_t b = 0, p = 0, btn = 0, btnVal = 255;
-        uint8_t btnWidth = 0;
-        uint8_t splitWidth = 1;
-        uint8_t splitOrder = 0;
-        uint8_t clkFreq = 60;
-        in.read(reinterpret_cast<char *>(&b), 1);
-        in.read(reinterpret_cast<char *>(&p), 1);
-        in.read(reinterpret_cast<char *>(&btn), 1);
-        if (hdr.version >= 6)
-            in.read(reinterpret_cast<char *>(&btnVal), 1);
-        if (hdr.version >= 7)
-            in.read(reinterpret_cast<char *>(&btnWidth), 1);
-        if (hdr.version >= 9)
-        {
-            in.read(reinterpret_cast<char *>(&splitWidth), 1);
-            in.read(reinterpret_cast<char *>(&splitOrder), 1);
-        }
-        if (hdr.version >= 10)
+        else if (key == "core_profile")
         {
-            in.read(reinterpret_cast<char *>(&clkFreq), 1);
+            cfg.coreProfile = (val == "1" || val == "true" || val == "yes");
         }
-        else if (b == static_cast<uint8_t>(BlockType::Button))
-            btnWidth = 8; // legacy saves assume full 8-bit buttons
-        if (!in)
-            return false;
-
-        // Backward compatibility: versions 1–2 were saved before XorGate was inserted
-        // into the BlockType enum, so Led/Button/Wire/Sign indices moved.
-        if (hdr.version < 3)
+        else if (key == "autosave_seconds")
         {
-            // Old mapping:
-            // 13 = Led, 14 = Button, 15 = Wire, 16 = Sign
-            // New mapping:
-            // 14 = Led, 15 = Button, 16 = Wire, 17 = Sign
-            if (b == 13)
-                b = static_cast<uint8_t>(BlockType::Led);
-            else if (b == 14)
-                b = static_cast<uint8_t>(BlockType::Button);
-            else if (b == 15)
-                b = static_cast<uint8_t>(BlockType::Wire);
-            else if (b == 16)
-                b = static_cast<uint8_t>(BlockType::Sign);
-        }
-
-        int x = i % world.getWidth();
-        int y = (i / world.getWidth()) / world.getDepth();
-        int z = (i / world.getWidth()) % world.getDepth();
-        world.set(x, y, z, static_cast<BlockType>(b));
-        world.setPower(x, y, z, p);
-        world.setButtonState(x, y, z, btn);
-        if (b == static_cast<uint8_t>(BlockType::Button))
-        {
-            // For maps saved before version 8, force default 1-bit value = 1
-            if (hdr.version < 8)
+            try
+            {
+                float v = std::stof(val);
+                if (v >= 0.0f && v <= 3600.0f)
+                    cfg.autosaveSeconds = v;
+            }
+            catch (...)
             {
-                btnWidth = 1;
-                btnVal = 1;
             }
-            world.setButtonWidth(x, y, z, btnWidth == 0 ? 8 : btnWidth);
-            world.setButtonValue(x, y, z, btnVal);
         }
-        if (b == static_cast<uint8_t>(BlockType::Splitter) || b == static_cast<uint8_t>(BlockType::Merger))
+        else if (key == "undo_memory_mb")
         {
-            if (hdr.version < 9)
+            try
+            {
+                float v = std::stof(val);
+                if (v >= 0.0f && v <= 4096.0f)
+                    cfg.undoMemoryMb = v;
+            }
+            catch (...)
             {
-                splitWidth = 1;
-                splitOrder = 0;
             }
-            world.setSplitterWidth(x, y, z, splitWidth == 0 ? 1 : splitWidth);
-            world.setSplitterOrder(x, y, z, splitOrder);
         }
-        if (b == static_cast<uint8_t>(BlockType::Clock))
+        else if (key == "mapped_saves")
         {
-            if (hdr.version < 10)
-                clkFreq = 60;
-            world.setClockFreq(x, y, z, clkFreq == 0 ? 1 : clkFreq);
+            cfg.mappedSaves = (val == "1" || val == "true" || val == "yes");
         }
-    }
-
-    // Load sign texts for version >= 2
-    if (hdr.version >= 2)
-    {
-        uint32_t signCount = 0;
-        in.read(reinterpret_cast<char *>(&signCount), sizeof(signCount));
-        if (!in)
-            return false;
-        for (uint32_t i = 0; i < signCount; ++i)
+        else if (key == "remesh_budget_ms")
         {
-            uint32_t idx = 0;
-            uint16_t len = 0;
-            in.read(reinterpret_cast<char *>(&idx), sizeof(idx));
-            in.read(reinterpret_cast<char *>(&len), sizeof(len));
-            if (!in)
-                return false;
-            std::string txt;
-            txt.resize(len);
-            if (len > 0)
+            try
             {
-                in.read(&txt[0], len);
-                if (!in)
-                    return false;
+                float v = std::stof(val);
+                if (v >= 0.5f && v <= 100.0f)
+                    cfg.remeshBudgetMs = v;
             }
-            int x = static_cast<int>(idx % static_cast<uint32_t>(world.getWidth()));
-            int y = static_cast<int>((idx / static_cast<uint32_t>(world.getWidth())) /
-                                     static_cast<uint32_t>(world.getDepth()));
-            int z = static_cast<int>((idx / static_cast<uint32_t>(world.getWidth())) %
-                                     static_cast<uint32_t>(world.getDepth()));
-            if (world.inside(x, y, z) && world.get(x, y, z) == BlockType::Sign)
+            catch (...)
             {
-                world.setSignText(x, y, z, txt);
             }
         }
     }
-    seedOut = hdr.seed;
-    markAllChunksDirty();
-    return true;
+}
+
+void saveConfig(const Config &cfg)
+{
+    std::ofstream out(CONFIG_FILE);
+    if (!out)
+        return;
+    out << "mouse_sensitivity=" << cfg.mouseSensitivity << "\n";
+    out << "fullscreen=" << (cfg.fullscreenDefault ? 1 : 0) << "\n";
+    out << "show_fps=" << (cfg.showFps ? 1 : 0) << "\n";
+    out << "vsync=" << (cfg.vsync ? 1 : 0) << "\n";
+    out << "core_profile=" << (cfg.coreProfile ? 1 : 0) << "\n";
+    out << "remesh_budget_ms=" << cfg.remeshBudgetMs << "\n";
+    out << "mapped_saves=" << (cfg.mappedSaves ? 1 : 0) << "\n";
+    out << "autosave_seconds=" << cfg.autosaveSeconds << "\n";
+    out << "undo_memory_mb=" << cfg.undoMemoryMb << "\n";
 }
 
 std::string timestampSaveName()
@@ -1582,7 +1664,20 @@ std::string gSplitterWidthBuffer;
 bool gSplitterOrder = false; // false = B1 LSB (split: LSB->B1), true = B1 MSB
 bool gMainMenuOpen = true;
 bool gSettingsMenuOpen = false;
+bool gDebugOverlayOpen = false;
+bool gWaveformOpen = false;
+bool gSimStatsOpen = false;
+// F7 records the session's edits to a .replay; `--replay-view <file>` plays one back in the window
+Replay gReplay;
+size_t gReplayCursor = 0;
+bool gReplayPlaying = false;
 Config gConfig;
+// Region tool: B marks the selection corners, Ctrl+C/V copy and paste, Ctrl+R/M turn and mirror the clipboard.
+// Ctrl+Z/Y undo and redo (undo.hpp).
+Clipboard gClipboard;
+int gSelectionCorners = 0; // 0 = none, 1 = first corner only, 2 = box
+int gSelA[3] = {0, 0, 0};
+int gSelB[3] = {0, 0, 0};
 
 std::string stemFromPath(const std::string &path);
 
@@ -1658,6 +1753,132 @@ std::string buildSavePathFromInput(const std::string &input)
     return (gMapsDir / name).string();
 }
 
+// Selects the new file in the list once a save is on disk
+void finishSave(const std::string &path, bool ok)
+{
+    std::cout << (ok ? "Sauvegarde OK: " : "Sauvegarde KO: ") << path << "\n";
+    if (!ok)
+        return;
+    refreshSaveList();
+    int idx = findSaveIndexByStem(stemFromPath(path));
+    if (idx >= 0)
+        gSaveIndex = idx;
+}
+
+// True (and says so) while a load is still streaming chunks in: they would overwrite edits made meanwhile, and the
+// undo history and journal would record them against a half-loaded world
+bool blockedByLoad()
+{
+    if (!streamingLoadActive())
+        return false;
+    std::cout << "Chargement en cours\n";
+    return true;
+}
+
+// Mapped saves flush synchronously (an msync); regular saves run in the background and finish in the main loop.
+// False if nothing was started (also while a load is still streaming in).
+bool beginSave(World &world, const std::string &path, uint32_t seed)
+{
+    if (blockedByLoad())
+        return false;
+    if (gConfig.mappedSaves)
+    {
+        bool ok = saveMappedWorld(world, path, seed);
+        finishSave(path, ok);
+        return ok;
+    }
+    if (!startAsyncSave(world, path, seed))
+    {
+        std::cout << "Sauvegarde deja en cours\n";
+        return false;
+    }
+    return true;
+}
+
+// Region tool, undo and probe keys. `hit` is the block under the crosshair; pastes land on the free cell in front
+// of its face.
+void handleEditKey(SDL_Keycode key, bool ctrl, World &world, const HitInfo &hit)
+{
+    if (!ctrl && key == SDLK_b)
+    {
+        if (!hit.hit)
+            return;
+        int *corner = gSelectionCorners == 1 ? gSelB : gSelA;
+        corner[0] = hit.x;
+        corner[1] = hit.y;
+        corner[2] = hit.z;
+        if (gSelectionCorners != 1)
+            std::copy(gSelA, gSelA + 3, gSelB);
+        gSelectionCorners = gSelectionCorners == 1 ? 2 : 1;
+        std::cout << "Selection: coin " << gSelectionCorners << " (" << hit.x << ", " << hit.y << ", " << hit.z
+                  << ")\n";
+    }
+    else if (key == SDLK_c)
+    {
+        if (gSelectionCorners == 0)
+            return;
+        copyToClipboard(world, gSelA[0], gSelA[1], gSelA[2], gSelB[0], gSelB[1], gSelB[2], gClipboard);
+        std::cout << "Copie: " << gClipboard.nx << "x" << gClipboard.ny << "x" << gClipboard.nz << "\n";
+    }
+    else if (key == SDLK_v)
+    {
+        if (!hit.hit || gClipboard.empty() || blockedByLoad())
+            return;
+        int px = hit.x + hit.nx, py = hit.y + hit.ny, pz = hit.z + hit.nz;
+        if (!world.inside(px, py, pz) ||
+            !world.inside(px + gClipboard.nx - 1, py + gClipboard.ny - 1, pz + gClipboard.nz - 1))
+        {
+            std::cout << "Collage hors du monde\n";
+            return;
+        }
+        undoRecordRegion(world, px, py, pz, gClipboard.nx, gClipboard.ny, gClipboard.nz);
+        replayNoteRegion(px, py, pz, gClipboard.nx, gClipboard.ny, gClipboard.nz);
+        pasteClipboard(world, gClipboard, px, py, pz);
+        std::cout << "Collage OK\n";
+    }
+    else if (key == SDLK_r)
+        rotateClipboard(gClipboard);
+    else if (key == SDLK_m)
+        mirrorClipboard(gClipboard);
+    else if (key == SDLK_z || key == SDLK_y)
+    {
+        if (blockedByLoad())
+            return;
+        std::vector<std::array<int, 6>> touched;
+        if (key == SDLK_z ? !undoStep(world, &touched) : !redoStep(world, &touched))
+            std::cout << (key == SDLK_z ? "Rien a annuler\n" : "Rien a refaire\n");
+        for (const auto &box : touched)
+            replayNoteRegion(box[0], box[1], box[2], box[3], box[4], box[5]);
+    }
+    else if (!ctrl && key == SDLK_p)
+    {
+        if (!hit.hit)
+            return;
+        if (!probeToggle(world, hit.x, hit.y, hit.z))
+            std::cout << "Trop de sondes (" << MAX_PROBES << " max)\n";
+        else
+            std::cout << "Sondes: " << probeCount() << "\n";
+    }
+    else if (key == SDLK_p)
+    {
+        std::string path = std::filesystem::path(timestampSaveName()).replace_extension(".vcd").string();
+        if (probeWriteVcd(path))
+            std::cout << "Export VCD: " << path << "\n";
+        else
+            std::cout << "Export VCD impossible\n";
+    }
+}
+
+// Ends the F7 recording into maps/<date>.replay
+void saveReplayRecording(const World &world)
+{
+    std::string path = std::filesystem::path(timestampSaveName()).replace_extension(".replay").string();
+    if (replayStopRecording(world, path))
+        std::cout << "Replay enregistre: " << path << "\n";
+    else
+        std::cout << "Replay KO: " << path << "\n";
+}
+
 void drawButtonStateLabels(const World &world, const Player &player, float radius)
 {
     Vec3 fwd = forwardVec(player.yaw, player.pitch);
@@ -1683,55 +1904,50 @@ void drawButtonStateLabels(const World &world, const Player &player, float radiu
     camUp.z *= -1.0f;
     float size = 0.22f;
 
-    int minX = std::max(0, static_cast<int>(std::floor(player.x - radius)));
-    int maxX = std::min(world.getWidth() - 1, static_cast<int>(std::ceil(player.x + radius)));
-    int minY = std::max(0, static_cast<int>(std::floor(player.y - radius)));
-    int maxY = std::min(world.getHeight() - 1, static_cast<int>(std::ceil(player.y + radius)));
-    int minZ = std::max(0, static_cast<int>(std::floor(player.z - radius)));
-    int maxZ = std::min(world.getDepth() - 1, static_cast<int>(std::ceil(player.z + radius)));
-
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_CULL_FACE);
-    for (int y = minY; y <= maxY; ++y)
+    // walk the World's Button/Counter index instead of scanning the voxel cube around the player
+    gfxDisable(GL_TEXTURE_2D);
+    gfxDisable(GL_CULL_FACE);
+    gfxBegin(GL_QUADS);
+    for (BlockType type : {BlockType::Button, BlockType::Counter})
     {
-        for (int z = minZ; z <= maxZ; ++z)
+        for (int idx : world.blocksOfType(type))
         {
-            for (int x = minX; x <= maxX; ++x)
+            int x, y, z;
+            world.cellCoords(idx, x, y, z);
+            Vec3 pos{static_cast<float>(x) + 0.5f, static_cast<float>(y) + 1.2f, static_cast<float>(z) + 0.5f};
+            if (std::abs(pos.x - player.x) > radius + 0.5f || std::abs(pos.y - 1.2f - player.y) > radius + 0.5f ||
+                std::abs(pos.z - player.z) > radius + 0.5f)
+                continue;
+            pos.x += camUp.x * 0.02f;
+            pos.y += camUp.y * 0.02f;
+            pos.z += camUp.z * 0.02f;
+            if (type == BlockType::Button)
             {
-                BlockType b = world.get(x, y, z);
-                if (b != BlockType::Button && b != BlockType::Counter)
-                    continue;
-                Vec3 pos{static_cast<float>(x) + 0.5f, static_cast<float>(y) + 1.2f, static_cast<float>(z) + 0.5f};
-                pos.x += camUp.x * 0.02f;
-                pos.y += camUp.y * 0.02f;
-                pos.z += camUp.z * 0.02f;
-                if (b == BlockType::Button)
-                {
-                    int state = world.getButtonState(x, y, z) ? 1 : 0;
-                    float alpha = 0.95f;
-                    drawDigitBillboard(pos, size, state, camRight, camUp, 1.0f, 0.95f, 0.2f, alpha);
-                }
-                else if (b == BlockType::Counter)
+                int state = world.getButtonState(x, y, z) ? 1 : 0;
+                float alpha = 0.95f;
+                drawDigitBillboard(pos, size, state, camRight, camUp, 1.0f, 0.95f, 0.2f, alpha);
+            }
+            else
+            {
+                uint8_t val = world.getPower(x, y, z);
+                int hundreds = (val / 100) % 10;
+                int tens = (val / 10) % 10;
+                int ones = val % 10;
+                float alpha = 0.95f;
+                float spacing = size * 0.8f; // slight extra gap between digits
+                auto offsetPos = [&](float mul)
                 {
-                    uint8_t val = world.getPower(x, y, z);
-                    int hundreds = (val / 100) % 10;
-                    int tens = (val / 10) % 10;
-                    int ones = val % 10;
-                    float alpha = 0.95f;
-                    float spacing = size * 0.8f; // slight extra gap between digits
-                    auto offsetPos = [&](float mul)
-                    {
-                        return Vec3{pos.x + camRight.x * mul, pos.y + camRight.y * mul, pos.z + camRight.z * mul};
-                    };
-                    drawDigitBillboard(offsetPos(-spacing), size * 0.7f, hundreds, camRight, camUp, 1.0f, 1.0f, 1.0f,
-                                       alpha);
-                    // center digit: keep same axes but draw with a tiny offset to avoid overlap
-                    drawDigitBillboard(offsetPos(0.0f), size * 0.7f, tens, camRight, camUp, 1.0f, 1.0f, 1.0f, alpha);
-                    drawDigitBillboard(offsetPos(spacing), size * 0.7f, ones, camRight, camUp, 1.0f, 1.0f, 1.0f, alpha);
-                }
+                    return Vec3{pos.x + camRight.x * mul, pos.y + camRight.y * mul, pos.z + camRight.z * mul};
+                };
+                drawDigitBillboard(offsetPos(-spacing), size * 0.7f, hundreds, camRight, camUp, 1.0f, 1.0f, 1.0f,
+                                   alpha);
+                // center digit: keep same axes but draw with a tiny offset to avoid overlap
+                drawDigitBillboard(offsetPos(0.0f), size * 0.7f, tens, camRight, camUp, 1.0f, 1.0f, 1.0f, alpha);
+                drawDigitBillboard(offsetPos(spacing), size * 0.7f, ones, camRight, camUp, 1.0f, 1.0f, 1.0f, alpha);
             }
         }
     }
+    gfxEnd();
 }
 inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize)
 {
@@ -1744,30 +1960,30 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
     switch (slot.type)
     {
     case BlockType::Led:
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glBegin(GL_LINE_LOOP);
-        glVertex2f(x + slotSize * 0.25f, y + slotSize * 0.25f);
-        glVertex2f(x + slotSize * 0.25f, y + slotSize * 0.75f);
-        glVertex2f(x + slotSize * 0.65f, y + slotSize * 0.5f);
-        glEnd();
-        glBegin(GL_LINES);
-        glVertex2f(x + slotSize * 0.05f, y + slotSize * 0.5f);
-        glVertex2f(x + slotSize * 0.25f, y + slotSize * 0.5f);
-        glVertex2f(x + slotSize * 0.65f, y + slotSize * 0.5f);
-        glVertex2f(x + slotSize * 0.95f, y + slotSize * 0.5f);
-        glVertex2f(x + slotSize * 0.72f, y + slotSize * 0.2f);
-        glVertex2f(x + slotSize * 0.72f, y + slotSize * 0.8f);
-        glEnd();
-        glBegin(GL_LINES);
-        glVertex2f(x + slotSize * 0.55f, y + slotSize * 0.35f);
-        glVertex2f(x + slotSize * 0.4f, y + slotSize * 0.18f);
-        glVertex2f(x + slotSize * 0.52f, y + slotSize * 0.32f);
-        glVertex2f(x + slotSize * 0.42f, y + slotSize * 0.26f);
-        glVertex2f(x + slotSize * 0.6f, y + slotSize * 0.2f);
-        glVertex2f(x + slotSize * 0.45f, y + slotSize * 0.05f);
-        glVertex2f(x + slotSize * 0.57f, y + slotSize * 0.17f);
-        glVertex2f(x + slotSize * 0.47f, y + slotSize * 0.11f);
-        glEnd();
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxBegin(GL_LINE_LOOP);
+        gfxVertex2f(x + slotSize * 0.25f, y + slotSize * 0.25f);
+        gfxVertex2f(x + slotSize * 0.25f, y + slotSize * 0.75f);
+        gfxVertex2f(x + slotSize * 0.65f, y + slotSize * 0.5f);
+        gfxEnd();
+        gfxBegin(GL_LINES);
+        gfxVertex2f(x + slotSize * 0.05f, y + slotSize * 0.5f);
+        gfxVertex2f(x + slotSize * 0.25f, y + slotSize * 0.5f);
+        gfxVertex2f(x + slotSize * 0.65f, y + slotSize * 0.5f);
+        gfxVertex2f(x + slotSize * 0.95f, y + slotSize * 0.5f);
+        gfxVertex2f(x + slotSize * 0.72f, y + slotSize * 0.2f);
+        gfxVertex2f(x + slotSize * 0.72f, y + slotSize * 0.8f);
+        gfxEnd();
+        gfxBegin(GL_LINES);
+        gfxVertex2f(x + slotSize * 0.55f, y + slotSize * 0.35f);
+        gfxVertex2f(x + slotSize * 0.4f, y + slotSize * 0.18f);
+        gfxVertex2f(x + slotSize * 0.52f, y + slotSize * 0.32f);
+        gfxVertex2f(x + slotSize * 0.42f, y + slotSize * 0.26f);
+        gfxVertex2f(x + slotSize * 0.6f, y + slotSize * 0.2f);
+        gfxVertex2f(x + slotSize * 0.45f, y + slotSize * 0.05f);
+        gfxVertex2f(x + slotSize * 0.57f, y + slotSize * 0.17f);
+        gfxVertex2f(x + slotSize * 0.47f, y + slotSize * 0.11f);
+        gfxEnd();
         break;
     case BlockType::Button:
         drawQuad(cx - slotSize * 0.25f, cy - slotSize * 0.12f, slotSize * 0.5f, slotSize * 0.24f, 0.75f, 0.25f,
@@ -1779,8 +1995,8 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
     case BlockType::AndGate:
     case BlockType::XorGate:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float pad = slotSize * 0.18f;
         drawOutline(x + pad, y + pad, slotSize - pad * 2, slotSize - pad * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         const char *label = "XOR";
@@ -1793,13 +2009,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         float textX = x + (slotSize - textWidth) * 0.5f;
         float textY = y + slotSize * 0.36f;
         drawTextTiny(textX, textY, txtSize, label, 1.0f, 1.0f, 1.0f, 1.0f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::AddGate:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float padAdd = slotSize * 0.18f;
         drawOutline(x + padAdd, y + padAdd, slotSize - padAdd * 2, slotSize - padAdd * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         float txtSize = 1.4f;
@@ -1813,22 +2029,22 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         drawTextTiny(x + (slotSize * 0.5f) - 4.0f, y + padAdd - 2.0f, 1.1f, "S", 1.0f, 1.0f, 1.0f, 0.9f);
         drawTextTiny(x + padAdd + 2.0f, y + slotSize * 0.28f, 1.0f, "Cin", 1.0f, 1.0f, 1.0f, 0.9f);
         drawTextTiny(x + slotSize * 0.54f, y + slotSize * 0.28f, 1.0f, "Cout", 1.0f, 1.0f, 1.0f, 0.9f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::Wire:
-        glColor4f(1.0f, 0.9f, 0.3f, 0.95f);
-        glBegin(GL_LINE_STRIP);
-        glVertex2f(x + slotSize * 0.15f, y + slotSize * 0.65f);
-        glVertex2f(x + slotSize * 0.35f, y + slotSize * 0.55f);
-        glVertex2f(x + slotSize * 0.55f, y + slotSize * 0.7f);
-        glVertex2f(x + slotSize * 0.82f, y + slotSize * 0.4f);
-        glEnd();
+        gfxColor4f(1.0f, 0.9f, 0.3f, 0.95f);
+        gfxBegin(GL_LINE_STRIP);
+        gfxVertex2f(x + slotSize * 0.15f, y + slotSize * 0.65f);
+        gfxVertex2f(x + slotSize * 0.35f, y + slotSize * 0.55f);
+        gfxVertex2f(x + slotSize * 0.55f, y + slotSize * 0.7f);
+        gfxVertex2f(x + slotSize * 0.82f, y + slotSize * 0.4f);
+        gfxEnd();
         break;
     case BlockType::NotGate:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float padNot = slotSize * 0.18f;
         drawOutline(x + padNot, y + padNot, slotSize - padNot * 2, slotSize - padNot * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         float txtSize = 1.6f;
@@ -1836,13 +2052,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         float textX = x + (slotSize - textWidth) * 0.5f;
         float textY = y + slotSize * 0.4f;
         drawTextTiny(textX, textY, txtSize, "NOT", 1.0f, 1.0f, 1.0f, 1.0f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::Counter:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float padCtr = slotSize * 0.25f;
         drawOutline(x + padCtr, y + padCtr, slotSize - padCtr * 2, slotSize - padCtr * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         float txtSize = 1.6f;
@@ -1851,14 +2067,14 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         float textX = x + (slotSize - textWidth) * 0.5f;
         float textY = y + slotSize * 0.38f;
         drawTextTiny(textX, textY, txtSize, "CNT", 1.0f, 1.0f, 1.0f, 1.0f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::Splitter:
     case BlockType::Merger:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float pad = slotSize * 0.2f;
         drawOutline(x + pad, y + pad, slotSize - pad * 2, slotSize - pad * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         const char *label = slot.type == BlockType::Splitter ? "SPL" : "MER";
@@ -1867,13 +2083,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         float textX = x + (slotSize - textWidth) * 0.5f;
         float textY = y + slotSize * 0.38f;
         drawTextTiny(textX, textY, txtSize, label, 1.0f, 1.0f, 1.0f, 1.0f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::Multiplexer:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float pad = slotSize * 0.2f;
         drawOutline(x + pad, y + pad, slotSize - pad * 2, slotSize - pad * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         float txtSize = 1.4f;
@@ -1884,13 +2100,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         drawTextTiny(x + pad + 2.0f, y + slotSize - pad - 10.0f, 1.0f, "SEL", 1.0f, 1.0f, 1.0f, 0.85f);
         drawTextTiny(x + slotSize - pad - 12.0f, y + slotSize - pad - 10.0f, 1.0f, "0", 1.0f, 1.0f, 1.0f, 0.85f);
         drawTextTiny(x + slotSize * 0.35f, y + pad - 4.0f, 1.0f, "OUT", 1.0f, 1.0f, 1.0f, 0.85f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::Comparator:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float pad = slotSize * 0.18f;
         drawOutline(x + pad, y + pad, slotSize - pad * 2, slotSize - pad * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         float txtSize = 1.5f;
@@ -1898,13 +2114,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         float textX = x + (slotSize - textWidth) * 0.5f;
         float textY = y + slotSize * 0.38f;
         drawTextTiny(textX, textY, txtSize, "CMP", 1.0f, 1.0f, 1.0f, 1.0f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::Clock:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float pad = slotSize * 0.2f;
         drawOutline(x + pad, y + pad, slotSize - pad * 2, slotSize - pad * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         float txtSize = 1.5f;
@@ -1912,13 +2128,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         float textX = x + (slotSize - textWidth) * 0.5f;
         float textY = y + slotSize * 0.38f;
         drawTextTiny(textX, textY, txtSize, "CLK", 1.0f, 1.0f, 1.0f, 1.0f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::Decoder:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float pad = slotSize * 0.2f;
         drawOutline(x + pad, y + pad, slotSize - pad * 2, slotSize - pad * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         float txtSize = 1.5f;
@@ -1929,13 +2145,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         drawTextTiny(x + pad + 2.0f, y + slotSize - pad - 10.0f, 1.0f, "SEL", 1.0f, 1.0f, 1.0f, 0.85f);
         drawTextTiny(x + slotSize - pad - 12.0f, y + slotSize - pad - 10.0f, 1.0f, "EN", 1.0f, 1.0f, 1.0f, 0.85f);
         drawTextTiny(x + slotSize * 0.35f, y + pad - 4.0f, 1.0f, "OUT", 1.0f, 1.0f, 1.0f, 0.85f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::DFlipFlop:
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.92f);
-        glLineWidth(2.0f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.92f);
+        gfxLineWidth(2.0f);
         float padDff = slotSize * 0.18f;
         drawOutline(x + padDff, y + padDff, slotSize - padDff * 2, slotSize - padDff * 2, 1.0f, 1.0f, 1.0f, 0.9f, 2.0f);
         float txtSize = 1.4f;
@@ -1947,7 +2163,7 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         drawTextTiny(x + padDff + 2.0f, y + slotSize - padDff - 8.0f, 1.2f, "D", 1.0f, 1.0f, 1.0f, 0.9f);
         drawTextTiny(x + slotSize - padDff - 12.0f, y + slotSize - padDff - 8.0f, 1.2f, "CLK", 1.0f, 1.0f, 1.0f, 0.9f);
         drawTextTiny(x + (slotSize * 0.5f) - 4.0f, y + padDff - 2.0f, 1.2f, "Q", 1.0f, 1.0f, 1.0f, 0.9f);
-        glLineWidth(1.0f);
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::Sign:
@@ -1973,23 +2189,23 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
     case BlockType::Grass:
     {
         // simple blades of grass (no background square)
-        glColor4f(0.12f, 0.55f, 0.18f, 0.35f);
+        gfxColor4f(0.12f, 0.55f, 0.18f, 0.35f);
         drawQuad(x + slotSize * 0.1f, y + slotSize * 0.55f, slotSize * 0.8f, slotSize * 0.25f, 0.12f, 0.55f, 0.18f,
                  0.25f);
-        glColor4f(0.1f, 0.9f, 0.3f, 0.95f);
-        glLineWidth(2.0f);
-        glBegin(GL_LINES);
+        gfxColor4f(0.1f, 0.9f, 0.3f, 0.95f);
+        gfxLineWidth(2.0f);
+        gfxBegin(GL_LINES);
         float baseY = y + slotSize * 0.78f;
         for (int i = 0; i < 8; ++i)
         {
             float t = static_cast<float>(i) / 7.0f;
             float gx = x + slotSize * 0.15f + t * slotSize * 0.7f;
             float sway = (i % 2 == 0) ? -0.05f : 0.05f;
-            glVertex2f(gx, baseY);
-            glVertex2f(gx + slotSize * sway, baseY - slotSize * (0.25f + 0.1f * t));
+            gfxVertex2f(gx, baseY);
+            gfxVertex2f(gx + slotSize * sway, baseY - slotSize * (0.25f + 0.1f * t));
         }
-        glEnd();
-        glLineWidth(1.0f);
+        gfxEnd();
+        gfxLineWidth(1.0f);
         break;
     }
     case BlockType::Dirt:
@@ -2006,34 +2222,34 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
     case BlockType::Stone:
     {
         // brick-like pattern without solid square
-        glColor4f(0.6f, 0.6f, 0.65f, 0.25f);
-        glBegin(GL_LINES);
+        gfxColor4f(0.6f, 0.6f, 0.65f, 0.25f);
+        gfxBegin(GL_LINES);
         // horizontal courses
         float y1 = y + slotSize * 0.35f;
         float y2 = y + slotSize * 0.6f;
-        glVertex2f(x + slotSize * 0.1f, y1);
-        glVertex2f(x + slotSize * 0.9f, y1);
-        glVertex2f(x + slotSize * 0.1f, y2);
-        glVertex2f(x + slotSize * 0.9f, y2);
+        gfxVertex2f(x + slotSize * 0.1f, y1);
+        gfxVertex2f(x + slotSize * 0.9f, y1);
+        gfxVertex2f(x + slotSize * 0.1f, y2);
+        gfxVertex2f(x + slotSize * 0.9f, y2);
         // vertical offsets (staggered)
-        glVertex2f(x + slotSize * 0.3f, y1);
-        glVertex2f(x + slotSize * 0.3f, y);
-        glVertex2f(x + slotSize * 0.7f, y1);
-        glVertex2f(x + slotSize * 0.7f, y);
-        glVertex2f(x + slotSize * 0.2f, y2);
-        glVertex2f(x + slotSize * 0.2f, y1);
-        glVertex2f(x + slotSize * 0.6f, y2);
-        glVertex2f(x + slotSize * 0.6f, y1);
-        glVertex2f(x + slotSize * 0.9f, y2);
-        glVertex2f(x + slotSize * 0.9f, y1);
-        glEnd();
-        glColor4f(0.25f, 0.25f, 0.3f, 0.4f);
-        glBegin(GL_LINES);
-        glVertex2f(x + slotSize * 0.1f, y);
-        glVertex2f(x + slotSize * 0.1f, y + slotSize);
-        glVertex2f(x + slotSize * 0.9f, y);
-        glVertex2f(x + slotSize * 0.9f, y + slotSize);
-        glEnd();
+        gfxVertex2f(x + slotSize * 0.3f, y1);
+        gfxVertex2f(x + slotSize * 0.3f, y);
+        gfxVertex2f(x + slotSize * 0.7f, y1);
+        gfxVertex2f(x + slotSize * 0.7f, y);
+        gfxVertex2f(x + slotSize * 0.2f, y2);
+        gfxVertex2f(x + slotSize * 0.2f, y1);
+        gfxVertex2f(x + slotSize * 0.6f, y2);
+        gfxVertex2f(x + slotSize * 0.6f, y1);
+        gfxVertex2f(x + slotSize * 0.9f, y2);
+        gfxVertex2f(x + slotSize * 0.9f, y1);
+        gfxEnd();
+        gfxColor4f(0.25f, 0.25f, 0.3f, 0.4f);
+        gfxBegin(GL_LINES);
+        gfxVertex2f(x + slotSize * 0.1f, y);
+        gfxVertex2f(x + slotSize * 0.1f, y + slotSize);
+        gfxVertex2f(x + slotSize * 0.9f, y);
+        gfxVertex2f(x + slotSize * 0.9f, y + slotSize);
+        gfxEnd();
         break;
     }
     case BlockType::Wood:
@@ -2044,13 +2260,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         float trunkX = x + slotSize * 0.22f;
         float trunkY = y + slotSize * 0.25f;
         drawQuad(trunkX, trunkY, trunkW, trunkH, 0.45f, 0.32f, 0.16f, 0.9f);
-        glColor4f(0.2f, 0.12f, 0.07f, 0.8f);
-        glBegin(GL_LINES);
-        glVertex2f(trunkX + trunkW * 0.33f, trunkY);
-        glVertex2f(trunkX + trunkW * 0.33f, trunkY + trunkH);
-        glVertex2f(trunkX + trunkW * 0.66f, trunkY);
-        glVertex2f(trunkX + trunkW * 0.66f, trunkY + trunkH);
-        glEnd();
+        gfxColor4f(0.2f, 0.12f, 0.07f, 0.8f);
+        gfxBegin(GL_LINES);
+        gfxVertex2f(trunkX + trunkW * 0.33f, trunkY);
+        gfxVertex2f(trunkX + trunkW * 0.33f, trunkY + trunkH);
+        gfxVertex2f(trunkX + trunkW * 0.66f, trunkY);
+        gfxVertex2f(trunkX + trunkW * 0.66f, trunkY + trunkH);
+        gfxEnd();
 
         // side log with rings
         float logX = x + slotSize * 0.55f;
@@ -2058,19 +2274,19 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         float logW = slotSize * 0.28f;
         float logH = slotSize * 0.2f;
         drawQuad(logX, logY, logW, logH, 0.55f, 0.4f, 0.22f, 0.9f);
-        glColor4f(0.25f, 0.16f, 0.09f, 0.9f);
-        glBegin(GL_LINE_LOOP);
-        glVertex2f(logX, logY);
-        glVertex2f(logX + logW, logY);
-        glVertex2f(logX + logW, logY + logH);
-        glVertex2f(logX, logY + logH);
-        glEnd();
-        glBegin(GL_LINES);
-        glVertex2f(logX + logW * 0.25f, logY);
-        glVertex2f(logX + logW * 0.25f, logY + logH);
-        glVertex2f(logX + logW * 0.55f, logY);
-        glVertex2f(logX + logW * 0.55f, logY + logH);
-        glEnd();
+        gfxColor4f(0.25f, 0.16f, 0.09f, 0.9f);
+        gfxBegin(GL_LINE_LOOP);
+        gfxVertex2f(logX, logY);
+        gfxVertex2f(logX + logW, logY);
+        gfxVertex2f(logX + logW, logY + logH);
+        gfxVertex2f(logX, logY + logH);
+        gfxEnd();
+        gfxBegin(GL_LINES);
+        gfxVertex2f(logX + logW * 0.25f, logY);
+        gfxVertex2f(logX + logW * 0.25f, logY + logH);
+        gfxVertex2f(logX + logW * 0.55f, logY);
+        gfxVertex2f(logX + logW * 0.55f, logY + logH);
+        gfxEnd();
         break;
     }
     case BlockType::Leaves:
@@ -2085,13 +2301,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
     {
         drawQuad(x, y, slotSize, slotSize, 0.1f, 0.35f, 0.85f, 0.55f);
         drawOutline(x, y, slotSize, slotSize, 0.2f, 0.6f, 1.0f, 0.4f, 2.0f);
-        glColor4f(0.6f, 0.8f, 1.0f, 0.8f);
-        glBegin(GL_LINES);
-        glVertex2f(x + slotSize * 0.2f, y + slotSize * 0.35f);
-        glVertex2f(x + slotSize * 0.8f, y + slotSize * 0.35f);
-        glVertex2f(x + slotSize * 0.25f, y + slotSize * 0.55f);
-        glVertex2f(x + slotSize * 0.75f, y + slotSize * 0.55f);
-        glEnd();
+        gfxColor4f(0.6f, 0.8f, 1.0f, 0.8f);
+        gfxBegin(GL_LINES);
+        gfxVertex2f(x + slotSize * 0.2f, y + slotSize * 0.35f);
+        gfxVertex2f(x + slotSize * 0.8f, y + slotSize * 0.35f);
+        gfxVertex2f(x + slotSize * 0.25f, y + slotSize * 0.55f);
+        gfxVertex2f(x + slotSize * 0.75f, y + slotSize * 0.55f);
+        gfxEnd();
         break;
     }
     case BlockType::Plank:
@@ -2099,13 +2315,13 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
         float pad = slotSize * 0.18f;
         drawQuad(x + pad, y + pad, slotSize - pad * 2, slotSize - pad * 2, 0.75f, 0.6f, 0.35f, 0.9f);
         drawOutline(x + pad, y + pad, slotSize - pad * 2, slotSize - pad * 2, 0.0f, 0.0f, 0.0f, 0.35f, 2.0f);
-        glColor4f(0.35f, 0.25f, 0.15f, 0.7f);
-        glBegin(GL_LINES);
-        glVertex2f(x + slotSize * 0.2f, y + slotSize * 0.4f);
-        glVertex2f(x + slotSize * 0.8f, y + slotSize * 0.4f);
-        glVertex2f(x + slotSize * 0.2f, y + slotSize * 0.6f);
-        glVertex2f(x + slotSize * 0.8f, y + slotSize * 0.6f);
-        glEnd();
+        gfxColor4f(0.35f, 0.25f, 0.15f, 0.7f);
+        gfxBegin(GL_LINES);
+        gfxVertex2f(x + slotSize * 0.2f, y + slotSize * 0.4f);
+        gfxVertex2f(x + slotSize * 0.8f, y + slotSize * 0.4f);
+        gfxVertex2f(x + slotSize * 0.2f, y + slotSize * 0.6f);
+        gfxVertex2f(x + slotSize * 0.8f, y + slotSize * 0.6f);
+        gfxEnd();
         break;
     }
     case BlockType::Sand:
@@ -2121,11 +2337,11 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
     {
         drawQuad(x, y, slotSize, slotSize, 0.7f, 0.9f, 1.0f, 0.18f);
         drawOutline(x, y, slotSize, slotSize, 0.8f, 0.95f, 1.0f, 0.4f, 2.0f);
-        glColor4f(0.4f, 0.7f, 0.9f, 0.5f);
-        glBegin(GL_LINES);
-        glVertex2f(x + slotSize * 0.2f, y + slotSize * 0.2f);
-        glVertex2f(x + slotSize * 0.8f, y + slotSize * 0.8f);
-        glEnd();
+        gfxColor4f(0.4f, 0.7f, 0.9f, 0.5f);
+        gfxBegin(GL_LINES);
+        gfxVertex2f(x + slotSize * 0.2f, y + slotSize * 0.2f);
+        gfxVertex2f(x + slotSize * 0.8f, y + slotSize * 0.8f);
+        gfxEnd();
         break;
     }
     default:
@@ -2135,7 +2351,7 @@ inline void drawSlotIcon(const ItemStack &slot, float x, float y, float slotSize
 
 void drawSlotBox(float x, float y, float slotSize, const ItemStack &slot, bool selected, bool hovered)
 {
-    auto col = BLOCKS.at(slot.count > 0 ? slot.type : BlockType::Air).color;
+    auto col = blockTraits(slot.count > 0 ? slot.type : BlockType::Air).color;
     float alpha = slot.count > 0 ? 0.95f : 0.25f;
     drawQuad(x - 3.0f, y - 3.0f, slotSize + 6.0f, slotSize + 6.0f, 0.0f, 0.0f, 0.0f, 0.28f);
     drawQuad(x - 1.0f, y - 1.0f, slotSize + 2.0f, slotSize + 2.0f, 0.08f, 0.08f, 0.12f, 0.55f);
@@ -2232,10 +2448,10 @@ void drawInventoryPanel(int winW, int winH, const std::vector<ItemStack> &invent
             bool hovered = pointInRect(static_cast<float>(mouseX), static_cast<float>(mouseY), x, y, slotSize, slotSize);
             bool selected = (!pendingIsHotbar && pendingSlot == idx);
             drawSlotBox(x, y, slotSize, inventory[idx], selected, hovered);
-            if (hovered && inventory[idx].count > 0 && BLOCKS.count(inventory[idx].type))
+            if (hovered && inventory[idx].count > 0)
             {
                 hoverLabel.valid = true;
-                hoverLabel.text = BLOCKS.at(inventory[idx].type).name;
+                hoverLabel.text = blockTraits(inventory[idx].type).name;
                 hoverLabel.x = static_cast<float>(mouseX);
                 hoverLabel.y = static_cast<float>(mouseY);
             }
@@ -2262,10 +2478,10 @@ void drawInventoryPanel(int winW, int winH, const std::vector<ItemStack> &invent
         bool hovered = pointInRect(static_cast<float>(mouseX), static_cast<float>(mouseY), x, y, slotSize, slotSize);
         bool selected = (pendingIsHotbar && pendingSlot == i);
         drawSlotBox(x, y, slotSize, hotbar[i], selected, hovered);
-        if (hovered && hotbar[i].count > 0 && BLOCKS.count(hotbar[i].type))
+        if (hovered && hotbar[i].count > 0)
         {
             hoverLabel.valid = true;
-            hoverLabel.text = BLOCKS.at(hotbar[i].type).name;
+            hoverLabel.text = blockTraits(hotbar[i].type).name;
             hoverLabel.x = static_cast<float>(mouseX);
             hoverLabel.y = static_cast<float>(mouseY);
         }
@@ -2275,11 +2491,8 @@ void drawInventoryPanel(int winW, int winH, const std::vector<ItemStack> &invent
 void setup3D(int w, int h)
 {
     glViewport(0, 0, w, h);
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluPerspective(70.0, static_cast<double>(w) / static_cast<double>(h), 0.1, 500.0);
-    glMatrixMode(GL_MODELVIEW);
-    glEnable(GL_DEPTH_TEST);
+    gfxSetProjection(mat4Perspective(70.0f, static_cast<float>(w) / static_cast<float>(h), 0.1f, 500.0f));
+    gfxEnable(GL_DEPTH_TEST);
 }
 
 int addToSlots(std::vector<ItemStack> &slots, BlockType b, int amount)
@@ -2323,6 +2536,130 @@ void updateTitle(SDL_Window *window)
     SDL_SetWindowTitle(window, title.c_str());
 }
 
+// FNV-1a over every dense plane: two runs that simulated the same thing end with the same hash
+static uint64_t worldStateHash(const World &world)
+{
+    uint64_t h = 1469598103934665603ull;
+    const uint8_t *p = world.densePlanes();
+    for (size_t i = 0, n = world.denseBytes(); i < n; ++i)
+        h = (h ^ p[i]) * 1099511628211ull;
+    return h;
+}
+
+// Runs the world's logic without a window, `ticks` ticks or until `replay` ends (its edits applied on their tick),
+// and prints the per-tick counters as key/value lines. Settled stretches are jumped over up to the next Clock edge
+// or replay edit; they count as ticks that cost nothing.
+static int runHeadless(World &world, const std::string &label, int ticks, const Replay *replay)
+{
+    CHUNK_X_COUNT = (world.getWidth() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    CHUNK_Y_COUNT = (world.getHeight() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    CHUNK_Z_COUNT = (world.getDepth() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunkMeshes.assign(CHUNK_X_COUNT * CHUNK_Y_COUNT * CHUNK_Z_COUNT, {});
+    if (!SIM_STATS_BUILT)
+        std::cerr << "Compteurs non compiles (LOGICRAFT_SIM_STATS), seuls les temps globaux sont mesures\n";
+    gSimStatsEnabled = true;
+
+    // totals over the run
+    std::array<double, SIM_PHASE_COUNT> phaseMs{};
+    std::array<double, BLOCK_TYPE_COUNT> evaluated{};
+    double wirePushes = 0.0, wirePops = 0.0, sumPeak = 0.0, changedVoxels = 0.0, dirtyChunks = 0.0;
+    uint32_t maxPeak = 0;
+    double maxTickMs = 0.0;
+    double clockEdges = 0.0;
+    size_t cursor = 0;
+    int ran = 0;
+    int skippedTicks = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (replay ? replayApply(world, *replay, cursor) : ran < ticks)
+    {
+        const uint64_t limit =
+            replay ? replayNextTick(*replay, cursor) - world.getLogicTick() : static_cast<uint64_t>(ticks - ran);
+        if (const int skipped = static_cast<int>(world.skipSettledTicks(limit)))
+        {
+            ran += skipped;
+            skippedTicks += skipped;
+            continue;
+        }
+        // the chunk meshes are never rebuilt here; clean them so dirtyChunks counts like a rendered run
+        for (auto &c : chunkMeshes)
+            c.dirty = false;
+        ++ran;
+        if (!updateLogic(world))
+            ++skippedTicks;
+        const SimStats &s = gSimStats;
+        double tickMs = 0.0;
+        for (int p = 0; p < SIM_PHASE_COUNT; ++p)
+        {
+            phaseMs[p] += s.phaseMs[p];
+            tickMs += s.phaseMs[p];
+        }
+        for (int b = 0; b < BLOCK_TYPE_COUNT; ++b)
+            evaluated[b] += s.evaluated[b];
+        wirePushes += s.wirePushes;
+        wirePops += s.wirePops;
+        changedVoxels += s.changedVoxels;
+        dirtyChunks += s.dirtyChunks;
+        sumPeak += s.peakQueue;
+        clockEdges += s.clockEdges;
+        maxPeak = std::max(maxPeak, s.peakQueue);
+        maxTickMs = std::max(maxTickMs, tickMs);
+    }
+    const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // per-tick averages unless noted
+    const double n = std::max(ran, 1);
+    std::printf("%s %s\nsize %dx%dx%d\nticks %d\nskipped_ticks %d\nwall_ms_per_tick %.4f\n", replay ? "replay" : "map",
+                label.c_str(), world.getWidth(), world.getHeight(), world.getDepth(), ran, skippedTicks, wallMs / n);
+    if (replay)
+        std::printf("edits %zu\n", replay->edits.size());
+    if (SIM_STATS_BUILT)
+    {
+        double tickMs = 0.0;
+        for (int p = 0; p < SIM_PHASE_COUNT; ++p)
+        {
+            std::printf("phase_ms %s %.4f\n", simPhaseName(static_cast<SimPhase>(p)), phaseMs[p] / n);
+            tickMs += phaseMs[p];
+        }
+        std::printf("tick_ms %.4f\ntick_ms_max %.4f\n", tickMs / n, maxTickMs);
+        std::printf("wire_pushes %.1f\nwire_pops %.1f\npeak_queue %.1f\npeak_queue_max %u\n", wirePushes / n,
+                    wirePops / n, sumPeak / n, maxPeak);
+        std::printf("changed_voxels %.1f\ndirty_chunks %.1f\nclock_edges %.2f\n", changedVoxels / n, dirtyChunks / n,
+                    clockEdges / n);
+        for (int b = 0; b < BLOCK_TYPE_COUNT; ++b)
+            if (evaluated[b] > 0.0)
+                std::printf("evaluated %s %.1f\n", blockTraits(static_cast<BlockType>(b)).name, evaluated[b] / n);
+    }
+    std::printf("state_hash %016llx\n", static_cast<unsigned long long>(worldStateHash(world)));
+    return 0;
+}
+
+// `logicraft --sim-stats <map> [ticks]`: runs the map's logic for `ticks` ticks
+int runSimStats(const std::string &path, int ticks, int width, int height, int depth)
+{
+    World world(width, height, depth);
+    uint32_t seed = 0;
+    if (!loadWorldFromFile(world, path, seed))
+    {
+        std::cerr << "Chargement impossible: " << path << "\n";
+        return 1;
+    }
+    return runHeadless(world, path, ticks, nullptr);
+}
+
+// `logicraft --replay <file.replay>`: plays a recording back to its last tick, the same ticks on every run
+int runReplay(const std::string &path)
+{
+    Replay replay;
+    if (!loadReplay(path, replay))
+    {
+        std::cerr << "Replay illisible: " << path << "\n";
+        return 1;
+    }
+    World world(replay.width, replay.height, replay.depth);
+    replayRestore(world, replay);
+    return runHeadless(world, path, 0, &replay);
+}
+
 int main(int argc, char **argv)
 {
     const int WIDTH = 96;
@@ -2346,6 +2683,13 @@ int main(int argc, char **argv)
     }
 
     loadConfig(gConfig);
+    undoSetCapacity(static_cast<size_t>(gConfig.undoMemoryMb * 1024.0f * 1024.0f));
+
+    if (argc >= 3 && std::string(argv[1]) == "--sim-stats")
+        return runSimStats(argv[2], argc >= 4 ? std::max(1, std::atoi(argv[3])) : 600, WIDTH, HEIGHT, DEPTH);
+    if (argc >= 3 && std::string(argv[1]) == "--replay")
+        return runReplay(argv[2]);
+    const std::string replayViewPath = argc >= 3 && std::string(argv[1]) == "--replay-view" ? argv[2] : "";
 
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0)
     {
@@ -2353,8 +2697,6 @@ int main(int argc, char **argv)
         return 1;
     }
 
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 
     SDL_Window *window = SDL_CreateWindow("Logicraft", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720,
@@ -2367,25 +2709,53 @@ int main(int argc, char **argv)
     }
     if (gConfig.fullscreenDefault)
         SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN_DESKTOP);
-    SDL_GLContext ctx = SDL_GL_CreateContext(window);
-    if (!ctx)
+    // Prefer a 3.3 core context; fall back to the 2.1 fixed-function path if it can't be created or
+    // the shaders don't build.
+    SDL_GLContext ctx = nullptr;
+    if (gConfig.coreProfile)
     {
-        std::cerr << "OpenGL context error: " << SDL_GetError() << "\n";
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return 1;
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+        ctx = SDL_GL_CreateContext(window);
+        if (ctx)
+        {
+            glewExperimental = GL_TRUE;
+            bool ok = glewInit() == GLEW_OK;
+            glGetError(); // GLEW trips GL_INVALID_ENUM on core contexts
+            if (!ok || !gfxInitCore())
+            {
+                SDL_GL_DeleteContext(ctx);
+                ctx = nullptr;
+            }
+        }
+        if (!ctx)
+            std::cerr << "OpenGL 3.3 core unavailable, using the 2.1 renderer.\n";
     }
-    SDL_GL_SetSwapInterval(gConfig.vsync ? 1 : 0);
-
-    glewExperimental = GL_TRUE;
-    if (glewInit() != GLEW_OK)
+    if (!ctx)
     {
-        std::cerr << "GLEW init error\n";
-        SDL_GL_DeleteContext(ctx);
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return 1;
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, 0);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+        ctx = SDL_GL_CreateContext(window);
+        if (!ctx)
+        {
+            std::cerr << "OpenGL context error: " << SDL_GetError() << "\n";
+            SDL_DestroyWindow(window);
+            SDL_Quit();
+            return 1;
+        }
+        glewExperimental = GL_TRUE;
+        if (glewInit() != GLEW_OK)
+        {
+            std::cerr << "GLEW init error\n";
+            SDL_GL_DeleteContext(ctx);
+            SDL_DestroyWindow(window);
+            SDL_Quit();
+            return 1;
+        }
     }
+    SDL_GL_SetSwapInterval(gConfig.vsync ? 1 : 0);
 
     createAtlasTexture();
     GLuint npcTexture = loadTextureFromBMP(assetPath("images/npc_head.bmp"));
@@ -2421,8 +2791,33 @@ int main(int argc, char **argv)
     CHUNK_Z_COUNT = (DEPTH + CHUNK_SIZE - 1) / CHUNK_SIZE;
     chunkMeshes.assign(CHUNK_X_COUNT * CHUNK_Y_COUNT * CHUNK_Z_COUNT, {});
     unsigned seed = static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count());
-    world.generate(seed);
-    markAllChunksDirty();
+    std::string recoveredPath;
+    uint32_t recoveredSeed = 0;
+    if (!replayViewPath.empty() && loadReplay(replayViewPath, gReplay) && replayRestore(world, gReplay))
+    {
+        // no autosave: the world belongs to the replay until something is loaded
+        seed = gReplay.seed;
+        gReplayPlaying = true;
+        markAllChunksDirty();
+        std::cout << "Replay: " << replayViewPath << " (" << gReplay.edits.size() << " modifications)\n";
+    }
+    else if (gConfig.autosaveSeconds > 0.0f && recoverFromJournal(world, gMapsDir.string(), recoveredPath, recoveredSeed))
+    {
+        seed = recoveredSeed;
+        std::cout << "Recuperation: " << recoveredPath << "\n";
+    }
+    else
+    {
+        if (!replayViewPath.empty())
+            std::cerr << "Replay illisible ou d'une autre taille que le monde: " << replayViewPath << "\n";
+        world.generate(seed);
+        markAllChunksDirty();
+        if (gConfig.autosaveSeconds > 0.0f)
+        {
+            // an unsaved world journals against maps/autosave.bulldog, written on its first edit
+            startAutosave(world, (gMapsDir / "autosave.bulldog").string(), false);
+        }
+    }
 
     Player player;
     player.x = WIDTH / 2.0f;
@@ -2484,6 +2879,9 @@ int main(int argc, char **argv)
     float lastSpaceTap = -1.0f;
     bool sprinting = false;
     bool flying = false;
+    std::vector<VisibleChunk> visibleChunks;
+    std::vector<ArenaRange> opaqueRanges;
+    std::vector<GLuint> glassIndices;
     SDL_SetRelativeMouseMode(gMainMenuOpen ? SDL_FALSE : SDL_TRUE);
     SDL_ShowCursor(gMainMenuOpen ? SDL_TRUE : SDL_FALSE);
 
@@ -2505,6 +2903,21 @@ int main(int argc, char **argv)
             fps = fps * 0.9f + (1.0f / dt) * 0.1f; // lissage simple
         }
 
+        std::string savedPath;
+        bool savedOk = false;
+        if (pollAsyncSave(savedPath, savedOk))
+            finishSave(savedPath, savedOk);
+        std::string loadedPath;
+        bool loadedOk = false;
+        if (pumpStreamingLoad(world, loadedPath, loadedOk))
+        {
+            std::cout << (loadedOk ? "Chargement OK: " : "Chargement KO: ") << loadedPath << "\n";
+            if (loadedOk && gConfig.autosaveSeconds > 0.0f)
+                startAutosave(world, loadedPath);
+        }
+        if (!streamingLoadActive())
+            autosaveTick(world, seed, dt, gConfig.autosaveSeconds);
+
         // Applique la souris lissée ici pour stabiliser la camera
         if (!inventoryOpen && !pauseMenuOpen && !gSignEditOpen && !gButtonEditOpen && !gSplitterEditOpen && !gWireInfoOpen && !gClockEditOpen && !gMainMenuOpen && !gSettingsMenuOpen)
         {
@@ -2621,6 +3034,29 @@ int main(int argc, char **argv)
                     SDL_ShowCursor(inventoryOpen ? SDL_TRUE : SDL_FALSE);
                     smoothDX = smoothDY = 0.0f;
                 }
+                else if (e.key.keysym.sym == SDLK_F3)
+                {
+                    gDebugOverlayOpen = !gDebugOverlayOpen;
+                }
+                else if (e.key.keysym.sym == SDLK_F4)
+                {
+                    gWaveformOpen = !gWaveformOpen;
+                }
+                else if (e.key.keysym.sym == SDLK_F6)
+                {
+                    gSimStatsOpen = !gSimStatsOpen;
+                    gSimStatsEnabled = gSimStatsOpen;
+                }
+                else if (e.key.keysym.sym == SDLK_F7)
+                {
+                    if (replayRecording())
+                        saveReplayRecording(world);
+                    else
+                    {
+                        replayStartRecording(world, seed);
+                        std::cout << "Enregistrement du replay (F7 pour arreter)\n";
+                    }
+                }
                 else if (e.key.keysym.sym == SDLK_F11)
                 {
                     Uint32 flags = SDL_GetWindowFlags(window);
@@ -2635,6 +3071,18 @@ int main(int argc, char **argv)
                         SDL_SetWindowFullscreen(window, 0);
                     }
                 }
+                else if (!inventoryOpen && !pauseMenuOpen && !gSignEditOpen && !gButtonEditOpen && !gSplitterEditOpen &&
+                         !gWireInfoOpen && !gClockEditOpen &&
+                         ((e.key.keysym.mod & KMOD_CTRL) ? (e.key.keysym.sym == SDLK_c || e.key.keysym.sym == SDLK_v ||
+                                                            e.key.keysym.sym == SDLK_r || e.key.keysym.sym == SDLK_m ||
+                                                            e.key.keysym.sym == SDLK_z || e.key.keysym.sym == SDLK_y ||
+                                                            e.key.keysym.sym == SDLK_p)
+                                                         : (e.key.keysym.sym == SDLK_b || e.key.keysym.sym == SDLK_p)))
+                {
+                    Vec3 fwd = forwardVec(player.yaw, player.pitch);
+                    HitInfo hit = raycast(world, player.x, player.y + EYE_HEIGHT, player.z, fwd.x, fwd.y, fwd.z, 8.0f);
+                    handleEditKey(e.key.keysym.sym, (e.key.keysym.mod & KMOD_CTRL) != 0, world, hit);
+                }
                 else if (e.key.keysym.sym == SDLK_r && !gSignEditOpen && !gButtonEditOpen && !gSplitterEditOpen && !gWireInfoOpen && !gClockEditOpen)
                 {
                     float spawnX = WIDTH * 0.5f;
@@ -2692,6 +3140,8 @@ int main(int argc, char **argv)
                 }
                 else if (gSignEditOpen && (e.key.keysym.sym == SDLK_RETURN || e.key.keysym.sym == SDLK_KP_ENTER))
                 {
+                    undoRecordCell(world, gSignEditX, gSignEditY, gSignEditZ);
+                    replayNoteCell(gSignEditX, gSignEditY, gSignEditZ);
                     world.setSignText(gSignEditX, gSignEditY, gSignEditZ, gSignEditBuffer);
                     gSignEditOpen = false;
                     SDL_StopTextInput();
@@ -2749,6 +3199,8 @@ int main(int argc, char **argv)
                     v = std::clamp(v, 0, 255);
                     uint8_t mask = width >= 8 ? 0xFFu : static_cast<uint8_t>((1u << width) - 1u);
                     v &= mask;
+                    undoRecordCell(world, gButtonEditX, gButtonEditY, gButtonEditZ);
+                    replayNoteCell(gButtonEditX, gButtonEditY, gButtonEditZ);
                     world.setButtonWidth(gButtonEditX, gButtonEditY, gButtonEditZ, static_cast<uint8_t>(width));
                     world.setButtonValue(gButtonEditX, gButtonEditY, gButtonEditZ, static_cast<uint8_t>(v));
                     gButtonEditOpen = false;
@@ -2767,6 +3219,8 @@ int main(int argc, char **argv)
                         width = 1;
                     }
                     width = std::clamp(width, 1, 7);
+                    undoRecordCell(world, gSplitterX, gSplitterY, gSplitterZ);
+                    replayNoteCell(gSplitterX, gSplitterY, gSplitterZ);
                     world.setSplitterWidth(gSplitterX, gSplitterY, gSplitterZ, static_cast<uint8_t>(width));
                     world.setSplitterOrder(gSplitterX, gSplitterY, gSplitterZ, gSplitterOrder ? 1 : 0);
                     gSplitterEditOpen = false;
@@ -2787,6 +3241,8 @@ int main(int argc, char **argv)
                         freq = 1;
                     }
                     freq = std::clamp(freq, 1, 255);
+                    undoRecordCell(world, gClockEditX, gClockEditY, gClockEditZ);
+                    replayNoteCell(gClockEditX, gClockEditY, gClockEditZ);
                     world.setClockFreq(gClockEditX, gClockEditY, gClockEditZ, static_cast<uint8_t>(freq));
                     gClockEditOpen = false;
                     SDL_StopTextInput();
@@ -2838,6 +3294,12 @@ int main(int argc, char **argv)
                     Vec3 fwd = forwardVec(player.yaw, player.pitch);
                     float eyeY = player.y + EYE_HEIGHT;
                     HitInfo hit = raycast(world, player.x, eyeY, player.z, fwd.x, fwd.y, fwd.z, 8.0f);
+                    BlockType target = hit.hit ? world.get(hit.x, hit.y, hit.z) : BlockType::Air;
+                    // the settings dialogs edit the block; the wire readout only reads it
+                    if ((target == BlockType::Button || target == BlockType::Splitter || target == BlockType::Merger ||
+                         target == BlockType::Clock) &&
+                        blockedByLoad())
+                        hit.hit = false;
                     if (hit.hit && world.get(hit.x, hit.y, hit.z) == BlockType::Button)
                     {
                         gButtonEditOpen = true;
@@ -3148,14 +3610,8 @@ int main(int argc, char **argv)
                         if (hoverCreate)
                         {
                             std::string path = buildSavePathFromInput(gSaveNameInput);
-                            bool ok = saveWorldToFile(world, path, seed);
-                            std::cout << (ok ? "Sauvegarde OK: " : "Sauvegarde KO: ") << path << "\n";
-                            if (ok)
+                            if (beginSave(world, path, seed))
                             {
-                                refreshSaveList();
-                                int idx = findSaveIndexByStem(stemFromPath(path));
-                                if (idx >= 0)
-                                    gSaveIndex = idx;
                                 gSaveNameInput = normalizeSaveInput(stemFromPath(path));
                                 gSaveInputFocus = false;
                             }
@@ -3167,14 +3623,7 @@ int main(int argc, char **argv)
                                 path = gSaveList[gSaveIndex];
                             else
                                 path = timestampSaveName();
-                            bool ok = saveWorldToFile(world, path, seed);
-                            std::cout << (ok ? "Sauvegarde OK: " : "Sauvegarde KO: ") << path << "\n";
-                            if (ok)
-                            {
-                                refreshSaveList();
-                                if (!gSaveList.empty())
-                                    gSaveIndex = 0;
-                            }
+                            beginSave(world, path, seed);
                         }
                         else if (hoverLoad)
                         {
@@ -3182,16 +3631,29 @@ int main(int argc, char **argv)
                             {
                                 std::string path = gSaveList[gSaveIndex];
                                 uint32_t newSeed = seed;
-                                bool ok = loadWorldFromFile(world, path, newSeed);
+                                // the recording ends with the world it started on
+                                if (replayRecording())
+                                    saveReplayRecording(world);
+                                gReplayPlaying = false;
+                                // chunked files stream in around the spawn column; the rest finishes in the main loop
+                                bool streaming = false;
+                                bool ok = (gConfig.mappedSaves && mapWorldFile(world, path, newSeed)) ||
+                                          (streaming = beginStreamingLoad(world, path, WIDTH / 2, DEPTH / 2, newSeed)) ||
+                                          loadWorldFromFile(world, path, newSeed);
                                 if (ok)
                                 {
                                     seed = newSeed;
+                                    undoClear();
+                                    probeClear();
+                                    if (gConfig.autosaveSeconds > 0.0f && !world.denseStorageBound() && !streaming)
+                                        startAutosave(world, path);
                                     player.x = WIDTH * 0.5f;
                                     player.z = DEPTH * 0.5f;
                                     player.y =
                                         world.surfaceY(static_cast<int>(player.x), static_cast<int>(player.z)) + 0.2f;
                                 }
-                                std::cout << (ok ? "Chargement OK: " : "Chargement KO: ") << path << "\n";
+                                if (!streaming)
+                                    std::cout << (ok ? "Chargement OK: " : "Chargement KO: ") << path << "\n";
                             }
                         }
                         else if (hoverBack)
@@ -3272,13 +3734,15 @@ int main(int argc, char **argv)
                     Vec3 fwd = forwardVec(player.yaw, player.pitch);
                     float eyeY = player.y + EYE_HEIGHT;
                     HitInfo hit = raycast(world, player.x, eyeY, player.z, fwd.x, fwd.y, fwd.z, 8.0f);
-                    if (hit.hit)
+                    if (hit.hit && !blockedByLoad())
                     {
                         if (e.button.button == SDL_BUTTON_LEFT)
                         {
                             BlockType bt = world.get(hit.x, hit.y, hit.z);
                             if (bt != BlockType::Air && bt != BlockType::Water)
                             {
+                                undoRecordCell(world, hit.x, hit.y, hit.z);
+                                replayNoteCell(hit.x, hit.y, hit.z);
                                 world.set(hit.x, hit.y, hit.z, BlockType::Air);
                                 markNeighborsDirty(hit.x, hit.y, hit.z);
                             }
@@ -3297,6 +3761,7 @@ int main(int argc, char **argv)
                             }
                             else if (target == BlockType::Button)
                             {
+                                replayNoteCell(hit.x, hit.y, hit.z);
                                 world.toggleButton(hit.x, hit.y, hit.z);
                             }
                             else
@@ -3311,6 +3776,8 @@ int main(int argc, char **argv)
                                     if (slot.type != BlockType::Air)
                                     {
                                         BlockType toPlace = slot.type;
+                                        undoRecordCell(world, nx, ny, nz);
+                                        replayNoteCell(nx, ny, nz);
                                         world.set(nx, ny, nz, toPlace);
                                         markNeighborsDirty(nx, ny, nz);
                                     }
@@ -3444,7 +3911,26 @@ int main(int argc, char **argv)
         updateNpc(npc, world, simDt);
         updateNpc(npc2, world, simDt);
         updateNpc(npc3, world, simDt);
-        updateLogic(world);
+        // a partly streamed circuit would settle into wrong states
+        if (!streamingLoadActive())
+        {
+            // this frame's edits, stamped with the tick they come before
+            replayCapture(world);
+            if (gReplayPlaying && !replayApply(world, gReplay, gReplayCursor))
+            {
+                gReplayPlaying = false;
+                std::cout << "Replay termine\n";
+            }
+            // a settled world sleeps until its next Clock edge: this frame's tick passes without an evaluation
+            if (world.skipSettledTicks(1) == 0)
+                updateLogic(world);
+            else if (gSimStatsEnabled)
+            {
+                gSimStats = SimStats{};
+                gSimStats.skipped = true;
+            }
+            probeCapture(world);
+        }
 
         glClearColor(0.55f, 0.75f, 0.95f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -3483,92 +3969,51 @@ int main(int argc, char **argv)
                 drawSettingsMenu(winW, winH, s, gConfig, hoverBack, hoverMinus, hoverPlus, hoverFps, hoverFullscreen);
             }
             endHud();
+            gfxFlush();
             SDL_GL_SwapWindow(window);
             updateTitle(window);
             continue;
         }
 
-        glLoadIdentity();
         Vec3 fwdView = forwardVec(player.yaw, player.pitch);
-        gluLookAt(player.x, player.y + EYE_HEIGHT, player.z, player.x + fwdView.x, player.y + EYE_HEIGHT + fwdView.y,
-                  player.z + fwdView.z, 0.0f, 1.0f, 0.0f);
+        gfxSetView(mat4LookAt(player.x, player.y + EYE_HEIGHT, player.z, player.x + fwdView.x,
+                              player.y + EYE_HEIGHT + fwdView.y, player.z + fwdView.z, 0.0f, 1.0f, 0.0f));
 
         drawSkybox(skyboxTex, 160.0f);
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gfxEnable(GL_BLEND);
+        gfxBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-        glEnableClientState(GL_VERTEX_ARRAY);
-        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-        glEnableClientState(GL_COLOR_ARRAY);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, gAtlasTex);
         const float chunkView = 56.0f;
-        for (int cY = 0; cY < CHUNK_Y_COUNT; ++cY)
+        const float eyeYView = player.y + EYE_HEIGHT;
+        Frustum frustum = frustumFromMatrix(mat4Multiply(gfxProjection(), gfxView()));
+        gatherVisibleChunks(player.x, eyeYView, player.z, frustum, chunkView, visibleChunks);
+        processRemeshQueue(world, gConfig.remeshBudgetMs);
+        gfxBeginChunkPass(gAtlasTex);
+        opaqueRanges.clear();
+        for (const VisibleChunk &vc : visibleChunks)
         {
-            for (int cZ = 0; cZ < CHUNK_Z_COUNT; ++cZ)
-            {
-                for (int cX = 0; cX < CHUNK_X_COUNT; ++cX)
-                {
-                    float cxCenter = (cX + 0.5f) * CHUNK_SIZE;
-                    float cyCenter = (cY + 0.5f) * CHUNK_SIZE;
-                    float czCenter = (cZ + 0.5f) * CHUNK_SIZE;
-                    float dx = cxCenter - player.x;
-                    float dy = cyCenter - player.y;
-                    float dz = czCenter - player.z;
-                    if (dx * dx + dy * dy + dz * dz > chunkView * chunkView)
-                        continue;
-                    int idx = chunkIndex(cX, cY, cZ);
-                    if (idx < 0)
-                        continue;
-                    ChunkMesh &cm = chunkMeshes[idx];
-                    if (cm.dirty)
-                    {
-                        buildChunkMesh(world, cX, cY, cZ);
-                    }
-                    if (cm.verts.empty() || cm.vbo == 0)
-                        continue;
-                    glBindBuffer(GL_ARRAY_BUFFER, cm.vbo);
-                    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void *>(0));
-                    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void *>(sizeof(float) * 3));
-                    glColorPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void *>(sizeof(float) * 5));
-                    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(cm.verts.size()));
-                }
-            }
+            const ChunkMesh &cm = chunkMeshes[vc.idx];
+            if (cm.range.count > 0)
+                opaqueRanges.push_back(cm.range);
         }
-        // Glass pass
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gfxDrawChunkRanges(opaqueRanges);
+        // Glass pass: back-to-front over the same visible set, faces sorted within each chunk
         glDepthMask(GL_FALSE);
-        for (int cY = 0; cY < CHUNK_Y_COUNT; ++cY)
+        glassIndices.clear();
+        for (auto it = visibleChunks.rbegin(); it != visibleChunks.rend(); ++it)
         {
-            for (int cZ = 0; cZ < CHUNK_Z_COUNT; ++cZ)
-            {
-                for (int cX = 0; cX < CHUNK_X_COUNT; ++cX)
-                {
-                    int idx = chunkIndex(cX, cY, cZ);
-                    if (idx < 0)
-                        continue;
-                    const ChunkMesh &cm = chunkMeshes[idx];
-                    if (cm.glassVerts.empty())
-                        continue;
-                    glBindBuffer(GL_ARRAY_BUFFER, cm.glassVbo);
-                    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void *>(0));
-                    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void *>(sizeof(float) * 3));
-                    glColorPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void *>(sizeof(float) * 5));
-                    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(cm.glassVerts.size()));
-                }
-            }
+            ChunkMesh &cm = chunkMeshes[it->idx];
+            if (cm.glassRange.count == 0)
+                continue;
+            sortGlassFaces(cm, player.x, eyeYView, player.z);
+            for (GLuint i : cm.glassOrder)
+                glassIndices.push_back(static_cast<GLuint>(cm.glassRange.first) + i);
         }
+        gfxDrawArenaTriangles(glassIndices);
+        gfxEndChunkPass();
         glDepthMask(GL_TRUE);
-        glDisable(GL_BLEND);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glDisable(GL_TEXTURE_2D);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glDisableClientState(GL_COLOR_ARRAY);
-        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-        glDisableClientState(GL_VERTEX_ARRAY);
+        gfxDisable(GL_BLEND);
 
         // NPC blocky models
         drawNpcBlocky(npc);
@@ -3576,7 +4021,7 @@ int main(int argc, char **argv)
         drawNpcBlocky(npc3);
 
         // bouton 0/1 affiché directement sur le bloc proche du joueur
-        drawButtonStateLabels(world, player, 10.0f);
+        drawButtonStateLabels(world, player, 24.0f);
 
         Vec3 fwdCast = forwardVec(player.yaw, player.pitch);
         float eyeY = player.y + EYE_HEIGHT;
@@ -3586,19 +4031,55 @@ int main(int argc, char **argv)
         {
             drawFaceHighlight(hit);
         }
+        if (gSelectionCorners > 0)
+            drawRegionOutline(std::min(gSelA[0], gSelB[0]), std::min(gSelA[1], gSelB[1]), std::min(gSelA[2], gSelB[2]),
+                              std::max(gSelA[0], gSelB[0]) + 1, std::max(gSelA[1], gSelB[1]) + 1,
+                              std::max(gSelA[2], gSelB[2]) + 1, 0.3f, 0.85f, 1.0f);
+        // paste preview while Ctrl is held
+        if (hit.hit && !gClipboard.empty() && (SDL_GetModState() & KMOD_CTRL))
+        {
+            int px = hit.x + hit.nx, py = hit.y + hit.ny, pz = hit.z + hit.nz;
+            drawRegionOutline(px, py, pz, px + gClipboard.nx, py + gClipboard.ny, pz + gClipboard.nz, 0.4f, 1.0f, 0.45f);
+        }
+        static std::vector<ProbeTrace> probeTraceRows;
+        probeTraceRows.clear();
+        if (probeCount() > 0)
+            probeTraces(probeTick() > WAVEFORM_TICKS ? probeTick() - WAVEFORM_TICKS : 0, probeTraceRows);
+        for (const ProbeTrace &t : probeTraceRows)
+            drawRegionOutline(t.x, t.y, t.z, t.x + 1, t.y + 1, t.z + 1, 1.0f, 0.85f, 0.2f);
 
         beginHud(winW, winH);
         if (gConfig.showFps)
         {
             char fpsBuf[32];
             std::snprintf(fpsBuf, sizeof(fpsBuf), "FPS: %.0f", fps);
-            drawQuad(10.0f, 10.0f, 120.0f, 32.0f, 0.04f, 0.04f, 0.06f, 0.65f);
-            drawOutline(10.0f, 10.0f, 120.0f, 32.0f, 1.0f, 1.0f, 1.0f, 0.12f, 2.0f);
-            drawTextTiny(16.0f, 16.0f, 2.4f, fpsBuf, 1.0f, 0.97f, 0.9f, 1.0f);
+            if (hudBeginWidget("fps", fpsBuf))
+            {
+                drawQuad(10.0f, 10.0f, 120.0f, 32.0f, 0.04f, 0.04f, 0.06f, 0.65f);
+                drawOutline(10.0f, 10.0f, 120.0f, 32.0f, 1.0f, 1.0f, 1.0f, 0.12f, 2.0f);
+                drawTextTiny(16.0f, 16.0f, 2.4f, fpsBuf, 1.0f, 0.97f, 0.9f, 1.0f);
+            }
+            hudEndWidget();
         }
+        if (gDebugOverlayOpen)
+            drawDebugOverlay(gConfig.showFps ? 48.0f : 10.0f);
+        if (gSimStatsOpen)
+            drawSimStatsPanel(gConfig.showFps || gDebugOverlayOpen ? 320.0f : 10.0f, 10.0f);
+        if (gWaveformOpen)
+            drawWaveformPanel(winW, winH, probeTraceRows);
+        std::string winKey = std::to_string(winW) + "x" + std::to_string(winH);
         if (!inventoryOpen && !pauseMenuOpen)
-            drawCrosshair(winW, winH);
-        drawInventoryBar(winW, winH, hotbarSlots, selected);
+        {
+            if (hudBeginWidget("crosshair", winKey))
+                drawCrosshair(winW, winH);
+            hudEndWidget();
+        }
+        std::string hotbarKey = winKey + ":" + std::to_string(selected);
+        for (const ItemStack &slot : hotbarSlots)
+            hotbarKey += "," + std::to_string(static_cast<int>(slot.type)) + "/" + std::to_string(slot.count);
+        if (hudBeginWidget("hotbar", hotbarKey))
+            drawInventoryBar(winW, winH, hotbarSlots, selected);
+        hudEndWidget();
         if (inventoryOpen)
             drawInventoryPanel(winW, winH, inventorySlots, hotbarSlots, pendingSlot, pendingIsHotbar, mouseX, mouseY,
                                hoverLabel);
@@ -3672,10 +4153,13 @@ int main(int argc, char **argv)
             drawSplitterEditBox(winW, winH, gSplitterIsMerger, gSplitterWidthBuffer, gSplitterOrder);
         endHud();
 
+        gfxFlush();
         SDL_GL_SwapWindow(window);
         updateTitle(window);
     }
 
+    stopAutosave(world, seed);
+    gfxShutdown();
     SDL_GL_DeleteContext(ctx);
     SDL_DestroyWindow(window);
     SDL_Quit();
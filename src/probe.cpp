@@ -0,0 +1,250 @@
+#include "probe.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+struct Probe
+{
+    int x = 0, y = 0, z = 0;
+    uint8_t value = 0, width = 1;         // last captured
+    uint8_t baseValue = 0, baseWidth = 1; // at startTick
+};
+
+struct ProbeChange
+{
+    uint64_t tick;
+    uint16_t probe;
+    uint8_t value;
+    uint8_t width;
+    uint8_t previous; // value before the change, so the panel can read the ring backwards
+};
+
+// 16 bytes per change, 1 MB in all
+constexpr size_t PROBE_RING_SIZE = size_t{1} << 16;
+
+struct ProbeCapture
+{
+    std::vector<Probe> probes;
+    std::vector<ProbeChange> ring; // sized once, on the first attach
+    size_t head = 0;               // oldest change
+    size_t count = 0;
+    uint64_t tick = 0;
+    uint64_t startTick = 0; // first tick the capture knows every probe's value at
+};
+static ProbeCapture gProbes;
+
+static void restartCapture(const World &world)
+{
+    if (gProbes.ring.empty())
+        gProbes.ring.resize(PROBE_RING_SIZE);
+    gProbes.head = 0;
+    gProbes.count = 0;
+    gProbes.startTick = gProbes.tick;
+    for (Probe &p : gProbes.probes)
+    {
+        p.value = p.baseValue = world.getPower(p.x, p.y, p.z);
+        p.width = p.baseWidth = world.getPowerWidth(p.x, p.y, p.z);
+    }
+}
+
+bool probeToggle(const World &world, int x, int y, int z)
+{
+    if (!world.inside(x, y, z))
+        return false;
+    auto it = std::find_if(gProbes.probes.begin(), gProbes.probes.end(),
+                           [&](const Probe &p) { return p.x == x && p.y == y && p.z == z; });
+    if (it != gProbes.probes.end())
+        gProbes.probes.erase(it);
+    else if (gProbes.probes.size() < MAX_PROBES)
+    {
+        Probe p;
+        p.x = x;
+        p.y = y;
+        p.z = z;
+        gProbes.probes.push_back(p);
+    }
+    else
+        return false;
+    restartCapture(world);
+    return true;
+}
+
+void probeClear()
+{
+    gProbes.probes.clear();
+    gProbes.head = 0;
+    gProbes.count = 0;
+    gProbes.tick = 0;
+    gProbes.startTick = 0;
+}
+
+int probeCount() { return static_cast<int>(gProbes.probes.size()); }
+
+uint64_t probeTick() { return gProbes.tick; }
+
+static void pushChange(const ProbeChange &change)
+{
+    const size_t size = gProbes.ring.size();
+    if (gProbes.count == size)
+    {
+        // the oldest change becomes its probe's starting value
+        const ProbeChange &oldest = gProbes.ring[gProbes.head];
+        Probe &p = gProbes.probes[oldest.probe];
+        p.baseValue = oldest.value;
+        p.baseWidth = oldest.width;
+        gProbes.startTick = oldest.tick;
+        gProbes.head = (gProbes.head + 1) % size;
+        --gProbes.count;
+    }
+    gProbes.ring[(gProbes.head + gProbes.count) % size] = change;
+    ++gProbes.count;
+}
+
+void probeCapture(const World &world)
+{
+    if (gProbes.probes.empty())
+        return;
+    const uint64_t tick = ++gProbes.tick;
+    for (size_t i = 0; i < gProbes.probes.size(); ++i)
+    {
+        Probe &p = gProbes.probes[i];
+        const uint8_t value = world.getPower(p.x, p.y, p.z);
+        const uint8_t width = world.getPowerWidth(p.x, p.y, p.z);
+        if (value == p.value && width == p.width)
+            continue;
+        pushChange({tick, static_cast<uint16_t>(i), value, width, p.value});
+        p.value = value;
+        p.width = width;
+    }
+}
+
+// Calls visit(change) for every change in the ring, oldest first
+template <typename Visit> static void forEachChange(Visit visit)
+{
+    const size_t size = gProbes.ring.size();
+    for (size_t i = 0; i < gProbes.count; ++i)
+        visit(gProbes.ring[(gProbes.head + i) % size]);
+}
+
+void probeTraces(uint64_t from, std::vector<ProbeTrace> &out)
+{
+    // newest change first, down to `from`: only the changes on screen are read, however full the ring is
+    from = std::max(from, gProbes.startTick);
+    const size_t n = gProbes.probes.size();
+    out.resize(n);
+    std::vector<uint8_t> value(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Probe &p = gProbes.probes[i];
+        out[i].x = p.x;
+        out[i].y = p.y;
+        out[i].z = p.z;
+        out[i].width = p.width;
+        out[i].changes.clear();
+        value[i] = p.value;
+    }
+    const size_t size = gProbes.ring.size();
+    for (size_t i = gProbes.count; i-- > 0;)
+    {
+        const ProbeChange &c = gProbes.ring[(gProbes.head + i) % size];
+        if (c.tick <= from)
+            break;
+        out[c.probe].changes.emplace_back(c.tick, c.value);
+        value[c.probe] = c.previous;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i].changes.emplace_back(from, value[i]);
+        std::reverse(out[i].changes.begin(), out[i].changes.end());
+    }
+}
+
+// Short identifiers from the printable range, as VCD expects
+static std::string vcdId(size_t i)
+{
+    std::string id;
+    do
+    {
+        id.push_back(static_cast<char>('!' + i % 94));
+        i /= 94;
+    } while (i > 0);
+    return id;
+}
+
+static void writeVcdValue(std::ofstream &out, uint8_t value, int bits, const std::string &id)
+{
+    if (bits == 1)
+    {
+        out << ((value & 1) ? '1' : '0') << id << '\n';
+        return;
+    }
+    out << 'b';
+    for (int b = bits - 1; b >= 0; --b)
+        out << (((value >> b) & 1) ? '1' : '0');
+    out << ' ' << id << '\n';
+}
+
+bool probeWriteVcd(const std::string &path)
+{
+    if (gProbes.probes.empty())
+        return false;
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+        return false;
+
+    // declared width: the widest the probe was during the capture
+    const size_t n = gProbes.probes.size();
+    std::vector<int> bits(n);
+    std::vector<uint8_t> value(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        bits[i] = std::max<int>(1, gProbes.probes[i].baseWidth);
+        value[i] = gProbes.probes[i].baseValue;
+    }
+    forEachChange([&](const ProbeChange &c) { bits[c.probe] = std::max<int>(bits[c.probe], c.width); });
+    for (int &b : bits)
+        b = std::min(b, 8);
+
+    out << "$version Logicraft $end\n";
+    out << "$comment one time unit is one logic tick $end\n";
+    out << "$timescale 1 ns $end\n";
+    out << "$scope module world $end\n";
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Probe &p = gProbes.probes[i];
+        out << "$var wire " << bits[i] << ' ' << vcdId(i) << " x" << p.x << "_y" << p.y << "_z" << p.z;
+        if (bits[i] > 1)
+            out << " [" << bits[i] - 1 << ":0]";
+        out << " $end\n";
+    }
+    out << "$upscope $end\n$enddefinitions $end\n";
+
+    // changes on the first tick belong in the initial dump
+    const size_t size = gProbes.ring.size();
+    size_t i = 0;
+    for (; i < gProbes.count; ++i)
+    {
+        const ProbeChange &c = gProbes.ring[(gProbes.head + i) % size];
+        if (c.tick > gProbes.startTick)
+            break;
+        value[c.probe] = c.value;
+    }
+    out << '#' << gProbes.startTick << "\n$dumpvars\n";
+    for (size_t p = 0; p < n; ++p)
+        writeVcdValue(out, value[p], bits[p], vcdId(p));
+    out << "$end\n";
+    uint64_t tick = gProbes.startTick;
+    for (; i < gProbes.count; ++i)
+    {
+        const ProbeChange &c = gProbes.ring[(gProbes.head + i) % size];
+        if (c.tick != tick)
+        {
+            tick = c.tick;
+            out << '#' << tick << '\n';
+        }
+        writeVcdValue(out, c.value, bits[c.probe], vcdId(c.probe));
+    }
+    if (tick < gProbes.tick)
+        out << '#' << gProbes.tick << '\n';
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "world.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Waveform probes on the power value of chosen cells. Each logic tick probeCapture compares every probe with its
+// last value and appends only the changes (tick, probe, value, width) to a ring buffer allocated once, when the
+// first probe is attached; when the ring is full the oldest changes are folded into each probe's starting value,
+// so the capture always covers a contiguous window of ticks. Attaching or removing a probe restarts the capture.
+// With no probe attached probeCapture returns before reading the world.
+constexpr int MAX_PROBES = 32;
+
+// Attaches a probe on (x, y, z), or removes the one already there. False if the cell is outside the world or all
+// MAX_PROBES are in use.
+bool probeToggle(const World &world, int x, int y, int z);
+// Removes every probe (another world was loaded)
+void probeClear();
+int probeCount();
+// Once per logic tick, after updateLogic
+void probeCapture(const World &world);
+// Ticks captured since the first probe was attached
+uint64_t probeTick();
+
+// One probe's value over [from, probeTick()]: changes[0] is the value at `from` (or at the start of the capture
+// when it is later), then one (tick, value) pair per change. width is the probe's current bus width.
+struct ProbeTrace
+{
+    int x = 0, y = 0, z = 0;
+    uint8_t width = 1;
+    std::vector<std::pair<uint64_t, uint8_t>> changes;
+};
+void probeTraces(uint64_t from, std::vector<ProbeTrace> &out);
+
+// Writes the whole capture as a Value Change Dump, one time unit per logic tick. False if there is no probe or
+// the file could not be written.
+bool probeWriteVcd(const std::string &path);
@@ -1,5 +1,7 @@
 #include "render.hpp"
 
+#include "gfx.hpp"
+
 #include <SDL2/SDL.h>
 #include <algorithm>
 #include <array>
@@ -13,36 +15,32 @@ int CHUNK_X_COUNT = 0;
 int CHUNK_Y_COUNT = 0;
 int CHUNK_Z_COUNT = 0;
 std::vector<ChunkMesh> chunkMeshes;
+// Fractions of the view distance where chunks switch to / back from their LOD mesh
+static const float LOD_ENTER_FRACTION = 0.7f;
+static const float LOD_LEAVE_FRACTION = 0.6f;
+
+// Chunks waiting for a rebuild, refilled by gatherVisibleChunks and drained by processRemeshQueue
+struct RemeshRequest
+{
+    int idx;
+    float dist2;
+    bool visible; // reached by the visibility walk; everything else in range waits behind these
+    bool lod;
+};
+static std::vector<RemeshRequest> gRemeshQueue;
 GLuint gAtlasTex = 0;
 const int ATLAS_COLS = 4;
-const int ATLAS_ROWS = 13; // increased to fit new gate tiles
+const int ATLAS_ROWS = 15; // increased to fit new gate tiles and sign glyphs
 const int ATLAS_TILE_SIZE = 32;
-std::map<BlockType, int> gBlockTile;
-int gAndTopTile = 0;
-int gOrTopTile = 0;
-int gNotTopTile = 0;
-int gXorTopTile = 0;
-int gDffTopTile = 0;
-int gAddTopTile = 0;
-int gAddBottomTile = 0;
-int gAddBackTile = 0;
-int gCounterTopTile = 0;
-int gSplitterTopTile = 0;
-int gMergerTopTile = 0;
-int gDecoderTopTile = 0;
-int gMuxTopTile = 0;
-int gMuxInTile[4] = {0, 0, 0, 0};
-int gComparatorTopTile = 0;
-int gComparatorInLeftTile = 0;
-int gComparatorInRightTile = 0;
-int gComparatorGtTile = 0;
-int gComparatorEqTile = 0;
-int gComparatorLtTile = 0;
-int gClockTopTile = 0;
-int gGrassTopTile = 0;
+int gGlyphTileBase = 0;           // first of the tiles holding the sign font
+std::array<int, 256> gGlyphCell{}; // FONT5x4 char -> glyph cell (16 cells of 8x8 per tile), -1 if none
+int gWhiteCell = 0;                // solid white cell, sampled by untextured HUD geometry
+const int GLYPH_CELL_SIZE = 8;
+const int GLYPHS_PER_TILE = (ATLAS_TILE_SIZE / GLYPH_CELL_SIZE) * (ATLAS_TILE_SIZE / GLYPH_CELL_SIZE);
 const int MAX_STACK = 64;
 const int INV_COLS = 7;
 const int INV_ROWS = 4;
+ChunkDrawStats gChunkStats;
 
 int chunkIndex(int cx, int cy, int cz)
 {
@@ -57,14 +55,16 @@ void markAllChunksDirty()
         c.dirty = true;
 }
 
-void markChunkFromBlock(int x, int y, int z)
+bool markChunkFromBlock(int x, int y, int z)
 {
     int cx = x / CHUNK_SIZE;
     int cy = y / CHUNK_SIZE;
     int cz = z / CHUNK_SIZE;
     int idx = chunkIndex(cx, cy, cz);
-    if (idx >= 0)
-        chunkMeshes[idx].dirty = true;
+    if (idx < 0 || chunkMeshes[idx].dirty)
+        return false;
+    chunkMeshes[idx].dirty = true;
+    return true;
 }
 
 void markNeighborsDirty(int x, int y, int z)
@@ -76,20 +76,9 @@ void markNeighborsDirty(int x, int y, int z)
     }
 }
 
-void ensureVbo(GLuint &vbo)
-{
-    if (vbo == 0)
-    {
-        glGenBuffers(1, &vbo);
-    }
-}
-
 int tileIndexFor(BlockType b)
 {
-    auto it = gBlockTile.find(b);
-    if (it != gBlockTile.end())
-        return it->second;
-    return gBlockTile[BlockType::Air];
+    return blockTraits(b).tile;
 }
 
 void writePixel(std::vector<uint8_t> &pix, int texW, int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
@@ -754,6 +743,40 @@ GLuint loadCubemapFromBMP(const std::array<std::string, 6> &paths)
     return tex;
 }
 
+// Skybox cube: {cubemap direction xyz, position xyz} on a unit cube, 4 vertices per face
+static const float SKY_VERTS[24][6] = {
+    // +X (Right) rotated 90° CW (roll)
+    {1.0f, 1.0f, -1.0f, 1.0f, -1.0f, -1.0f},
+    {1.0f, -1.0f, -1.0f, 1.0f, -1.0f, 1.0f},
+    {1.0f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+    {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, -1.0f},
+    // -X (Left) rotated -90°
+    {-1.0f, 1.0f, -1.0f, -1.0f, -1.0f, 1.0f},
+    {-1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f},
+    {-1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f},
+    {-1.0f, -1.0f, -1.0f, -1.0f, 1.0f, 1.0f},
+    // +Y (Top)
+    {-1.0f, 1.0f, -1.0f, -1.0f, 1.0f, -1.0f},
+    {1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f},
+    {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+    {-1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1.0f},
+    // -Y (Bottom) rotated 180°
+    {1.0f, -1.0f, -1.0f, -1.0f, -1.0f, 1.0f},
+    {-1.0f, -1.0f, -1.0f, 1.0f, -1.0f, 1.0f},
+    {-1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f},
+    {1.0f, -1.0f, 1.0f, -1.0f, -1.0f, -1.0f},
+    // +Z (Front)
+    {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f},
+    {-1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1.0f},
+    {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+    {1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f},
+    // -Z (Back) rotated 180°
+    {-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, -1.0f},
+    {-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f},
+    {1.0f, -1.0f, -1.0f, -1.0f, 1.0f, -1.0f},
+    {1.0f, 1.0f, -1.0f, -1.0f, -1.0f, -1.0f},
+};
+
 void drawSkybox(GLuint cubemap, float size)
 {
     if (cubemap == 0)
@@ -761,6 +784,12 @@ void drawSkybox(GLuint cubemap, float size)
 
     float half = size * 0.5f;
 
+    if (gGfxBackend == GfxBackend::Core)
+    {
+        gfxDrawSky(cubemap, half, &SKY_VERTS[0][0], 24);
+        return;
+    }
+
     GLboolean depthEnabled = glIsEnabled(GL_DEPTH_TEST);
     GLboolean cullEnabled = glIsEnabled(GL_CULL_FACE);
     GLboolean tex2DEnabled = glIsEnabled(GL_TEXTURE_2D);
@@ -786,65 +815,11 @@ void drawSkybox(GLuint cubemap, float size)
     glLoadMatrixf(viewMat);
 
     glBegin(GL_QUADS);
-    // +X (Right) rotated 90° CW (roll)
-    glTexCoord3f(half, half, -half);
-    glVertex3f(half, -half, -half);
-    glTexCoord3f(half, -half, -half);
-    glVertex3f(half, -half, half);
-    glTexCoord3f(half, -half, half);
-    glVertex3f(half, half, half);
-    glTexCoord3f(half, half, half);
-    glVertex3f(half, half, -half);
-
-    // -X (Left) rotated -90°
-    glTexCoord3f(-half, half, -half);
-    glVertex3f(-half, -half, half);
-    glTexCoord3f(-half, half, half);
-    glVertex3f(-half, -half, -half);
-    glTexCoord3f(-half, -half, half);
-    glVertex3f(-half, half, -half);
-    glTexCoord3f(-half, -half, -half);
-    glVertex3f(-half, half, half);
-
-    // +Y (Top)
-    glTexCoord3f(-half, half, -half);
-    glVertex3f(-half, half, -half);
-    glTexCoord3f(half, half, -half);
-    glVertex3f(half, half, -half);
-    glTexCoord3f(half, half, half);
-    glVertex3f(half, half, half);
-    glTexCoord3f(-half, half, half);
-    glVertex3f(-half, half, half);
-
-    // -Y (Bottom) rotated 180°
-    glTexCoord3f(half, -half, -half);
-    glVertex3f(-half, -half, half);
-    glTexCoord3f(-half, -half, -half);
-    glVertex3f(half, -half, half);
-    glTexCoord3f(-half, -half, half);
-    glVertex3f(half, -half, -half);
-    glTexCoord3f(half, -half, half);
-    glVertex3f(-half, -half, -half);
-
-    // +Z (Front)
-    glTexCoord3f(-half, -half, half);
-    glVertex3f(-half, -half, half);
-    glTexCoord3f(-half, half, half);
-    glVertex3f(-half, half, half);
-    glTexCoord3f(half, half, half);
-    glVertex3f(half, half, half);
-    glTexCoord3f(half, -half, half);
-    glVertex3f(half, -half, half);
-
-    // -Z (Back) rotated 180°
-    glTexCoord3f(-half, half, -half);
-    glVertex3f(half, -half, -half);
-    glTexCoord3f(-half, -half, -half);
-    glVertex3f(half, half, -half);
-    glTexCoord3f(half, -half, -half);
-    glVertex3f(-half, half, -half);
-    glTexCoord3f(half, half, -half);
-    glVertex3f(-half, -half, -half);
+    for (const auto &v : SKY_VERTS)
+    {
+        glTexCoord3f(v[0] * half, v[1] * half, v[2] * half);
+        glVertex3f(v[3] * half, v[4] * half, v[5] * half);
+    }
     glEnd();
 
     glPopMatrix();
@@ -859,86 +834,52 @@ void drawSkybox(GLuint cubemap, float size)
         glEnable(GL_DEPTH_TEST);
     glDepthMask(GL_TRUE);
 }
+// Atlas texel of the top-left corner of glyph cell `cell`
+static void glyphCellOrigin(int cell, int &texX, int &texY)
+{
+    int tileIdx = gGlyphTileBase + cell / GLYPHS_PER_TILE;
+    int inTile = cell % GLYPHS_PER_TILE;
+    int cellsPerRow = ATLAS_TILE_SIZE / GLYPH_CELL_SIZE;
+    texX = (tileIdx % ATLAS_COLS) * ATLAS_TILE_SIZE + (inTile % cellsPerRow) * GLYPH_CELL_SIZE;
+    texY = (tileIdx / ATLAS_COLS) * ATLAS_TILE_SIZE + (inTile / cellsPerRow) * GLYPH_CELL_SIZE;
+}
+
+bool atlasGlyphRect(char c, float &u0, float &v0, float &u1, float &v1)
+{
+    int cell = gGlyphCell[static_cast<unsigned char>(c)];
+    if (cell < 0)
+        return false;
+    int texX = 0;
+    int texY = 0;
+    glyphCellOrigin(cell, texX, texY);
+    const float texW = static_cast<float>(ATLAS_COLS * ATLAS_TILE_SIZE);
+    const float texH = static_cast<float>(ATLAS_ROWS * ATLAS_TILE_SIZE);
+    u0 = (texX + 1) / texW;
+    v0 = (texY + 1) / texH;
+    u1 = (texX + 5) / texW;
+    v1 = (texY + 6) / texH;
+    return true;
+}
+
+void atlasWhiteTexel(float &u, float &v)
+{
+    int texX = 0;
+    int texY = 0;
+    glyphCellOrigin(gWhiteCell, texX, texY);
+    u = (texX + GLYPH_CELL_SIZE * 0.5f) / static_cast<float>(ATLAS_COLS * ATLAS_TILE_SIZE);
+    v = (texY + GLYPH_CELL_SIZE * 0.5f) / static_cast<float>(ATLAS_ROWS * ATLAS_TILE_SIZE);
+}
+
 void createAtlasTexture()
 {
-    gBlockTile = {{BlockType::Grass, 0},
-                  {BlockType::Dirt, 1},
-                  {BlockType::Stone, 2},
-                  {BlockType::Wood, 3},
-                  {BlockType::Leaves, 4},
-                  {BlockType::Water, 5},
-                  {BlockType::Plank, 6},
-                  {BlockType::Sand, 7},
-                  {BlockType::Air, 8},
-                  {BlockType::Glass, 9},
-                  {BlockType::AndGate, 10},
-                  {BlockType::OrGate, 11},
-                  {BlockType::NotGate, 12},
-                  {BlockType::XorGate, 13},
-                  {BlockType::Led, 14},
-                  {BlockType::Button, 15},
-                  {BlockType::Wire, 16},
-                  {BlockType::Sign, 17},
-                  {BlockType::DFlipFlop, 18},
-                  {BlockType::AddGate, 19},
-                  {BlockType::Counter, 20},
-                  {BlockType::Splitter, 21},
-                  {BlockType::Merger, 22},
-                  {BlockType::Decoder, 23},
-                  {BlockType::Multiplexer, 24},
-                  {BlockType::Comparator, 25},
-                  {BlockType::Clock, 26}};
-
-    int nextTile = static_cast<int>(gBlockTile.size());
-    gGrassTopTile = nextTile++;
-    gAndTopTile = nextTile++;
-    gOrTopTile = nextTile++;
-    gNotTopTile = nextTile++;
-    gXorTopTile = nextTile++;
-    gDffTopTile = nextTile++;
-    gAddTopTile = nextTile++;
-    gAddBottomTile = nextTile++;
-    gAddBackTile = nextTile++;
-    gCounterTopTile = nextTile++;
-    gSplitterTopTile = nextTile++;
-    gMergerTopTile = nextTile++;
-    gDecoderTopTile = nextTile++;
-    gMuxTopTile = nextTile++;
-    gMuxInTile[0] = nextTile++;
-    gMuxInTile[1] = nextTile++;
-    gMuxInTile[2] = nextTile++;
-    gMuxInTile[3] = nextTile++;
-    gComparatorTopTile = nextTile++;
-    gComparatorInLeftTile = nextTile++;
-    gComparatorInRightTile = nextTile++;
-    gComparatorGtTile = nextTile++;
-    gComparatorEqTile = nextTile++;
-    gComparatorLtTile = nextTile++;
-    gClockTopTile = nextTile++;
+    int nextTile = TILE_COUNT;
+    gGlyphTileBase = nextTile;
+    nextTile += (static_cast<int>(FONT5x4.size()) + 1 + GLYPHS_PER_TILE - 1) / GLYPHS_PER_TILE;
 
     int texW = ATLAS_COLS * ATLAS_TILE_SIZE;
     int texH = ATLAS_ROWS * ATLAS_TILE_SIZE;
     int atlasCapacity = ATLAS_COLS * ATLAS_ROWS;
-    int maxTileIdx = 0;
-    for (const auto &kv : gBlockTile)
-        maxTileIdx = std::max(maxTileIdx, kv.second);
-    maxTileIdx = std::max(maxTileIdx, std::max(std::max(gGrassTopTile, gAndTopTile), std::max(gOrTopTile, gXorTopTile)));
-    maxTileIdx = std::max(maxTileIdx,
-                          std::max(std::max(gDffTopTile, gAddTopTile), std::max(gAddBottomTile, gAddBackTile)));
-    maxTileIdx = std::max(maxTileIdx, gCounterTopTile);
-    maxTileIdx = std::max(maxTileIdx,
-                          std::max(std::max(gSplitterTopTile, gMergerTopTile),
-                                   std::max(gDecoderTopTile,
-                                            std::max(gMuxTopTile,
-                                                     std::max(gMuxInTile[0],
-                                                              std::max(gMuxInTile[1],
-                                                                       std::max(gMuxInTile[2], gMuxInTile[3])))))));
-    maxTileIdx = std::max(maxTileIdx,
-                          std::max(std::max(gComparatorTopTile, gComparatorInLeftTile),
-                                   std::max(gComparatorInRightTile,
-                                            std::max(gComparatorGtTile,
-                                                     std::max(gComparatorEqTile, gComparatorLtTile)))));
-    maxTileIdx = std::max(maxTileIdx, gClockTopTile);
+    int maxTileIdx = nextTile - 1;
     if (maxTileIdx >= atlasCapacity)
     {
         std::cerr << "Atlas capacity too small for gate labels.\n";
@@ -947,61 +888,60 @@ void createAtlasTexture()
     std::vector<uint8_t> pixels(texW * texH * 4, 0);
 
     auto base = [&](BlockType b)
-    { return BLOCKS.at(b).color; };
-
-    fillGrassSideTile(pixels, texW, gBlockTile[BlockType::Grass], gBlockTile[BlockType::Dirt], {0.16f, 0.42f, 0.18f},
-                      base(BlockType::Dirt));
-    fillTile(pixels, texW, gGrassTopTile, {0.16f, 0.42f, 0.18f}, 3);
-    fillTile(pixels, texW, gBlockTile[BlockType::Dirt], base(BlockType::Dirt), 4);
-    fillStoneBrickTile(pixels, texW, gBlockTile[BlockType::Stone], base(BlockType::Stone));
-    fillWoodTile(pixels, texW, gBlockTile[BlockType::Wood], base(BlockType::Wood));
-    fillTile(pixels, texW, gBlockTile[BlockType::Leaves], base(BlockType::Leaves), 5);
-    fillTile(pixels, texW, gBlockTile[BlockType::Water], base(BlockType::Water), 99);
-    fillTile(pixels, texW, gBlockTile[BlockType::Plank], base(BlockType::Plank), 0);
-    fillTile(pixels, texW, gBlockTile[BlockType::Sand], base(BlockType::Sand), 2);
-    fillTile(pixels, texW, gBlockTile[BlockType::Air], {0.7f, 0.85f, 1.0f}, 6);
-    fillTile(pixels, texW, gBlockTile[BlockType::Glass], {0.85f, 0.9f, 0.95f}, 88);
-    fillTile(pixels, texW, gBlockTile[BlockType::AndGate], base(BlockType::AndGate), 15);
-    fillTile(pixels, texW, gBlockTile[BlockType::OrGate], base(BlockType::OrGate), 16);
-    fillTile(pixels, texW, gBlockTile[BlockType::XorGate], base(BlockType::XorGate), 21);
-    fillTile(pixels, texW, gBlockTile[BlockType::DFlipFlop], base(BlockType::DFlipFlop), 23);
-    fillTile(pixels, texW, gBlockTile[BlockType::AddGate], base(BlockType::AddGate), 25);
-    fillTile(pixels, texW, gBlockTile[BlockType::Counter], base(BlockType::Counter), 12);
-    fillTile(pixels, texW, gBlockTile[BlockType::Led], base(BlockType::Led), 17);
-    fillTile(pixels, texW, gBlockTile[BlockType::Button], base(BlockType::Button), 18);
-    fillWireTile(pixels, texW, gBlockTile[BlockType::Wire], base(BlockType::Wire));
-    fillTile(pixels, texW, gBlockTile[BlockType::NotGate], base(BlockType::NotGate), 20);
-    fillTile(pixels, texW, gBlockTile[BlockType::Sign], base(BlockType::Sign), 1);
-    fillTile(pixels, texW, gBlockTile[BlockType::Splitter], base(BlockType::Splitter), 22);
-    fillTile(pixels, texW, gBlockTile[BlockType::Merger], base(BlockType::Merger), 23);
-    fillTile(pixels, texW, gBlockTile[BlockType::Decoder], base(BlockType::Decoder), 24);
-    fillTile(pixels, texW, gBlockTile[BlockType::Multiplexer], base(BlockType::Multiplexer), 26);
-    fillTile(pixels, texW, gBlockTile[BlockType::Clock], base(BlockType::Clock), 34);
+    { return blockTraits(b).color; };
+
+    fillGrassSideTile(pixels, texW, TileGrass, TileDirt, {0.16f, 0.42f, 0.18f}, base(BlockType::Dirt));
+    fillTile(pixels, texW, TileGrassTop, {0.16f, 0.42f, 0.18f}, 3);
+    fillTile(pixels, texW, TileDirt, base(BlockType::Dirt), 4);
+    fillStoneBrickTile(pixels, texW, TileStone, base(BlockType::Stone));
+    fillWoodTile(pixels, texW, TileWood, base(BlockType::Wood));
+    fillTile(pixels, texW, TileLeaves, base(BlockType::Leaves), 5);
+    fillTile(pixels, texW, TileWater, base(BlockType::Water), 99);
+    fillTile(pixels, texW, TilePlank, base(BlockType::Plank), 0);
+    fillTile(pixels, texW, TileSand, base(BlockType::Sand), 2);
+    fillTile(pixels, texW, TileAir, {0.7f, 0.85f, 1.0f}, 6);
+    fillTile(pixels, texW, TileGlass, {0.85f, 0.9f, 0.95f}, 88);
+    fillTile(pixels, texW, TileAnd, base(BlockType::AndGate), 15);
+    fillTile(pixels, texW, TileOr, base(BlockType::OrGate), 16);
+    fillTile(pixels, texW, TileXor, base(BlockType::XorGate), 21);
+    fillTile(pixels, texW, TileDff, base(BlockType::DFlipFlop), 23);
+    fillTile(pixels, texW, TileAdd, base(BlockType::AddGate), 25);
+    fillTile(pixels, texW, TileCounter, base(BlockType::Counter), 12);
+    fillTile(pixels, texW, TileLed, base(BlockType::Led), 17);
+    fillTile(pixels, texW, TileButton, base(BlockType::Button), 18);
+    fillWireTile(pixels, texW, TileWire, base(BlockType::Wire));
+    fillTile(pixels, texW, TileNot, base(BlockType::NotGate), 20);
+    fillTile(pixels, texW, TileSign, base(BlockType::Sign), 1);
+    fillTile(pixels, texW, TileSplitter, base(BlockType::Splitter), 22);
+    fillTile(pixels, texW, TileMerger, base(BlockType::Merger), 23);
+    fillTile(pixels, texW, TileDecoder, base(BlockType::Decoder), 24);
+    fillTile(pixels, texW, TileMux, base(BlockType::Multiplexer), 26);
+    fillTile(pixels, texW, TileClock, base(BlockType::Clock), 34);
     // Comparator inventory tile styled like other gates with clear label
-    fillGateTileWithLabels(pixels, texW, gBlockTile[BlockType::Comparator], base(BlockType::Comparator), 31, "CMP", "A",
+    fillGateTileWithLabels(pixels, texW, TileComparator, base(BlockType::Comparator), 31, "CMP", "A",
                            "B", "OUT");
-    fillTile(pixels, texW, gMuxInTile[0], base(BlockType::Multiplexer), 27);
-    fillTile(pixels, texW, gMuxInTile[1], base(BlockType::Multiplexer), 28);
-    fillTile(pixels, texW, gMuxInTile[2], base(BlockType::Multiplexer), 29);
-    fillTile(pixels, texW, gMuxInTile[3], base(BlockType::Multiplexer), 30);
-    blitTinyTextToTile(pixels, texW, gMuxInTile[0], 12, 12, "0", 3, 245, 245, 240, 255);
-    blitTinyTextToTile(pixels, texW, gMuxInTile[1], 12, 12, "1", 3, 245, 245, 240, 255);
-    blitTinyTextToTile(pixels, texW, gMuxInTile[2], 12, 12, "2", 3, 245, 245, 240, 255);
-    blitTinyTextToTile(pixels, texW, gMuxInTile[3], 12, 12, "3", 3, 245, 245, 240, 255);
-    fillGateTileWithLabels(pixels, texW, gAndTopTile, base(BlockType::AndGate), 15, "AND");
-    fillGateTileWithLabels(pixels, texW, gOrTopTile, base(BlockType::OrGate), 16, "OR");
-    fillGateTileWithLabels(pixels, texW, gXorTopTile, base(BlockType::XorGate), 17, "XOR");
-    fillNotGateTile(pixels, texW, gNotTopTile, base(BlockType::NotGate), 15);
-    fillDffTopTile(pixels, texW, gDffTopTile, base(BlockType::DFlipFlop), 23);
-    fillAddTopTile(pixels, texW, gAddTopTile, base(BlockType::AddGate), 25);
-    fillAddBottomTile(pixels, texW, gAddBottomTile, base(BlockType::AddGate), 25);
-    fillAddBackTile(pixels, texW, gAddBackTile, base(BlockType::AddGate), 25);
-    fillCounterTopTile(pixels, texW, gCounterTopTile, base(BlockType::Counter), 12);
-    fillGateTileWithLabels(pixels, texW, gSplitterTopTile, base(BlockType::Splitter), 22, "SPLIT", "B2", "B1", "BUS",
+    fillTile(pixels, texW, TileMuxIn0, base(BlockType::Multiplexer), 27);
+    fillTile(pixels, texW, TileMuxIn1, base(BlockType::Multiplexer), 28);
+    fillTile(pixels, texW, TileMuxIn2, base(BlockType::Multiplexer), 29);
+    fillTile(pixels, texW, TileMuxIn3, base(BlockType::Multiplexer), 30);
+    blitTinyTextToTile(pixels, texW, TileMuxIn0, 12, 12, "0", 3, 245, 245, 240, 255);
+    blitTinyTextToTile(pixels, texW, TileMuxIn1, 12, 12, "1", 3, 245, 245, 240, 255);
+    blitTinyTextToTile(pixels, texW, TileMuxIn2, 12, 12, "2", 3, 245, 245, 240, 255);
+    blitTinyTextToTile(pixels, texW, TileMuxIn3, 12, 12, "3", 3, 245, 245, 240, 255);
+    fillGateTileWithLabels(pixels, texW, TileAndTop, base(BlockType::AndGate), 15, "AND");
+    fillGateTileWithLabels(pixels, texW, TileOrTop, base(BlockType::OrGate), 16, "OR");
+    fillGateTileWithLabels(pixels, texW, TileXorTop, base(BlockType::XorGate), 17, "XOR");
+    fillNotGateTile(pixels, texW, TileNotTop, base(BlockType::NotGate), 15);
+    fillDffTopTile(pixels, texW, TileDffTop, base(BlockType::DFlipFlop), 23);
+    fillAddTopTile(pixels, texW, TileAddTop, base(BlockType::AddGate), 25);
+    fillAddBottomTile(pixels, texW, TileAddBottom, base(BlockType::AddGate), 25);
+    fillAddBackTile(pixels, texW, TileAddBack, base(BlockType::AddGate), 25);
+    fillCounterTopTile(pixels, texW, TileCounterTop, base(BlockType::Counter), 12);
+    fillGateTileWithLabels(pixels, texW, TileSplitterTop, base(BlockType::Splitter), 22, "SPLIT", "B2", "B1", "BUS",
                            true, true, true);
-    fillGateTileWithLabels(pixels, texW, gMergerTopTile, base(BlockType::Merger), 23, "MERGE", "B2", "B1", "BUS");
-    fillGateTileWithLabels(pixels, texW, gDecoderTopTile, base(BlockType::Decoder), 24, "DEC", "EN", "SEL", "OUT");
-    fillGateTileWithLabels(pixels, texW, gMuxTopTile, base(BlockType::Multiplexer), 26, "MUX", "OUT", "SEL", "");
+    fillGateTileWithLabels(pixels, texW, TileMergerTop, base(BlockType::Merger), 23, "MERGE", "B2", "B1", "BUS");
+    fillGateTileWithLabels(pixels, texW, TileDecoderTop, base(BlockType::Decoder), 24, "DEC", "EN", "SEL", "OUT");
+    fillGateTileWithLabels(pixels, texW, TileMuxTop, base(BlockType::Multiplexer), 26, "MUX", "OUT", "SEL", "");
 
     auto fillComparatorLabel = [&](int tileIdx, const std::string &text)
     {
@@ -1009,14 +949,32 @@ void createAtlasTexture()
         blitTinyTextToTile(pixels, texW, tileIdx, 8, 12, text, 4, 245, 245, 240, 255);
     };
     // Top face shows inputs like other gate tops
-    fillGateTileWithLabels(pixels, texW, gComparatorTopTile, base(BlockType::Comparator), 32, "COMP", "A", "B", "OUT");
+    fillGateTileWithLabels(pixels, texW, TileComparatorTop, base(BlockType::Comparator), 32, "COMP", "A", "B", "OUT");
     // Side faces keep a neutral texture; only outputs show symbols with direction dots
-    fillTile(pixels, texW, gComparatorInLeftTile, base(BlockType::Comparator), 32);
-    fillTile(pixels, texW, gComparatorInRightTile, base(BlockType::Comparator), 32);
-    fillComparatorLabel(gComparatorGtTile, ">.");
-    fillComparatorLabel(gComparatorEqTile, "=");
-    fillComparatorLabel(gComparatorLtTile, "<.");
-    fillGateTileWithLabels(pixels, texW, gClockTopTile, base(BlockType::Clock), 35, "CLK", "", "", "OUT");
+    fillTile(pixels, texW, TileComparatorInLeft, base(BlockType::Comparator), 32);
+    fillTile(pixels, texW, TileComparatorInRight, base(BlockType::Comparator), 32);
+    fillComparatorLabel(TileComparatorGt, ">.");
+    fillComparatorLabel(TileComparatorEq, "=");
+    fillComparatorLabel(TileComparatorLt, "<.");
+    fillGateTileWithLabels(pixels, texW, TileClockTop, base(BlockType::Clock), 35, "CLK", "", "", "OUT");
+
+    // Sign/HUD font: white glyphs on transparent cells, tinted by the vertex color. One extra solid white
+    // cell lets untextured HUD quads share the atlas texture.
+    gGlyphCell.fill(-1);
+    int glyph = 0;
+    for (const auto &kv : FONT5x4)
+    {
+        int cellX = 0;
+        int cellY = 0;
+        glyphCellOrigin(glyph, cellX, cellY);
+        blitTinyCharToTile(pixels, texW, 0, cellX + 1, cellY + 1, kv.first, 1, 255, 255, 255, 255);
+        gGlyphCell[static_cast<unsigned char>(kv.first)] = glyph++;
+    }
+    gWhiteCell = glyph;
+    int whiteX = 0;
+    int whiteY = 0;
+    glyphCellOrigin(gWhiteCell, whiteX, whiteY);
+    fillRect(pixels, texW, whiteX, whiteY, GLYPH_CELL_SIZE, GLYPH_CELL_SIZE, 255, 255, 255, 255);
 
     if (gAtlasTex == 0)
     {
@@ -1031,14 +989,315 @@ void createAtlasTexture()
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+// Chunk faces use the BlockFace numbering (FACE_DIRS); the opposite of face f is f ^ 1
+static int facePairBit(int a, int b)
+{
+    static const int base[6] = {0, 5, 9, 12, 14, 15};
+    if (a > b)
+        std::swap(a, b);
+    return base[a] + (b - a - 1);
+}
+
+static bool chunkFacesLinked(const ChunkMesh &mesh, int a, int b)
+{
+    return (mesh.faceLinks >> facePairBit(a, b)) & 1u;
+}
+
+// Chunk plus a one-voxel border, copied once per mesh so face culling, AO and the face-link flood fill never
+// go back to the World. occRows/glassRows hold one bit per padded x (bit px = world x0 - 1 + px) for each
+// (py, pz) row; cells outside the world are Air.
+static const int PAD_SIZE = CHUNK_SIZE + 2;
+static_assert(PAD_SIZE <= 32, "padded rows must fit a uint32_t");
+
+struct PaddedChunk
+{
+    int origin[3] = {0, 0, 0}; // world position of the first interior voxel
+    int size[3] = {0, 0, 0};   // interior extent, smaller than CHUNK_SIZE at the world edge
+    bool anyOccluder = false;
+    std::array<BlockType, PAD_SIZE * PAD_SIZE * PAD_SIZE> types;
+    std::array<uint32_t, PAD_SIZE * PAD_SIZE> occRows;
+    std::array<uint32_t, PAD_SIZE * PAD_SIZE> glassRows;
+
+    static int row(int py, int pz) { return py * PAD_SIZE + pz; }
+    BlockType type(int px, int py, int pz) const { return types[row(py, pz) * PAD_SIZE + px]; }
+    bool occludes(int px, int py, int pz) const { return (occRows[row(py, pz)] >> px) & 1u; }
+};
+
+static void fillPaddedChunk(const World &world, int cx, int cy, int cz, PaddedChunk &pad)
+{
+    pad.origin[0] = cx * CHUNK_SIZE;
+    pad.origin[1] = cy * CHUNK_SIZE;
+    pad.origin[2] = cz * CHUNK_SIZE;
+    pad.size[0] = std::min(world.getWidth(), pad.origin[0] + CHUNK_SIZE) - pad.origin[0];
+    pad.size[1] = std::min(world.getHeight(), pad.origin[1] + CHUNK_SIZE) - pad.origin[1];
+    pad.size[2] = std::min(world.getDepth(), pad.origin[2] + CHUNK_SIZE) - pad.origin[2];
+    pad.anyOccluder = false;
+    for (int py = 0; py < PAD_SIZE; ++py)
+    {
+        for (int pz = 0; pz < PAD_SIZE; ++pz)
+        {
+            const int r = PaddedChunk::row(py, pz);
+            BlockType *types = &pad.types[r * PAD_SIZE];
+            world.copyRow(pad.origin[0] - 1, pad.origin[1] - 1 + py, pad.origin[2] - 1 + pz, PAD_SIZE, types);
+            uint32_t occ = 0;
+            uint32_t glass = 0;
+            for (int px = 0; px < PAD_SIZE; ++px)
+            {
+                occ |= static_cast<uint32_t>(occludesFaces(types[px])) << px;
+                glass |= static_cast<uint32_t>(types[px] == BlockType::Glass) << px;
+            }
+            pad.occRows[r] = occ;
+            pad.glassRows[r] = glass;
+            bool interior = py >= 1 && py <= pad.size[1] && pz >= 1 && pz <= pad.size[2];
+            if (interior && (occ & (((1u << pad.size[0]) - 1u) << 1)))
+                pad.anyOccluder = true;
+        }
+    }
+}
+
+// Flood fills the non-occluding voxels of a chunk; each open region links every chunk face it touches
+static uint16_t computeFaceLinks(const PaddedChunk &pad)
+{
+    const int sx = pad.size[0];
+    const int sy = pad.size[1];
+    const int sz = pad.size[2];
+    const uint16_t allLinks = 0x7FFF;
+    // nothing blocks: one open region touching every face (the common all-air chunk)
+    if (!pad.anyOccluder)
+        return allLinks;
+    static std::vector<uint8_t> seen;
+    static std::vector<int> stack;
+    seen.assign(static_cast<size_t>(sx * sy * sz), 0);
+    stack.clear();
+    uint16_t links = 0;
+    auto open = [&](int x, int y, int z)
+    { return !pad.occludes(x + 1, y + 1, z + 1); };
+
+    for (int start = 0; start < sx * sy * sz; ++start)
+    {
+        if (seen[start])
+            continue;
+        seen[start] = 1;
+        if (!open(start % sx, start / (sx * sz), (start / sx) % sz))
+            continue;
+        int faces = 0;
+        stack.push_back(start);
+        while (!stack.empty())
+        {
+            int c = stack.back();
+            stack.pop_back();
+            int p[3] = {c % sx, c / (sx * sz), (c / sx) % sz};
+            const int size[3] = {sx, sy, sz};
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (p[axis] == 0)
+                    faces |= 1 << (axis * 2);
+                if (p[axis] == size[axis] - 1)
+                    faces |= 1 << (axis * 2 + 1);
+            }
+            for (const auto &d : FACE_DIRS)
+            {
+                int nx = p[0] + d[0];
+                int ny = p[1] + d[1];
+                int nz = p[2] + d[2];
+                if (nx < 0 || ny < 0 || nz < 0 || nx >= sx || ny >= sy || nz >= sz)
+                    continue;
+                int n = (ny * sz + nz) * sx + nx;
+                if (seen[n])
+                    continue;
+                seen[n] = 1;
+                if (open(nx, ny, nz))
+                    stack.push_back(n);
+            }
+        }
+        for (int a = 0; a < 6; ++a)
+        {
+            for (int b = a + 1; b < 6; ++b)
+            {
+                if ((faces >> a & 1) && (faces >> b & 1))
+                    links |= static_cast<uint16_t>(1u << facePairBit(a, b));
+            }
+        }
+        if (links == allLinks)
+            break;
+    }
+    return links;
+}
+
+// Shared tail of the full and LOD meshers: bounds, face links, arena upload
+static void finishChunkMesh(ChunkMesh &mesh, const PaddedChunk &pad, const std::vector<Vertex> &verts,
+                            const std::vector<Vertex> &glassVerts)
+{
+    float mn[3] = {1e30f, 1e30f, 1e30f};
+    float mx[3] = {-1e30f, -1e30f, -1e30f};
+    for (const auto *list : {&verts, &glassVerts})
+    {
+        for (const Vertex &v : *list)
+        {
+            mn[0] = std::min(mn[0], v.x);
+            mn[1] = std::min(mn[1], v.y);
+            mn[2] = std::min(mn[2], v.z);
+            mx[0] = std::max(mx[0], v.x);
+            mx[1] = std::max(mx[1], v.y);
+            mx[2] = std::max(mx[2], v.z);
+        }
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        mesh.boundsMin[i] = mn[i] <= mx[i] ? mn[i] : 0.0f;
+        mesh.boundsMax[i] = mn[i] <= mx[i] ? mx[i] : 0.0f;
+    }
+    mesh.faceLinks = computeFaceLinks(pad);
+
+    gfxArenaStore(mesh.range, verts.data(), verts.size());
+    gfxArenaStore(mesh.glassRange, glassVerts.data(), glassVerts.size());
+    mesh.glassCenters.clear();
+    for (size_t q = 0; q + 3 < glassVerts.size(); q += 4)
+    {
+        float c[3] = {0.0f, 0.0f, 0.0f};
+        for (size_t i = q; i < q + 4; ++i)
+        {
+            c[0] += glassVerts[i].x;
+            c[1] += glassVerts[i].y;
+            c[2] += glassVerts[i].z;
+        }
+        for (float v : c)
+            mesh.glassCenters.push_back(v * 0.25f);
+    }
+    mesh.glassOrder.clear();
+    mesh.glassSortKey = -1;
+    mesh.dirty = false;
+}
+
+// Fixed block geometry (wires per connection mask, the sign body) built once relative to the voxel corner.
+// Meshing one of these is a copy with a position offset and a per-face tint.
+struct TemplateVertex
+{
+    float x, y, z;
+    float u, v;
+    uint8_t shade; // BlockFace whose light the vertex takes, or TEMPLATE_UNLIT
+};
+using GeometryTemplate = std::vector<TemplateVertex>;
+static const uint8_t TEMPLATE_UNLIT = 6;
+
+static const float WIRE_HALF = 0.12f;   // half size of the center node and arm cross-section
+static const float WIRE_MARGIN = 0.04f; // gap between an arm and the voxel boundary
+static const float WIRE_JOIN = 0.002f;  // arm overlap into the node
+
+static const float SIGN_BOARD_W = 0.9f;
+static const float SIGN_BOARD_H = 0.6f;
+static const float SIGN_BOARD_T = 0.08f;
+static const float SIGN_BOARD_Y = 0.8f; // board center above the voxel floor
+static const float SIGN_POLE_W = 0.12f;
+static const float SIGN_POLE_H = 0.6f;
+static const float SIGN_POLE_Y = 0.1f;
+
+// Appends an axis-aligned box, faces in +X, -X, +Y, -Y, +Z, -Z order, textured with the whole tile
+static void templateBox(GeometryTemplate &t, float minX, float minY, float minZ, float maxX, float maxY, float maxZ,
+                        int tile, bool lit)
+{
+    float du = 1.0f / ATLAS_COLS;
+    float dv = 1.0f / ATLAS_ROWS;
+    int tx = tile % ATLAS_COLS;
+    int ty = tile / ATLAS_COLS;
+    const float pad = 0.0015f;
+    float u0 = tx * du + pad;
+    float v0 = ty * dv + pad;
+    float u1 = (tx + 1) * du - pad;
+    float v1 = (ty + 1) * dv - pad;
+    auto push = [&](float px, float py, float pz, float u, float v, int face)
+    { t.push_back(TemplateVertex{px, py, pz, u, v, static_cast<uint8_t>(lit ? face : TEMPLATE_UNLIT)}); };
+
+    push(maxX, minY, minZ, u1, v1, FacePosX);
+    push(maxX, maxY, minZ, u1, v0, FacePosX);
+    push(maxX, maxY, maxZ, u0, v0, FacePosX);
+    push(maxX, minY, maxZ, u0, v1, FacePosX);
+
+    push(minX, minY, minZ, u1, v1, FaceNegX);
+    push(minX, minY, maxZ, u0, v1, FaceNegX);
+    push(minX, maxY, maxZ, u0, v0, FaceNegX);
+    push(minX, maxY, minZ, u1, v0, FaceNegX);
+
+    push(minX, maxY, minZ, u1, v1, FacePosY);
+    push(maxX, maxY, minZ, u0, v1, FacePosY);
+    push(maxX, maxY, maxZ, u0, v0, FacePosY);
+    push(minX, maxY, maxZ, u1, v0, FacePosY);
+
+    push(minX, minY, minZ, u1, v1, FaceNegY);
+    push(maxX, minY, minZ, u0, v1, FaceNegY);
+    push(maxX, minY, maxZ, u0, v0, FaceNegY);
+    push(minX, minY, maxZ, u1, v0, FaceNegY);
+
+    push(minX, minY, maxZ, u1, v1, FacePosZ);
+    push(maxX, minY, maxZ, u0, v1, FacePosZ);
+    push(maxX, maxY, maxZ, u0, v0, FacePosZ);
+    push(minX, maxY, maxZ, u1, v0, FacePosZ);
+
+    push(minX, minY, minZ, u1, v1, FaceNegZ);
+    push(minX, maxY, minZ, u1, v0, FaceNegZ);
+    push(maxX, maxY, minZ, u0, v0, FaceNegZ);
+    push(maxX, minY, minZ, u0, v1, FaceNegZ);
+}
+
+// Wire node plus one arm per set bit of `mask` (bit f = neighbour on BlockFace f is connected)
+static const GeometryTemplate &wireTemplate(int mask)
+{
+    static const std::array<GeometryTemplate, 64> templates = []
+    {
+        std::array<GeometryTemplate, 64> all;
+        const float c = 0.5f;
+        const float h = WIRE_HALF;
+        const float lo = WIRE_MARGIN;
+        const float hi = 1.0f - WIRE_MARGIN;
+        for (int m = 0; m < 64; ++m)
+        {
+            GeometryTemplate &t = all[m];
+            templateBox(t, c - h, c - h, c - h, c + h, c + h, c + h, TileWire, true);
+            if (m & (1 << FacePosX))
+                templateBox(t, c + WIRE_JOIN, c - h, c - h, hi, c + h, c + h, TileWire, true);
+            if (m & (1 << FaceNegX))
+                templateBox(t, lo, c - h, c - h, c - WIRE_JOIN, c + h, c + h, TileWire, true);
+            if (m & (1 << FacePosY))
+                templateBox(t, c - h, c + WIRE_JOIN, c - h, c + h, hi, c + h, TileWire, true);
+            if (m & (1 << FaceNegY))
+                templateBox(t, c - h, lo, c - h, c + h, c - WIRE_JOIN, c + h, TileWire, true);
+            if (m & (1 << FacePosZ))
+                templateBox(t, c - h, c - h, c + WIRE_JOIN, c + h, c + h, hi, TileWire, true);
+            if (m & (1 << FaceNegZ))
+                templateBox(t, c - h, c - h, lo, c + h, c + h, c - WIRE_JOIN, TileWire, true);
+        }
+        return all;
+    }();
+    return templates[mask];
+}
+
+// Sign board and pole, unlit like before; the text is per-sign and meshed separately
+static const GeometryTemplate &signTemplate()
+{
+    static const GeometryTemplate t = []
+    {
+        GeometryTemplate g;
+        const float c = 0.5f;
+        templateBox(g, c - SIGN_BOARD_W * 0.5f, SIGN_BOARD_Y - SIGN_BOARD_H * 0.5f, c - SIGN_BOARD_T * 0.5f,
+                    c + SIGN_BOARD_W * 0.5f, SIGN_BOARD_Y + SIGN_BOARD_H * 0.5f, c + SIGN_BOARD_T * 0.5f, TileSign, false);
+        templateBox(g, c - SIGN_POLE_W * 0.5f, SIGN_POLE_Y, c - SIGN_POLE_W * 0.5f, c + SIGN_POLE_W * 0.5f,
+                    SIGN_POLE_Y + SIGN_POLE_H, c + SIGN_POLE_W * 0.5f, TileSign, false);
+        return g;
+    }();
+    return t;
+}
+
 void buildChunkMesh(const World &world, int cx, int cy, int cz)
 {
     int idx = chunkIndex(cx, cy, cz);
     if (idx < 0)
         return;
     ChunkMesh &mesh = chunkMeshes[idx];
-    mesh.verts.clear();
-    mesh.glassVerts.clear();
+    // scratch geometry, reused between calls; after upload only the arena holds the vertices
+    static std::vector<Vertex> verts;
+    static std::vector<Vertex> glassVerts;
+    verts.clear();
+    glassVerts.clear();
     int x0 = cx * CHUNK_SIZE;
     int y0 = cy * CHUNK_SIZE;
     int z0 = cz * CHUNK_SIZE;
@@ -1046,6 +1305,13 @@ void buildChunkMesh(const World &world, int cx, int cy, int cz)
     int y1 = std::min(world.getHeight(), y0 + CHUNK_SIZE);
     int z1 = std::min(world.getDepth(), z0 + CHUNK_SIZE);
 
+    static PaddedChunk pad;
+    fillPaddedChunk(world, cx, cy, cz, pad);
+    const auto &occRows = pad.occRows;
+    const auto &glassRows = pad.glassRows;
+    auto typeAt = [&](int wx, int wy, int wz)
+    { return pad.type(wx - x0 + 1, wy - y0 + 1, wz - z0 + 1); };
+
     const float lightX = -0.45f;
     const float lightY = 0.85f;
     const float lightZ = -0.35f;
@@ -1055,11 +1321,7 @@ void buildChunkMesh(const World &world, int cx, int cy, int cz)
     const float lz = lightZ / lightLen;
 
     auto occludesAt = [&](int ox, int oy, int oz)
-    {
-        if (!world.inside(ox, oy, oz))
-            return false;
-        return occludesFaces(world.get(ox, oy, oz));
-    };
+    { return (occRows[(oy - y0 + 1) * PAD_SIZE + (oz - z0 + 1)] >> (ox - x0 + 1)) & 1u; };
 
     auto aoFactor = [&](bool side1, bool side2, bool corner)
     {
@@ -1084,7 +1346,7 @@ void buildChunkMesh(const World &world, int cx, int cy, int cz)
     auto addFace = [&](int x, int y, int z, const int nx, const int ny, const int nz, const std::array<float, 3> &col,
                        int tile, float emissive, bool toGlass)
     {
-        auto &vec = toGlass ? mesh.glassVerts : mesh.verts;
+        auto &vec = toGlass ? glassVerts : verts;
         float bx = static_cast<float>(x);
         float by = static_cast<float>(y);
         float bz = static_cast<float>(z);
@@ -1224,382 +1486,148 @@ void buildChunkMesh(const World &world, int cx, int cy, int cz)
             push(bx + 1, by, bz, u0, v1, baseLight * ao10);
         }
     };
-    auto addBox = [&](float minX, float minY, float minZ, float maxX, float maxY, float maxZ, const std::array<float, 3> &col,
-                      int tile)
-    {
-        float br = col[0];
-        float bg = col[1];
-        float bb = col[2];
-        float du = 1.0f / ATLAS_COLS;
-        float dv = 1.0f / ATLAS_ROWS;
-        int tx = tile % ATLAS_COLS;
-        int ty = tile / ATLAS_COLS;
-        const float pad = 0.0015f;
-        float u0 = tx * du + pad;
-        float v0 = ty * dv + pad;
-        float u1 = (tx + 1) * du - pad;
-        float v1 = (ty + 1) * dv - pad;
-
-        auto push = [&](float px, float py, float pz, float u, float v)
-        { mesh.verts.push_back(Vertex{px, py, pz, u, v, br, bg, bb}); };
-
-        push(maxX, minY, minZ, u1, v1);
-        push(maxX, maxY, minZ, u1, v0);
-        push(maxX, maxY, maxZ, u0, v0);
-        push(maxX, minY, maxZ, u0, v1);
-
-        push(minX, minY, minZ, u1, v1);
-        push(minX, minY, maxZ, u0, v1);
-        push(minX, maxY, maxZ, u0, v0);
-        push(minX, maxY, minZ, u1, v0);
-
-        push(minX, maxY, minZ, u1, v1);
-        push(maxX, maxY, minZ, u0, v1);
-        push(maxX, maxY, maxZ, u0, v0);
-        push(minX, maxY, maxZ, u1, v0);
-
-        push(minX, minY, minZ, u1, v1);
-        push(maxX, minY, minZ, u0, v1);
-        push(maxX, minY, maxZ, u0, v0);
-        push(minX, minY, maxZ, u1, v0);
-
-        push(minX, minY, maxZ, u1, v1);
-        push(maxX, minY, maxZ, u0, v1);
-        push(maxX, maxY, maxZ, u0, v0);
-        push(minX, maxY, maxZ, u1, v0);
-
-        push(minX, minY, minZ, u1, v1);
-        push(minX, maxY, minZ, u1, v0);
-        push(maxX, maxY, minZ, u0, v0);
-        push(maxX, minY, minZ, u0, v1);
-    };
-    auto addWireBox = [&](float minX, float minY, float minZ, float maxX, float maxY, float maxZ,
-                          const std::array<float, 3> &col, int tile, float emissive)
+    // copies a template to (x, y, z), tinting each vertex with the light of the face it belongs to
+    auto addTemplate = [&](const GeometryTemplate &t, int x, int y, int z, const std::array<float, 3> &col,
+                           float emissive)
     {
-        float br = col[0];
-        float bg = col[1];
-        float bb = col[2];
-        float du = 1.0f / ATLAS_COLS;
-        float dv = 1.0f / ATLAS_ROWS;
-        int tx = tile % ATLAS_COLS;
-        int ty = tile / ATLAS_COLS;
-        const float pad = 0.0015f;
-        float u0 = tx * du + pad;
-        float v0 = ty * dv + pad;
-        float u1 = (tx + 1) * du - pad;
-        float v1 = (ty + 1) * dv - pad;
-
-        auto push = [&](float px, float py, float pz, float u, float v, float shade)
+        float shades[7];
+        for (int f = 0; f < 6; ++f)
+            shades[f] = faceLight(FACE_DIRS[f][0], FACE_DIRS[f][1], FACE_DIRS[f][2], emissive);
+        shades[TEMPLATE_UNLIT] = 1.0f;
+        std::array<float, 3> tints[7];
+        for (int f = 0; f < 7; ++f)
         {
-            float r = std::clamp(br * shade, 0.0f, 1.0f);
-            float g = std::clamp(bg * shade, 0.0f, 1.0f);
-            float b = std::clamp(bb * shade, 0.0f, 1.0f);
-            mesh.verts.push_back(Vertex{px, py, pz, u, v, r, g, b});
-        };
-
-        float sPX = faceLight(1, 0, 0, emissive);
-        float sNX = faceLight(-1, 0, 0, emissive);
-        float sPY = faceLight(0, 1, 0, emissive);
-        float sNY = faceLight(0, -1, 0, emissive);
-        float sPZ = faceLight(0, 0, 1, emissive);
-        float sNZ = faceLight(0, 0, -1, emissive);
-
-        push(maxX, minY, minZ, u1, v1, sPX);
-        push(maxX, maxY, minZ, u1, v0, sPX);
-        push(maxX, maxY, maxZ, u0, v0, sPX);
-        push(maxX, minY, maxZ, u0, v1, sPX);
-
-        push(minX, minY, minZ, u1, v1, sNX);
-        push(minX, minY, maxZ, u0, v1, sNX);
-        push(minX, maxY, maxZ, u0, v0, sNX);
-        push(minX, maxY, minZ, u1, v0, sNX);
-
-        push(minX, maxY, minZ, u1, v1, sPY);
-        push(maxX, maxY, minZ, u0, v1, sPY);
-        push(maxX, maxY, maxZ, u0, v0, sPY);
-        push(minX, maxY, maxZ, u1, v0, sPY);
-
-        push(minX, minY, minZ, u1, v1, sNY);
-        push(maxX, minY, minZ, u0, v1, sNY);
-        push(maxX, minY, maxZ, u0, v0, sNY);
-        push(minX, minY, maxZ, u1, v0, sNY);
-
-        push(minX, minY, maxZ, u1, v1, sPZ);
-        push(maxX, minY, maxZ, u0, v1, sPZ);
-        push(maxX, maxY, maxZ, u0, v0, sPZ);
-        push(minX, maxY, maxZ, u1, v0, sPZ);
-
-        push(minX, minY, minZ, u1, v1, sNZ);
-        push(minX, maxY, minZ, u1, v0, sNZ);
-        push(maxX, maxY, minZ, u0, v0, sNZ);
-        push(maxX, minY, minZ, u0, v1, sNZ);
+            for (int c = 0; c < 3; ++c)
+                tints[f][c] = std::clamp(col[c] * shades[f], 0.0f, 1.0f);
+        }
+        const float ox = static_cast<float>(x);
+        const float oy = static_cast<float>(y);
+        const float oz = static_cast<float>(z);
+        size_t base = verts.size();
+        verts.resize(base + t.size());
+        Vertex *out = verts.data() + base;
+        for (size_t i = 0; i < t.size(); ++i)
+        {
+            const TemplateVertex &tv = t[i];
+            const auto &tint = tints[tv.shade];
+            out[i] = Vertex{ox + tv.x, oy + tv.y, oz + tv.z, tv.u, tv.v, tint[0], tint[1], tint[2]};
+        }
     };
 
     for (int y = y0; y < y1; ++y)
     {
         for (int z = z0; z < z1; ++z)
         {
+            // Exposed faces of the whole row at once: a face shows unless the neighbour occludes, and
+            // glass hides faces against glass. Bit px of each mask is the voxel at x0 - 1 + px.
+            const int py = y - y0 + 1;
+            const int pz = z - z0 + 1;
+            const uint32_t occ = occRows[py * PAD_SIZE + pz];
+            const uint32_t glass = glassRows[py * PAD_SIZE + pz];
+            auto exposed = [&](uint32_t nOcc, uint32_t nGlass)
+            { return ~nOcc & ~(glass & nGlass); };
+            const uint32_t faceMask[6] = {
+                exposed(occ << 1, glass << 1),
+                exposed(occ >> 1, glass >> 1),
+                exposed(occRows[(py - 1) * PAD_SIZE + pz], glassRows[(py - 1) * PAD_SIZE + pz]),
+                exposed(occRows[(py + 1) * PAD_SIZE + pz], glassRows[(py + 1) * PAD_SIZE + pz]),
+                exposed(occRows[py * PAD_SIZE + pz - 1], glassRows[py * PAD_SIZE + pz - 1]),
+                exposed(occRows[py * PAD_SIZE + pz + 1], glassRows[py * PAD_SIZE + pz + 1]),
+            };
             for (int x = x0; x < x1; ++x)
             {
-                BlockType b = world.get(x, y, z);
+                BlockType b = pad.type(x - x0 + 1, py, pz);
                 if (b == BlockType::Air)
                     continue;
-                auto color = BLOCKS.at(b).color;
+                const BlockTraits &traits = blockTraits(b);
+                auto color = traits.color;
                 float brightness = 0.9f - (y / float(world.getHeight())) * 0.3f;
                 color[0] *= brightness;
                 color[1] *= brightness;
                 color[2] *= brightness;
-                if (b == BlockType::Grass)
-                {
-                    color[0] = brightness;
-                    color[1] = brightness;
-                    color[2] = brightness;
-                }
-                else if (b == BlockType::Dirt)
+                if (traits.colorInTile)
                 {
                     color[0] = brightness;
                     color[1] = brightness;
                     color[2] = brightness;
                 }
                 float emissive = 0.0f;
-                if (b == BlockType::Led && world.getPower(x, y, z))
-                {
-                    color[0] = std::min(color[0] * 1.6f, 1.0f);
-                    color[1] = std::min(color[1] * 1.4f, 1.0f);
-                    color[2] = std::min(color[2] * 1.1f, 1.0f);
-                    emissive = 0.25f;
-                }
-                else if (b == BlockType::Led)
-                {
-                    const float desat = 0.12f;
-                    color[0] = std::min(color[0] * 0.25f + desat, 1.0f);
-                    color[1] = std::min(color[1] * 0.25f + desat, 1.0f);
-                    color[2] = std::min(color[2] * 0.25f + desat, 1.0f);
-                }
-                else if (b == BlockType::Wire && world.getPower(x, y, z))
+                bool powered = traits.look != PowerLook::None && world.getPower(x, y, z);
+                switch (traits.look)
                 {
-                    color[0] = std::min(color[0] * 0.7f + 0.35f, 1.0f);
-                    color[1] = std::min(color[1] * 0.7f + 0.55f, 1.0f);
-                    color[2] = std::min(color[2] * 0.7f + 0.75f, 1.0f);
-                    emissive = 0.6f;
-                }
-                else if (b == BlockType::DFlipFlop && world.getPower(x, y, z))
-                {
-                    color[0] = std::min(color[0] + 0.16f, 1.0f);
-                    color[1] = std::min(color[1] + 0.08f, 1.0f);
-                    color[2] = std::min(color[2] + 0.08f, 1.0f);
-                    emissive = 0.08f;
-                }
-                else if (b == BlockType::AddGate)
-                {
-                    // no persistent power, but give a mild accent when adjacent wire powers it
-                    if (world.getPower(x - 1, y, z) || world.getPower(x + 1, y, z) || world.getPower(x, y, z - 1))
+                case PowerLook::Lamp:
+                    if (powered)
                     {
-                        color[0] = std::min(color[0] + 0.08f, 1.0f);
-                        color[1] = std::min(color[1] + 0.08f, 1.0f);
-                        color[2] = std::min(color[2] + 0.05f, 1.0f);
+                        color[0] = std::min(color[0] * 1.6f, 1.0f);
+                        color[1] = std::min(color[1] * 1.4f, 1.0f);
+                        color[2] = std::min(color[2] * 1.1f, 1.0f);
+                        emissive = traits.emissive;
                     }
-                }
-                int tIdx = tileIndexFor(b);
-                auto faceTile = [&](int nx, int ny, int nz)
-                {
-                    (void)nx;
-                    (void)nz;
-                    if (ny == 1 && b == BlockType::Grass)
-                        return gGrassTopTile;
-                    if (ny == -1 && b == BlockType::Grass)
-                        return gBlockTile[BlockType::Dirt];
-                    if (ny == 1)
+                    else
                     {
-                        if (b == BlockType::AndGate)
-                            return gAndTopTile;
-                        if (b == BlockType::OrGate)
-                            return gOrTopTile;
-                        if (b == BlockType::NotGate)
-                            return gNotTopTile;
-                        if (b == BlockType::XorGate)
-                            return gXorTopTile;
-                        if (b == BlockType::DFlipFlop)
-                            return gDffTopTile;
-                        if (b == BlockType::AddGate)
-                            return gAddTopTile;
-                        if (b == BlockType::Counter)
-                            return gCounterTopTile;
-                        if (b == BlockType::Splitter)
-                            return gSplitterTopTile;
-                        if (b == BlockType::Merger)
-                            return gMergerTopTile;
-                        if (b == BlockType::Decoder)
-                            return gDecoderTopTile;
-                        if (b == BlockType::Comparator)
-                            return gComparatorTopTile;
-                        if (b == BlockType::Clock)
-                            return gClockTopTile;
-                        if (b == BlockType::Multiplexer)
-                            return gMuxTopTile;
+                        const float desat = 0.12f;
+                        color[0] = std::min(color[0] * 0.25f + desat, 1.0f);
+                        color[1] = std::min(color[1] * 0.25f + desat, 1.0f);
+                        color[2] = std::min(color[2] * 0.25f + desat, 1.0f);
                     }
-                    if (ny == -1 && b == BlockType::AddGate)
-                        return gAddBottomTile;
-                    if (nz == -1 && b == BlockType::AddGate)
-                        return gAddBackTile;
-                    if (b == BlockType::Comparator)
+                    break;
+                case PowerLook::Wire:
+                    if (powered)
                     {
-                        if (nx == -1)
-                            return gComparatorInLeftTile;
-                        if (nx == 1)
-                            return gComparatorInRightTile;
-                        if (nz == -1)
-                            return gComparatorGtTile;
-                        if (nz == 1)
-                            return gComparatorEqTile;
-                        if (ny == -1)
-                            return gComparatorLtTile;
+                        color[0] = std::min(color[0] * 0.7f + 0.35f, 1.0f);
+                        color[1] = std::min(color[1] * 0.7f + 0.55f, 1.0f);
+                        color[2] = std::min(color[2] * 0.7f + 0.75f, 1.0f);
+                        emissive = traits.emissive;
                     }
-                    if (b == BlockType::Multiplexer)
+                    break;
+                case PowerLook::Latch:
+                    if (powered)
                     {
-                        if (nz == -1)
-                            return gMuxInTile[0];
-                        if (nz == 1)
-                            return gMuxInTile[1];
-                        if (ny == -1)
-                            return gMuxInTile[2];
-                        if (ny == 1)
-                            return gMuxInTile[3];
+                        color[0] = std::min(color[0] + 0.16f, 1.0f);
+                        color[1] = std::min(color[1] + 0.08f, 1.0f);
+                        color[2] = std::min(color[2] + 0.08f, 1.0f);
+                        emissive = traits.emissive;
                     }
-                    return tIdx;
-                };
+                    break;
+                case PowerLook::Adder:
+                {
+                    // no persistent power, but give a mild accent when a neighbouring input is powered
+                    const auto &in = traits.ports.in;
+                    bool inputPowered = false;
+                    for (int8_t f : in)
+                    {
+                        if (f != NO_PORT && world.getPower(x + FACE_DIRS[f][0], y + FACE_DIRS[f][1], z + FACE_DIRS[f][2]))
+                            inputPowered = true;
+                    }
+                    if (inputPowered)
+                    {
+                        color[0] = std::min(color[0] + 0.08f, 1.0f);
+                        color[1] = std::min(color[1] + 0.08f, 1.0f);
+                        color[2] = std::min(color[2] + 0.05f, 1.0f);
+                    }
+                    break;
+                }
+                case PowerLook::None:
+                    break;
+                }
                 if (b == BlockType::Wire)
                 {
+                    // a stub toward each neighbour with a port (or any face, for wires/buttons/LEDs) facing us
                     auto connects = [&](int dx, int dy, int dz)
                     {
                         int xx = x + dx;
                         int yy = y + dy;
                         int zz = z + dz;
-                        if (!world.inside(xx, yy, zz))
-                            return false;
-                        BlockType nb = world.get(xx, yy, zz);
-                        if (nb == BlockType::NotGate)
-                        {
-                            // Only connect on right (input) or left (output) sides
-                            if (dx == 1)
-                                return true; // input side
-                            if (dx == -1)
-                                return true; // output side
-                            return false;
-                        }
-                        if (nb == BlockType::Counter)
-                        {
-                            // Counter input is on its +X face, so from the wire perspective the counter is at dx = -1
-                            return dx == -1;
-                        }
-                        if (nb == BlockType::AndGate || nb == BlockType::OrGate || nb == BlockType::XorGate ||
-                            nb == BlockType::DFlipFlop || nb == BlockType::AddGate)
-                        {
-                            // Inputs on left/right, Cin on -Z, Sum on +Z, Cout on -Y (top face is non-connectable)
-                            if (dx == 1 || dx == -1)
-                                return true; // P/Q
-                            if (dz == -1)
-                                return true; // Cin
-                            if (dz == 1)
-                                return true; // Sum
-                            if (dy == 1)
-                                return true; // Cout (wire is below, gate above)
-                            if (dy == -1)
-                                return false; // top blocked
-                            if (nb == BlockType::Counter)
-                            {
-                                // only +X input
-                                return dx == 1;
-                            }
-                            return false;
-                        }
-                        if (nb == BlockType::Splitter)
-                        {
-                            // BUS on -Z (in), B1 on -X (out), B2 on +X (out)
-                            if (dx == -1 || dx == 1)
-                                return true;
-                            if (dz == 1)
-                                return true; // BUS side (wire is at z-1, so from wire view dz=+1)
-                            return false;
-                        }
-                        if (nb == BlockType::Merger)
-                        {
-                            // B1 on -X (in), B2 on +X (in), BUS on +Z (out)
-                            if (dx == -1 || dx == 1)
-                                return true; // inputs
-                            if (dz == -1)
-                                return true; // BUS side (+Z face of merger)
-                            return false;
-                        }
-                        if (nb == BlockType::Decoder)
-                        {
-                            // SEL on -X (in), EN on +X (in), OUT on +Z
-                            if (dx == -1 || dx == 1)
-                                return true;
-                            if (dz == -1)
-                                return true; // OUT (+Z)
-                            return false;
-                        }
-                        if (nb == BlockType::Multiplexer)
-                        {
-                            // SEL on -X, OUT on +X, D0 on -Z, D1 on +Z, D2 on -Y, D3 on +Y
-                            if (dx == -1 || dx == 1)
-                                return true;
-                            if (dz == -1 || dz == 1)
-                                return true;
-                            if (dy == -1 || dy == 1)
-                                return true;
-                            return false;
-                        }
-                        if (nb == BlockType::Clock)
-                        {
-                            // Output on +Z only
-                            return dz == -1;
-                        }
-                        if (nb == BlockType::Comparator)
-                        {
-                            // Inputs on -X/+X, outputs: > on -Z, = on +Z, < on -Y. Top (+Y) not connectable.
-                            if (dy == -1)
-                                return false; // top blocked
-                            if (dx == -1 || dx == 1)
-                                return true; // inputs
-                            if (dz == -1 || dz == 1)
-                                return true; // front/back outputs
-                            if (dy == 1)
-                                return true; // downward output
-                            return false;
-                        }
-                        return nb == BlockType::Wire || nb == BlockType::Button || nb == BlockType::Led ||
-                               nb == BlockType::AndGate || nb == BlockType::OrGate || nb == BlockType::DFlipFlop ||
-                               nb == BlockType::Counter;
+                        return connectsOnFace(typeAt(xx, yy, zz), faceFromNormal(-dx, -dy, -dz));
                     };
 
-                    float cx = static_cast<float>(x) + 0.5f;
-                    float cy = static_cast<float>(y) + 0.5f;
-                    float cz = static_cast<float>(z) + 0.5f;
-                    const float half = 0.12f;
-                    const float margin = 0.04f;
-                    const float join = 0.002f;
-
-                    addWireBox(cx - half, cy - half, cz - half, cx + half, cy + half, cz + half, color, tIdx, emissive);
-                    if (connects(1, 0, 0))
-                        addWireBox(cx + join, cy - half, cz - half, static_cast<float>(x + 1) - margin, cy + half, cz + half,
-                                   color, tIdx, emissive);
-                    if (connects(-1, 0, 0))
-                        addWireBox(static_cast<float>(x) + margin, cy - half, cz - half, cx - join, cy + half, cz + half, color,
-                                   tIdx, emissive);
-                    if (connects(0, 1, 0))
-                        addWireBox(cx - half, cy + join, cz - half, cx + half, static_cast<float>(y + 1) - margin, cz + half,
-                                   color, tIdx, emissive);
-                    if (connects(0, -1, 0))
-                        addWireBox(cx - half, static_cast<float>(y) + margin, cz - half, cx + half, cy - join, cz + half, color,
-                                   tIdx, emissive);
-                    if (connects(0, 0, 1))
-                        addWireBox(cx - half, cy - half, cz + join, cx + half, cy + half, static_cast<float>(z + 1) - margin,
-                                   color, tIdx, emissive);
-                    if (connects(0, 0, -1))
-                        addWireBox(cx - half, cy - half, static_cast<float>(z) + margin, cx + half, cy + half, cz - join, color,
-                                   tIdx, emissive);
+                    int mask = 0;
+                    for (int f = 0; f < 6; ++f)
+                    {
+                        if (connects(FACE_DIRS[f][0], FACE_DIRS[f][1], FACE_DIRS[f][2]))
+                            mask |= 1 << f;
+                    }
+                    addTemplate(wireTemplate(mask), x, y, z, color, emissive);
                     continue;
                 }
 
@@ -1608,39 +1636,15 @@ void buildChunkMesh(const World &world, int cx, int cy, int cz)
                     float cx = static_cast<float>(x) + 0.5f;
                     float cz = static_cast<float>(z) + 0.5f;
                     float baseY = static_cast<float>(y);
-                    float boardW = 0.9f;
-                    float boardH = 0.6f;
-                    float boardT = 0.08f;
-                    float poleW = 0.12f;
-                    float poleH = 0.6f;
-                    float halfBoardW = boardW * 0.5f;
-                    float halfBoardH = boardH * 0.5f;
-                    float halfBoardT = boardT * 0.5f;
-                    float halfPoleW = poleW * 0.5f;
-
-                    float boardMinX = cx - halfBoardW;
-                    float boardMaxX = cx + halfBoardW;
-                    float boardMinY = baseY + 0.8f - halfBoardH;
-                    float boardMaxY = baseY + 0.8f + halfBoardH;
-                    float boardMinZ = cz - halfBoardT;
-                    float boardMaxZ = cz + halfBoardT;
-
-                    float poleMinX = cx - halfPoleW;
-                    float poleMaxX = cx + halfPoleW;
-                    float poleMinY = baseY + 0.1f;
-                    float poleMaxY = baseY + 0.1f + poleH;
-                    float poleMinZ = cz - halfPoleW;
-                    float poleMaxZ = cz + halfPoleW;
-
-                    int tile = tileIndexFor(b);
-                    auto addBoxWithTile = [&](float minX, float minY, float minZ, float maxX, float maxY, float maxZ)
-                    {
-                        addBox(minX, minY, minZ, maxX, maxY, maxZ, color, tile);
-                    };
+                    float boardW = SIGN_BOARD_W;
+                    float boardH = SIGN_BOARD_H;
+                    float boardMinY = baseY + SIGN_BOARD_Y - boardH * 0.5f;
+                    float boardMaxY = baseY + SIGN_BOARD_Y + boardH * 0.5f;
+                    float boardMinZ = cz - SIGN_BOARD_T * 0.5f;
+                    float boardMaxZ = cz + SIGN_BOARD_T * 0.5f;
 
                     // Board + pole
-                    addBoxWithTile(boardMinX, boardMinY, boardMinZ, boardMaxX, boardMaxY, boardMaxZ);
-                    addBoxWithTile(poleMinX, poleMinY, poleMinZ, poleMaxX, poleMaxY, poleMaxZ);
+                    addTemplate(signTemplate(), x, y, z, color, 0.0f);
 
                     // Text drawn slightly in front of the board (both faces), up to 4 lines of 16 chars
                     const std::string &txt = world.getSignText(x, y, z);
@@ -1710,7 +1714,8 @@ void buildChunkMesh(const World &world, int cx, int cy, int cz)
 
                         std::array<float, 3> textColor = {0.15f, 0.07f, 0.02f};
 
-                        auto drawTextSide = [&](float zFront, float zBack, bool mirrorX)
+                        // One textured quad per character and side, sampling the glyph cell of the atlas
+                        auto drawTextSide = [&](float z, bool mirrorX)
                         {
                             for (int li = 0; li < static_cast<int>(lines.size()); ++li)
                             {
@@ -1728,43 +1733,40 @@ void buildChunkMesh(const World &world, int cx, int cy, int cz)
                                 for (size_t i = 0; i < line.size(); ++i)
                                 {
                                     char c = static_cast<char>(std::toupper(static_cast<unsigned char>(line[i])));
-                                    auto it = FONT5x4.find(c);
-                                    if (it == FONT5x4.end())
+                                    float u0, v0, u1, v1;
+                                    if (!atlasGlyphRect(c, u0, v0, u1, v1))
                                         continue;
 
                                     float charOffsetUnits =
                                         static_cast<float>(i) * (static_cast<float>(glyphCols) + spacingCols);
-                                    float charMinX = lineMinX + charOffsetUnits * cell;
-
-                                    const auto &rows = it->second;
-                                    for (int row = 0; row < glyphRows; ++row)
+                                    float px0 = lineMinX + charOffsetUnits * cell;
+                                    float px1 = px0 + glyphCols * cell;
+                                    if (mirrorX)
                                     {
-                                        uint8_t mask = rows[row];
-                                        for (int col = 0; col < glyphCols; ++col)
-                                        {
-                                            if (!(mask & (1u << (glyphCols - 1 - col))))
-                                                continue;
-                                            float px0 = charMinX + static_cast<float>(col) * cell;
-                                            float px1 = px0 + cell;
-                                            if (mirrorX)
-                                            {
-                                                float d0 = px0 - cx;
-                                                float d1 = px1 - cx;
-                                                px0 = cx - d1;
-                                                px1 = cx - d0;
-                                            }
-                                            float py1 = lineMaxY - static_cast<float>(row) * cell;
-                                            float py0 = py1 - cell;
-                                            addBox(px0, py0, zFront, px1, py1, zBack, textColor, tile);
-                                        }
+                                        float d0 = px0 - cx;
+                                        float d1 = px1 - cx;
+                                        px0 = cx - d1;
+                                        px1 = cx - d0;
+                                        std::swap(u0, u1);
                                     }
+                                    float py1 = lineMaxY;
+                                    float py0 = py1 - glyphRows * cell;
+                                    auto push = [&](float px, float py, float u, float v)
+                                    {
+                                        verts.push_back(
+                                            Vertex{px, py, z, u, v, textColor[0], textColor[1], textColor[2]});
+                                    };
+                                    push(px0, py0, u0, v1);
+                                    push(px1, py0, u1, v1);
+                                    push(px1, py1, u1, v0);
+                                    push(px0, py1, u0, v0);
                                 }
                             }
                         };
 
                         // Front (+Z) and back (-Z, mirrored)
-                        drawTextSide(boardMaxZ + 0.002f, boardMaxZ + 0.004f, false);
-                        drawTextSide(boardMinZ - 0.004f, boardMinZ - 0.002f, true);
+                        drawTextSide(boardMaxZ + 0.003f, false);
+                        drawTextSide(boardMinZ - 0.003f, true);
                     }
 
                 after_sign_text:
@@ -1772,45 +1774,417 @@ void buildChunkMesh(const World &world, int cx, int cy, int cz)
                 }
 
                 bool isGlass = (b == BlockType::Glass);
-                auto neighborIsGlass = [&](int nx, int ny, int nz)
+                const uint32_t bit = 1u << (x - x0 + 1);
+                for (int f = 0; f < 6; ++f)
                 {
-                    if (!world.inside(nx, ny, nz))
-                        return false;
-                    return world.get(nx, ny, nz) == BlockType::Glass;
-                };
-
-                if (x == 0 || (!occludesFaces(world.get(x - 1, y, z)) && !(isGlass && neighborIsGlass(x - 1, y, z))))
-                    addFace(x, y, z, -1, 0, 0, color, faceTile(-1, 0, 0), emissive, isGlass);
-                if (x == world.getWidth() - 1 ||
-                    (!occludesFaces(world.get(x + 1, y, z)) && !(isGlass && neighborIsGlass(x + 1, y, z))))
-                    addFace(x, y, z, 1, 0, 0, color, faceTile(1, 0, 0), emissive, isGlass);
-                if (y == 0 || (!occludesFaces(world.get(x, y - 1, z)) && !(isGlass && neighborIsGlass(x, y - 1, z))))
-                    addFace(x, y, z, 0, -1, 0, color, faceTile(0, -1, 0), emissive, isGlass);
-                if (y == world.getHeight() - 1 ||
-                    (!occludesFaces(world.get(x, y + 1, z)) && !(isGlass && neighborIsGlass(x, y + 1, z))))
-                    addFace(x, y, z, 0, 1, 0, color, faceTile(0, 1, 0), emissive, isGlass);
-                if (z == 0 || (!occludesFaces(world.get(x, y, z - 1)) && !(isGlass && neighborIsGlass(x, y, z - 1))))
-                    addFace(x, y, z, 0, 0, -1, color, faceTile(0, 0, -1), emissive, isGlass);
-                if (z == world.getDepth() - 1 ||
-                    (!occludesFaces(world.get(x, y, z + 1)) && !(isGlass && neighborIsGlass(x, y, z + 1))))
-                    addFace(x, y, z, 0, 0, 1, color, faceTile(0, 0, 1), emissive, isGlass);
+                    if (faceMask[f] & bit)
+                        addFace(x, y, z, FACE_DIRS[f][0], FACE_DIRS[f][1], FACE_DIRS[f][2], color, traits.faceTiles[f],
+                                emissive, isGlass);
+                }
             }
         }
     }
 
-    ensureVbo(mesh.vbo);
-    ensureVbo(mesh.glassVbo);
-    if (!mesh.verts.empty())
+    finishChunkMesh(mesh, pad, verts, glassVerts);
+    mesh.lod = false;
+}
+
+// Cheap mesh for far chunks: greedy-merged faces in flat block colors, no AO, no textures, no sign text or
+// wire geometry. Logic blocks become plain cubes; glass keeps its own (sorted) pass.
+void buildChunkLodMesh(const World &world, int cx, int cy, int cz)
+{
+    int idx = chunkIndex(cx, cy, cz);
+    if (idx < 0)
+        return;
+    ChunkMesh &mesh = chunkMeshes[idx];
+    static std::vector<Vertex> verts;
+    static std::vector<Vertex> glassVerts;
+    static std::vector<int> mask;
+    verts.clear();
+    glassVerts.clear();
+    static PaddedChunk pad;
+    fillPaddedChunk(world, cx, cy, cz, pad);
+    const int *origin = pad.origin;
+    const int *size = pad.size;
+
+    float whiteU = 0.0f;
+    float whiteV = 0.0f;
+    atlasWhiteTexel(whiteU, whiteV);
+    // glass samples one texel of its own tile so it keeps the tile's alpha
+    int glassTile = blockTraits(BlockType::Glass).tile;
+    float glassU = ((glassTile % ATLAS_COLS) + 0.5f) / ATLAS_COLS;
+    float glassV = ((glassTile / ATLAS_COLS) + 0.5f) / ATLAS_ROWS;
+
+    auto lodDrawn = [](BlockType b)
+    { return b == BlockType::Glass || occludesFaces(b); };
+    auto faceVisible = [&](BlockType b, const int *p)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-        glBufferData(GL_ARRAY_BUFFER, mesh.verts.size() * sizeof(Vertex), mesh.verts.data(), GL_STATIC_DRAW);
+        BlockType n = pad.type(p[0], p[1], p[2]);
+        if (occludesFaces(n))
+            return false;
+        return !(b == BlockType::Glass && n == BlockType::Glass);
+    };
+
+    const float lightLen = std::sqrt(0.45f * 0.45f + 0.85f * 0.85f + 0.35f * 0.35f);
+    const float light[3] = {-0.45f / lightLen, 0.85f / lightLen, -0.35f / lightLen};
+
+    for (int d = 0; d < 3; ++d)
+    {
+        const int u = (d + 1) % 3;
+        const int v = (d + 2) % 3;
+        mask.assign(static_cast<size_t>(size[u] * size[v]), 0);
+        for (int side = -1; side <= 1; side += 2)
+        {
+            // same directional term as the full mesher, minus AO
+            float shade = 0.35f + 0.65f * std::clamp(side * light[d] * 0.6f + 0.4f, 0.0f, 1.0f);
+            if (d == 1)
+                shade *= side > 0 ? 1.05f : 0.92f;
+            shade = std::clamp(shade, 0.2f, 1.2f);
+            for (int slice = 0; slice < size[d]; ++slice)
+            {
+                // mask cell = block type + 1 where that face is exposed
+                for (int b = 0; b < size[v]; ++b)
+                {
+                    for (int a = 0; a < size[u]; ++a)
+                    {
+                        int p[3]; // padded coordinates
+                        p[d] = slice + 1;
+                        p[u] = a + 1;
+                        p[v] = b + 1;
+                        BlockType bt = pad.type(p[0], p[1], p[2]);
+                        int m = 0;
+                        if (lodDrawn(bt))
+                        {
+                            p[d] += side;
+                            if (faceVisible(bt, p))
+                                m = static_cast<int>(bt) + 1;
+                        }
+                        mask[b * size[u] + a] = m;
+                    }
+                }
+                // greedy merge equal cells into rectangles
+                for (int b = 0; b < size[v]; ++b)
+                {
+                    for (int a = 0; a < size[u];)
+                    {
+                        int m = mask[b * size[u] + a];
+                        if (m == 0)
+                        {
+                            ++a;
+                            continue;
+                        }
+                        int w = 1;
+                        while (a + w < size[u] && mask[b * size[u] + a + w] == m)
+                            ++w;
+                        int h = 1;
+                        for (; b + h < size[v]; ++h)
+                        {
+                            bool rowMatches = true;
+                            for (int k = 0; k < w && rowMatches; ++k)
+                                rowMatches = mask[(b + h) * size[u] + a + k] == m;
+                            if (!rowMatches)
+                                break;
+                        }
+                        for (int row = 0; row < h; ++row)
+                            std::fill_n(mask.begin() + (b + row) * size[u] + a, w, 0);
+
+                        BlockType bt = static_cast<BlockType>(m - 1);
+                        bool glass = bt == BlockType::Glass;
+                        const auto &col = blockTraits(bt).color;
+                        float plane = static_cast<float>(origin[d] + slice + (side > 0 ? 1 : 0));
+                        float corners[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+                        auto &out = glass ? glassVerts : verts;
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            // counter-clockwise seen from the side the face points to
+                            int ci = side > 0 ? c : 3 - c;
+                            float pos[3];
+                            pos[d] = plane;
+                            pos[u] = static_cast<float>(origin[u] + a) + corners[ci][0] * w;
+                            pos[v] = static_cast<float>(origin[v] + b) + corners[ci][1] * h;
+                            out.push_back(Vertex{pos[0], pos[1], pos[2], glass ? glassU : whiteU, glass ? glassV : whiteV,
+                                                 col[0] * shade, col[1] * shade, col[2] * shade});
+                        }
+                        a += w;
+                    }
+                }
+            }
+        }
     }
-    if (!mesh.glassVerts.empty())
+
+    finishChunkMesh(mesh, pad, verts, glassVerts);
+    mesh.lod = true;
+}
+
+void sortGlassFaces(ChunkMesh &mesh, float camX, float camY, float camZ)
+{
+    if (mesh.glassCenters.empty())
+        return;
+    // Glass faces are axis aligned, so their order only changes when the camera crosses into another
+    // chunk or another octant of its chunk: key the sort on the camera's half-chunk cell.
+    const float half = CHUNK_SIZE * 0.5f;
+    int64_t hx = static_cast<int64_t>(std::floor(camX / half)) & 0xFFFFF;
+    int64_t hy = static_cast<int64_t>(std::floor(camY / half)) & 0xFFFFF;
+    int64_t hz = static_cast<int64_t>(std::floor(camZ / half)) & 0xFFFFF;
+    int64_t key = (hx << 40) | (hy << 20) | hz;
+    if (key == mesh.glassSortKey && !mesh.glassOrder.empty())
+        return;
+
+    size_t quads = mesh.glassCenters.size() / 3;
+    std::vector<std::pair<float, GLuint>> order(quads);
+    for (size_t q = 0; q < quads; ++q)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, mesh.glassVbo);
-        glBufferData(GL_ARRAY_BUFFER, mesh.glassVerts.size() * sizeof(Vertex), mesh.glassVerts.data(), GL_STATIC_DRAW);
+        float dx = mesh.glassCenters[q * 3] - camX;
+        float dy = mesh.glassCenters[q * 3 + 1] - camY;
+        float dz = mesh.glassCenters[q * 3 + 2] - camZ;
+        order[q] = {dx * dx + dy * dy + dz * dz, static_cast<GLuint>(q)};
     }
-    mesh.dirty = false;
+    std::sort(order.begin(), order.end(), [](const std::pair<float, GLuint> &a, const std::pair<float, GLuint> &b)
+              { return a.first > b.first; });
+
+    mesh.glassOrder.resize(quads * 6);
+    for (size_t i = 0; i < quads; ++i)
+    {
+        GLuint base = order[i].second * 4;
+        mesh.glassOrder[i * 6 + 0] = base;
+        mesh.glassOrder[i * 6 + 1] = base + 1;
+        mesh.glassOrder[i * 6 + 2] = base + 2;
+        mesh.glassOrder[i * 6 + 3] = base;
+        mesh.glassOrder[i * 6 + 4] = base + 2;
+        mesh.glassOrder[i * 6 + 5] = base + 3;
+    }
+    mesh.glassSortKey = key;
+}
+
+Frustum frustumFromMatrix(const Mat4 &viewProj)
+{
+    // Gribb/Hartmann: planes are sums/differences of the clip matrix rows
+    const float *m = viewProj.m;
+    auto row = [&](int r, int c)
+    { return m[c * 4 + r]; };
+    Frustum f{};
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            f.planes[i * 2][c] = row(3, c) + row(i, c);
+            f.planes[i * 2 + 1][c] = row(3, c) - row(i, c);
+        }
+    }
+    return f;
+}
+
+bool aabbInFrustum(const Frustum &f, const float *mn, const float *mx)
+{
+    for (const auto &p : f.planes)
+    {
+        // test the box corner furthest along the plane normal
+        float x = p[0] >= 0.0f ? mx[0] : mn[0];
+        float y = p[1] >= 0.0f ? mx[1] : mn[1];
+        float z = p[2] >= 0.0f ? mx[2] : mn[2];
+        if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+void gatherVisibleChunks(float camX, float camY, float camZ, const Frustum &frustum, float viewDist,
+                         std::vector<VisibleChunk> &out)
+{
+    out.clear();
+    gRemeshQueue.clear();
+    gChunkStats = {};
+    const int total = CHUNK_X_COUNT * CHUNK_Y_COUNT * CHUNK_Z_COUNT;
+
+    // 0 = in range, 1 = too far, 2 = outside the frustum. Tests the whole chunk box: an empty or
+    // dirty mesh has no useful tight bounds and must still let the flood fill pass through.
+    auto rangeTest = [&](int cX, int cY, int cZ, float &dist2)
+    {
+        float dx = (cX + 0.5f) * CHUNK_SIZE - camX;
+        float dy = (cY + 0.5f) * CHUNK_SIZE - camY;
+        float dz = (cZ + 0.5f) * CHUNK_SIZE - camZ;
+        dist2 = dx * dx + dy * dy + dz * dz;
+        if (dist2 > viewDist * viewDist)
+            return 1;
+        float fullMin[3] = {static_cast<float>(cX * CHUNK_SIZE), static_cast<float>(cY * CHUNK_SIZE),
+                            static_cast<float>(cZ * CHUNK_SIZE)};
+        float fullMax[3] = {fullMin[0] + CHUNK_SIZE, fullMin[1] + CHUNK_SIZE, fullMin[2] + CHUNK_SIZE};
+        return aabbInFrustum(frustum, fullMin, fullMax) ? 0 : 2;
+    };
+    // Far chunks use the LOD mesh. Two thresholds so a chunk near the boundary doesn't remesh every frame.
+    const float lodEnter2 = (viewDist * LOD_ENTER_FRACTION) * (viewDist * LOD_ENTER_FRACTION);
+    const float lodLeave2 = (viewDist * LOD_LEAVE_FRACTION) * (viewDist * LOD_LEAVE_FRACTION);
+    // queues a rebuild for a dirty (or wrong-detail) chunk; its current mesh keeps drawing until then
+    auto requestRemesh = [&](int idx, float dist2, bool visible)
+    {
+        const ChunkMesh &cm = chunkMeshes[idx];
+        bool wantLod = cm.lod ? dist2 > lodLeave2 : dist2 > lodEnter2;
+        if (cm.dirty || wantLod != cm.lod)
+            gRemeshQueue.push_back({idx, dist2, visible, wantLod});
+    };
+    // in range but outside the frustum: rebuilt after the visible chunks, so turning around shows current meshes
+    auto reject = [&](int cX, int cY, int cZ, int result, float dist2)
+    {
+        if (result == 1)
+            ++gChunkStats.distanceCulled;
+        else
+        {
+            ++gChunkStats.frustumCulled;
+            requestRemesh(chunkIndex(cX, cY, cZ), dist2, false);
+        }
+    };
+    // queues the chunk for drawing if it has geometry
+    auto visit = [&](int cX, int cY, int cZ, float dist2)
+    {
+        int idx = chunkIndex(cX, cY, cZ);
+        const ChunkMesh &cm = chunkMeshes[idx];
+        requestRemesh(idx, dist2, true);
+        if (cm.range.count == 0 && cm.glassRange.count == 0)
+            return;
+        if (!aabbInFrustum(frustum, cm.boundsMin, cm.boundsMax))
+        {
+            ++gChunkStats.frustumCulled;
+            return;
+        }
+        out.push_back({idx, dist2});
+        if (cm.range.count > 0)
+            ++gChunkStats.drawn;
+        if (cm.glassRange.count > 0)
+            ++gChunkStats.glassDrawn;
+        if (cm.lod)
+            ++gChunkStats.lodDrawn;
+        gChunkStats.vertices += static_cast<size_t>(cm.range.count + cm.glassRange.count);
+    };
+
+    int camCX = static_cast<int>(std::floor(camX / CHUNK_SIZE));
+    int camCY = static_cast<int>(std::floor(camY / CHUNK_SIZE));
+    int camCZ = static_cast<int>(std::floor(camZ / CHUNK_SIZE));
+    int camIdx = chunkIndex(camCX, camCY, camCZ);
+    if (camIdx < 0)
+    {
+        // camera outside the chunk grid (flying above the world): no start chunk, test everything
+        for (int cY = 0; cY < CHUNK_Y_COUNT; ++cY)
+        {
+            for (int cZ = 0; cZ < CHUNK_Z_COUNT; ++cZ)
+            {
+                for (int cX = 0; cX < CHUNK_X_COUNT; ++cX)
+                {
+                    float dist2 = 0.0f;
+                    int result = rangeTest(cX, cY, cZ, dist2);
+                    if (result != 0)
+                        reject(cX, cY, cZ, result, dist2);
+                    else
+                        visit(cX, cY, cZ, dist2);
+                }
+            }
+        }
+    }
+    else
+    {
+        // Cave culling: flood out from the camera chunk. A chunk entered through face `entry` is only
+        // left through faces its open voxels connect to it, and never in a direction opposite to one
+        // already taken, so the walk always moves away from the camera.
+        struct Step
+        {
+            int cx, cy, cz;
+            int entry;
+            int dirs;
+        };
+        std::vector<uint8_t> reached(static_cast<size_t>(total), 0);
+        std::vector<Step> queue;
+        queue.reserve(static_cast<size_t>(total));
+        reached[camIdx] = 1;
+        float camDist2 = 0.0f;
+        rangeTest(camCX, camCY, camCZ, camDist2);
+        visit(camCX, camCY, camCZ, camDist2);
+        queue.push_back({camCX, camCY, camCZ, -1, 0});
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            Step s = queue[head];
+            const ChunkMesh &cm = chunkMeshes[chunkIndex(s.cx, s.cy, s.cz)];
+            for (int f = 0; f < 6; ++f)
+            {
+                if (s.dirs & (1 << (f ^ 1)))
+                    continue;
+                // a dirty chunk's links may be stale, so let the walk through until it is rebuilt
+                if (s.entry >= 0 && s.entry != f && !cm.dirty && !chunkFacesLinked(cm, s.entry, f))
+                    continue;
+                int nx = s.cx + FACE_DIRS[f][0];
+                int ny = s.cy + FACE_DIRS[f][1];
+                int nz = s.cz + FACE_DIRS[f][2];
+                int nIdx = chunkIndex(nx, ny, nz);
+                if (nIdx < 0 || reached[nIdx])
+                    continue;
+                reached[nIdx] = 1;
+                float dist2 = 0.0f;
+                int result = rangeTest(nx, ny, nz, dist2);
+                if (result != 0)
+                {
+                    reject(nx, ny, nz, result, dist2);
+                    continue;
+                }
+                visit(nx, ny, nz, dist2);
+                queue.push_back({nx, ny, nz, f ^ 1, s.dirs | (1 << f)});
+            }
+        }
+        // split the chunks the walk never reached into plain culls and ones hidden behind terrain
+        for (int cY = 0; cY < CHUNK_Y_COUNT; ++cY)
+        {
+            for (int cZ = 0; cZ < CHUNK_Z_COUNT; ++cZ)
+            {
+                for (int cX = 0; cX < CHUNK_X_COUNT; ++cX)
+                {
+                    if (reached[chunkIndex(cX, cY, cZ)])
+                        continue;
+                    float dist2 = 0.0f;
+                    int result = rangeTest(cX, cY, cZ, dist2);
+                    if (result != 0)
+                    {
+                        reject(cX, cY, cZ, result, dist2);
+                        continue;
+                    }
+                    ++gChunkStats.occlusionCulled;
+                    requestRemesh(chunkIndex(cX, cY, cZ), dist2, false);
+                }
+            }
+        }
+    }
+    // front-to-back so early depth rejection skips hidden fragments
+    std::sort(out.begin(), out.end(), [](const VisibleChunk &a, const VisibleChunk &b)
+              { return a.dist2 < b.dist2; });
+    gChunkStats.remeshQueued = static_cast<int>(gRemeshQueue.size());
+}
+
+int processRemeshQueue(const World &world, float budgetMs)
+{
+    // visible chunks first, nearest first within each group
+    std::sort(gRemeshQueue.begin(), gRemeshQueue.end(), [](const RemeshRequest &a, const RemeshRequest &b)
+              {
+                  if (a.visible != b.visible)
+                      return a.visible;
+                  return a.dist2 < b.dist2;
+              });
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const double budgetTicks = budgetMs * 0.001 * static_cast<double>(SDL_GetPerformanceFrequency());
+    int built = 0;
+    for (const RemeshRequest &r : gRemeshQueue)
+    {
+        // always at least one per frame so the queue drains even on a slow machine
+        if (built > 0 && static_cast<double>(SDL_GetPerformanceCounter() - start) >= budgetTicks)
+            break;
+        int cX = r.idx % CHUNK_X_COUNT;
+        int cZ = (r.idx / CHUNK_X_COUNT) % CHUNK_Z_COUNT;
+        int cY = r.idx / (CHUNK_X_COUNT * CHUNK_Z_COUNT);
+        if (r.lod)
+            buildChunkLodMesh(world, cX, cY, cZ);
+        else
+            buildChunkMesh(world, cX, cY, cZ);
+        ++built;
+    }
+    gRemeshQueue.clear();
+    gChunkStats.remeshed = built;
+    gChunkStats.remeshQueued -= built;
+    return built;
 }
 
 void drawNpcBlocky(const NPC &npc)
@@ -1826,34 +2200,34 @@ void drawNpcBlocky(const NPC &npc)
         float x0 = cx - hx, x1 = cx + hx;
         float y0 = cy - hy, y1 = cy + hy;
         float z0 = cz - hz, z1 = cz + hz;
-        glDisable(GL_TEXTURE_2D);
-        glColor3f(r, g, b);
-        glBegin(GL_QUADS);
-        glVertex3f(x0, y0, z1);
-        glVertex3f(x1, y0, z1);
-        glVertex3f(x1, y1, z1);
-        glVertex3f(x0, y1, z1);
-        glVertex3f(x1, y0, z0);
-        glVertex3f(x0, y0, z0);
-        glVertex3f(x0, y1, z0);
-        glVertex3f(x1, y1, z0);
-        glVertex3f(x0, y0, z0);
-        glVertex3f(x0, y0, z1);
-        glVertex3f(x0, y1, z1);
-        glVertex3f(x0, y1, z0);
-        glVertex3f(x1, y0, z1);
-        glVertex3f(x1, y0, z0);
-        glVertex3f(x1, y1, z0);
-        glVertex3f(x1, y1, z1);
-        glVertex3f(x0, y1, z1);
-        glVertex3f(x1, y1, z1);
-        glVertex3f(x1, y1, z0);
-        glVertex3f(x0, y1, z0);
-        glVertex3f(x0, y0, z0);
-        glVertex3f(x1, y0, z0);
-        glVertex3f(x1, y0, z1);
-        glVertex3f(x0, y0, z1);
-        glEnd();
+        gfxDisable(GL_TEXTURE_2D);
+        gfxColor3f(r, g, b);
+        gfxBegin(GL_QUADS);
+        gfxVertex3f(x0, y0, z1);
+        gfxVertex3f(x1, y0, z1);
+        gfxVertex3f(x1, y1, z1);
+        gfxVertex3f(x0, y1, z1);
+        gfxVertex3f(x1, y0, z0);
+        gfxVertex3f(x0, y0, z0);
+        gfxVertex3f(x0, y1, z0);
+        gfxVertex3f(x1, y1, z0);
+        gfxVertex3f(x0, y0, z0);
+        gfxVertex3f(x0, y0, z1);
+        gfxVertex3f(x0, y1, z1);
+        gfxVertex3f(x0, y1, z0);
+        gfxVertex3f(x1, y0, z1);
+        gfxVertex3f(x1, y0, z0);
+        gfxVertex3f(x1, y1, z0);
+        gfxVertex3f(x1, y1, z1);
+        gfxVertex3f(x0, y1, z1);
+        gfxVertex3f(x1, y1, z1);
+        gfxVertex3f(x1, y1, z0);
+        gfxVertex3f(x0, y1, z0);
+        gfxVertex3f(x0, y0, z0);
+        gfxVertex3f(x1, y0, z0);
+        gfxVertex3f(x1, y0, z1);
+        gfxVertex3f(x0, y0, z1);
+        gfxEnd();
     };
 
     auto drawColoredCube = [&](float cx, float cy, float cz, float size, float r, float g, float b)
@@ -1874,64 +2248,64 @@ void drawNpcBlocky(const NPC &npc)
             return;
         }
 
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, npc.texture);
-        glColor3f(1.0f, 1.0f, 1.0f);
-        glBegin(GL_QUADS);
+        gfxEnable(GL_TEXTURE_2D);
+        gfxBindTexture(npc.texture);
+        gfxColor3f(1.0f, 1.0f, 1.0f);
+        gfxBegin(GL_QUADS);
         // Front (+Z)
-        glTexCoord2f(0.0f, 1.0f);
-        glVertex3f(x0, y0, z1);
-        glTexCoord2f(1.0f, 1.0f);
-        glVertex3f(x1, y0, z1);
-        glTexCoord2f(1.0f, 0.0f);
-        glVertex3f(x1, y1, z1);
-        glTexCoord2f(0.0f, 0.0f);
-        glVertex3f(x0, y1, z1);
+        gfxTexCoord2f(0.0f, 1.0f);
+        gfxVertex3f(x0, y0, z1);
+        gfxTexCoord2f(1.0f, 1.0f);
+        gfxVertex3f(x1, y0, z1);
+        gfxTexCoord2f(1.0f, 0.0f);
+        gfxVertex3f(x1, y1, z1);
+        gfxTexCoord2f(0.0f, 0.0f);
+        gfxVertex3f(x0, y1, z1);
         // Back (-Z)
-        glTexCoord2f(0.0f, 1.0f);
-        glVertex3f(x1, y0, z0);
-        glTexCoord2f(1.0f, 1.0f);
-        glVertex3f(x0, y0, z0);
-        glTexCoord2f(1.0f, 0.0f);
-        glVertex3f(x0, y1, z0);
-        glTexCoord2f(0.0f, 0.0f);
-        glVertex3f(x1, y1, z0);
+        gfxTexCoord2f(0.0f, 1.0f);
+        gfxVertex3f(x1, y0, z0);
+        gfxTexCoord2f(1.0f, 1.0f);
+        gfxVertex3f(x0, y0, z0);
+        gfxTexCoord2f(1.0f, 0.0f);
+        gfxVertex3f(x0, y1, z0);
+        gfxTexCoord2f(0.0f, 0.0f);
+        gfxVertex3f(x1, y1, z0);
         // Left (-X)
-        glTexCoord2f(0.0f, 1.0f);
-        glVertex3f(x0, y0, z0);
-        glTexCoord2f(1.0f, 1.0f);
-        glVertex3f(x0, y0, z1);
-        glTexCoord2f(1.0f, 0.0f);
-        glVertex3f(x0, y1, z1);
-        glTexCoord2f(0.0f, 0.0f);
-        glVertex3f(x0, y1, z0);
+        gfxTexCoord2f(0.0f, 1.0f);
+        gfxVertex3f(x0, y0, z0);
+        gfxTexCoord2f(1.0f, 1.0f);
+        gfxVertex3f(x0, y0, z1);
+        gfxTexCoord2f(1.0f, 0.0f);
+        gfxVertex3f(x0, y1, z1);
+        gfxTexCoord2f(0.0f, 0.0f);
+        gfxVertex3f(x0, y1, z0);
         // Right (+X)
-        glTexCoord2f(0.0f, 1.0f);
-        glVertex3f(x1, y0, z1);
-        glTexCoord2f(1.0f, 1.0f);
-        glVertex3f(x1, y0, z0);
-        glTexCoord2f(1.0f, 0.0f);
-        glVertex3f(x1, y1, z0);
-        glTexCoord2f(0.0f, 0.0f);
-        glVertex3f(x1, y1, z1);
+        gfxTexCoord2f(0.0f, 1.0f);
+        gfxVertex3f(x1, y0, z1);
+        gfxTexCoord2f(1.0f, 1.0f);
+        gfxVertex3f(x1, y0, z0);
+        gfxTexCoord2f(1.0f, 0.0f);
+        gfxVertex3f(x1, y1, z0);
+        gfxTexCoord2f(0.0f, 0.0f);
+        gfxVertex3f(x1, y1, z1);
         // Top (+Y) left plain white (no texture)
-        glEnd();
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glDisable(GL_TEXTURE_2D);
-
-        glDisable(GL_TEXTURE_2D);
-        glColor3f(0.0f, 0.0f, 0.0f);
-        glBegin(GL_QUADS);
-        glVertex3f(x0, y1, z1);
-        glVertex3f(x1, y1, z1);
-        glVertex3f(x1, y1, z0);
-        glVertex3f(x0, y1, z0);
+        gfxEnd();
+        gfxBindTexture(0);
+        gfxDisable(GL_TEXTURE_2D);
+
+        gfxDisable(GL_TEXTURE_2D);
+        gfxColor3f(0.0f, 0.0f, 0.0f);
+        gfxBegin(GL_QUADS);
+        gfxVertex3f(x0, y1, z1);
+        gfxVertex3f(x1, y1, z1);
+        gfxVertex3f(x1, y1, z0);
+        gfxVertex3f(x0, y1, z0);
         // Bottom (-Y) plain white too
-        glVertex3f(x0, y0, z0);
-        glVertex3f(x1, y0, z0);
-        glVertex3f(x1, y0, z1);
-        glVertex3f(x0, y0, z1);
-        glEnd();
+        gfxVertex3f(x0, y0, z0);
+        gfxVertex3f(x1, y0, z0);
+        gfxVertex3f(x1, y0, z1);
+        gfxVertex3f(x0, y0, z1);
+        gfxEnd();
     };
 
     // Palette
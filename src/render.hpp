@@ -1,5 +1,6 @@
 #pragma once
 
+#include "gfx.hpp"
 #include "types.hpp"
 #include "world.hpp"
 
@@ -17,42 +18,59 @@ extern GLuint gAtlasTex;
 extern const int ATLAS_COLS;
 extern const int ATLAS_ROWS;
 extern const int ATLAS_TILE_SIZE;
-extern std::map<BlockType, int> gBlockTile;
-extern int gAndTopTile;
-extern int gOrTopTile;
-extern int gNotTopTile;
-extern int gXorTopTile;
-extern int gDffTopTile;
-extern int gAddTopTile;
-extern int gAddBottomTile;
-extern int gAddBackTile;
-extern int gCounterTopTile;
-extern int gSplitterTopTile;
-extern int gMergerTopTile;
-extern int gDecoderTopTile;
-extern int gMuxTopTile;
-extern int gMuxInTile[4];
-extern int gComparatorTopTile;
-extern int gComparatorInLeftTile;
-extern int gComparatorInRightTile;
-extern int gComparatorGtTile;
-extern int gComparatorEqTile;
-extern int gComparatorLtTile;
-extern int gGrassTopTile;
 extern const std::map<char, std::array<uint8_t, 5>> FONT5x4;
 extern const int MAX_STACK;
 extern const int INV_COLS;
 extern const int INV_ROWS;
 
+// Six clip planes (a, b, c, d), inside when a*x + b*y + c*z + d >= 0
+struct Frustum
+{
+    float planes[6][4];
+};
+
+struct VisibleChunk
+{
+    int idx;
+    float dist2;
+};
+
+struct ChunkDrawStats
+{
+    int distanceCulled = 0;
+    int frustumCulled = 0;
+    int occlusionCulled = 0;
+    int drawn = 0;
+    int glassDrawn = 0;
+    int lodDrawn = 0;
+    int remeshed = 0;     // chunks rebuilt this frame
+    int remeshQueued = 0; // chunks still waiting for a rebuild
+    size_t vertices = 0;
+};
+extern ChunkDrawStats gChunkStats;
+
 int chunkIndex(int cx, int cy, int cz);
 void markAllChunksDirty();
-void markChunkFromBlock(int x, int y, int z);
+// True if the chunk was not already waiting for a rebuild
+bool markChunkFromBlock(int x, int y, int z);
 void markNeighborsDirty(int x, int y, int z);
-void ensureVbo(GLuint &vbo);
 int tileIndexFor(BlockType b);
 void createAtlasTexture();
+// Atlas UV rect of a FONT5x4 glyph (4x5 texels, top-left first); false if the char has no glyph
+bool atlasGlyphRect(char c, float &u0, float &v0, float &u1, float &v1);
+void atlasWhiteTexel(float &u, float &v);
 GLuint loadTextureFromBMP(const std::string &path);
 GLuint loadCubemapFromBMP(const std::array<std::string, 6> &paths);
 void buildChunkMesh(const World &world, int cx, int cy, int cz);
+// Far-distance variant: merged flat-colored faces, no AO, no sign text, logic blocks as plain cubes
+void buildChunkLodMesh(const World &world, int cx, int cy, int cz);
+void sortGlassFaces(ChunkMesh &mesh, float camX, float camY, float camZ);
 void drawNpcBlocky(const NPC &npc);
 void drawSkybox(GLuint cubemap, float size);
+Frustum frustumFromMatrix(const Mat4 &viewProj);
+bool aabbInFrustum(const Frustum &f, const float *mn, const float *mx);
+void gatherVisibleChunks(float camX, float camY, float camZ, const Frustum &frustum, float viewDist,
+                         std::vector<VisibleChunk> &out);
+// Rebuilds queued chunks (visible, then nearest first) until budgetMs is used up; at least one per call.
+// gatherVisibleChunks refills the queue each frame. Returns the number rebuilt.
+int processRemeshQueue(const World &world, float budgetMs);
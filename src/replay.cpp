@@ -0,0 +1,312 @@
+#include "replay.hpp"
+
+#include "bytes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+
+// File: ReplayHeader, the starting state (runs blob, sign list), uint32 edit count, then per edit: uint64 tick,
+// uint16 x, y, z, nx, ny, nz, runs blob of its importRegion planes, sign list. A runs blob is uint32 byte length
+// then {uint8 value, LEB128 count} runs; a sign list is uint32 count then {uint32 cell, uint16 length, text}.
+struct ReplayHeader
+{
+    char magic[8] = {'L', 'C', 'R', 'E', 'P', 'L', 'A', 'Y'};
+    uint32_t version = 1;
+    uint32_t w = 0, h = 0, d = 0;
+    uint32_t seed = 0;
+    uint64_t startTick = 0;
+    uint64_t endTick = 0;
+};
+
+static void putRuns(std::vector<char> &out, const uint8_t *data, size_t n)
+{
+    const size_t lengthAt = out.size();
+    put<uint32_t>(out, 0);
+    for (size_t i = 0; i < n;)
+    {
+        size_t run = 1;
+        while (i + run < n && data[i + run] == data[i])
+            ++run;
+        put<uint8_t>(out, data[i]);
+        size_t v = run;
+        for (; v >= 0x80; v >>= 7)
+            put<uint8_t>(out, static_cast<uint8_t>((v & 0x7F) | 0x80));
+        put<uint8_t>(out, static_cast<uint8_t>(v));
+        i += run;
+    }
+    const uint32_t length = static_cast<uint32_t>(out.size() - lengthAt - sizeof(uint32_t));
+    std::memcpy(out.data() + lengthAt, &length, sizeof(length));
+}
+
+// Fails unless the runs cover exactly n bytes
+static bool getRuns(ByteReader &rd, std::vector<uint8_t> &out, size_t n)
+{
+    const uint32_t length = rd.get<uint32_t>();
+    const char *p = rd.take(length);
+    if (!p)
+        return false;
+    ByteReader runs{p, p + length};
+    out.clear();
+    out.reserve(n);
+    while (runs.ok && runs.pos < runs.end)
+    {
+        const uint8_t value = runs.get<uint8_t>();
+        size_t count = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            const uint8_t b = runs.get<uint8_t>();
+            count |= static_cast<size_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                break;
+        }
+        if (!runs.ok || count > n - out.size())
+            return false;
+        out.insert(out.end(), count, value);
+    }
+    return runs.ok && out.size() == n;
+}
+
+static void putSigns(std::vector<char> &out, const std::vector<std::pair<int, std::string>> &signs)
+{
+    put<uint32_t>(out, static_cast<uint32_t>(signs.size()));
+    for (const auto &sign : signs)
+    {
+        const uint16_t len = static_cast<uint16_t>(std::min<size_t>(sign.second.size(), 0xFFFF));
+        put<uint32_t>(out, static_cast<uint32_t>(sign.first));
+        put<uint16_t>(out, len);
+        out.insert(out.end(), sign.second.begin(), sign.second.begin() + len);
+    }
+}
+
+static bool getSigns(ByteReader &rd, std::vector<std::pair<int, std::string>> &out, size_t cells)
+{
+    const uint32_t count = rd.get<uint32_t>();
+    out.clear();
+    for (uint32_t i = 0; i < count && rd.ok; ++i)
+    {
+        const uint32_t cell = rd.get<uint32_t>();
+        const uint16_t len = rd.get<uint16_t>();
+        const char *text = rd.take(len);
+        if (!text || cell >= cells)
+            return false;
+        out.emplace_back(static_cast<int>(cell), std::string(text, text + len));
+    }
+    return rd.ok;
+}
+
+// Sign texts of a box, by cell in the box
+static void boxSigns(const World &world, int x0, int y0, int z0, int nx, int ny, int nz,
+                     const uint8_t *planes, std::vector<std::pair<int, std::string>> &out)
+{
+    const size_t n = static_cast<size_t>(nx) * ny * nz;
+    const BlockType *types = reinterpret_cast<const BlockType *>(planes + PlaneTiles * n);
+    out.clear();
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (types[i] != BlockType::Sign)
+            continue;
+        const int x = x0 + static_cast<int>(i % nx);
+        const int y = y0 + static_cast<int>(i / (static_cast<size_t>(nx) * nz));
+        const int z = z0 + static_cast<int>((i / nx) % nz);
+        const std::string &text = world.getSignText(x, y, z);
+        if (!text.empty())
+            out.emplace_back(static_cast<int>(i), text);
+    }
+}
+
+// ---------- Recording ----------
+struct ReplayRecording
+{
+    bool active = false;
+    ReplayHeader header;
+    std::vector<char> state;                   // runs blob and sign list of the starting world
+    std::vector<std::array<int, 6>> pending;   // boxes noted since the last capture
+    std::vector<char> edits;
+    uint32_t editCount = 0;
+};
+static ReplayRecording gRecording;
+
+void replayStartRecording(const World &world, uint32_t seed)
+{
+    ReplayRecording &r = gRecording;
+    r.active = true;
+    r.header = ReplayHeader{};
+    r.header.w = static_cast<uint32_t>(world.getWidth());
+    r.header.h = static_cast<uint32_t>(world.getHeight());
+    r.header.d = static_cast<uint32_t>(world.getDepth());
+    r.header.seed = seed;
+    r.header.startTick = world.getLogicTick();
+    r.state.clear();
+    putRuns(r.state, world.densePlanes(), world.denseBytes());
+    std::vector<std::pair<int, std::string>> signs;
+    boxSigns(world, 0, 0, 0, world.getWidth(), world.getHeight(), world.getDepth(), world.densePlanes(), signs);
+    putSigns(r.state, signs);
+    r.pending.clear();
+    r.edits.clear();
+    r.editCount = 0;
+}
+
+bool replayRecording() { return gRecording.active; }
+
+void replayNoteCell(int x, int y, int z) { replayNoteRegion(x, y, z, 1, 1, 1); }
+
+void replayNoteRegion(int x, int y, int z, int nx, int ny, int nz)
+{
+    if (!gRecording.active)
+        return;
+    // the same cell noted again in one frame (set then configured) is captured once
+    const std::array<int, 6> box{x, y, z, nx, ny, nz};
+    if (gRecording.pending.empty() || gRecording.pending.back() != box)
+        gRecording.pending.push_back(box);
+}
+
+void replayCapture(const World &world)
+{
+    ReplayRecording &r = gRecording;
+    if (!r.active || r.pending.empty())
+        return;
+    std::vector<uint8_t> planes;
+    std::vector<std::pair<int, std::string>> signs;
+    for (const auto &box : r.pending)
+    {
+        // clamp to the world, as the edits themselves are
+        const int x0 = std::max(box[0], 0), y0 = std::max(box[1], 0), z0 = std::max(box[2], 0);
+        const int nx = std::min(box[0] + box[3], world.getWidth()) - x0;
+        const int ny = std::min(box[1] + box[4], world.getHeight()) - y0;
+        const int nz = std::min(box[2] + box[5], world.getDepth()) - z0;
+        if (nx <= 0 || ny <= 0 || nz <= 0)
+            continue;
+        planes.resize(static_cast<size_t>(nx) * ny * nz * DENSE_PLANE_COUNT);
+        world.exportRegion(x0, y0, z0, nx, ny, nz, planes.data());
+        boxSigns(world, x0, y0, z0, nx, ny, nz, planes.data(), signs);
+        put<uint64_t>(r.edits, world.getLogicTick());
+        for (int v : {x0, y0, z0, nx, ny, nz})
+            put<uint16_t>(r.edits, static_cast<uint16_t>(v));
+        putRuns(r.edits, planes.data(), planes.size());
+        putSigns(r.edits, signs);
+        ++r.editCount;
+    }
+    r.pending.clear();
+}
+
+bool replayStopRecording(const World &world, const std::string &path)
+{
+    ReplayRecording &r = gRecording;
+    if (!r.active)
+        return false;
+    replayCapture(world);
+    r.active = false;
+    r.header.endTick = world.getLogicTick();
+
+    std::vector<char> out;
+    put(out, r.header);
+    out.insert(out.end(), r.state.begin(), r.state.end());
+    put<uint32_t>(out, r.editCount);
+    out.insert(out.end(), r.edits.begin(), r.edits.end());
+    std::vector<char>().swap(r.state);
+    std::vector<char>().swap(r.edits);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (file)
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!file)
+    {
+        std::cerr << "Could not write " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// ---------- Playback ----------
+bool loadReplay(const std::string &path, Replay &out)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    std::vector<char> data(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!in)
+        return false;
+
+    ByteReader rd{data.data(), data.data() + data.size()};
+    ReplayHeader hdr{};
+    rd.read(&hdr, sizeof(hdr));
+    if (!rd.ok || std::string(hdr.magic, hdr.magic + 8) != "LCREPLAY" || hdr.version != 1)
+        return false;
+    if (hdr.w == 0 || hdr.h == 0 || hdr.d == 0 || hdr.w > 4096 || hdr.h > 4096 || hdr.d > 4096 ||
+        hdr.endTick < hdr.startTick)
+        return false;
+    out.width = static_cast<int>(hdr.w);
+    out.height = static_cast<int>(hdr.h);
+    out.depth = static_cast<int>(hdr.d);
+    out.seed = hdr.seed;
+    out.startTick = hdr.startTick;
+    out.endTick = hdr.endTick;
+    const size_t cells = static_cast<size_t>(hdr.w) * hdr.h * hdr.d;
+    if (!getRuns(rd, out.planes, cells * DENSE_PLANE_COUNT) || !getSigns(rd, out.signs, cells))
+        return false;
+
+    const uint32_t editCount = rd.get<uint32_t>();
+    out.edits.clear();
+    for (uint32_t i = 0; i < editCount && rd.ok; ++i)
+    {
+        ReplayEdit edit;
+        edit.tick = rd.get<uint64_t>();
+        edit.x = rd.get<uint16_t>();
+        edit.y = rd.get<uint16_t>();
+        edit.z = rd.get<uint16_t>();
+        edit.nx = rd.get<uint16_t>();
+        edit.ny = rd.get<uint16_t>();
+        edit.nz = rd.get<uint16_t>();
+        if (edit.nx == 0 || edit.ny == 0 || edit.nz == 0 || edit.x + edit.nx > out.width ||
+            edit.y + edit.ny > out.height || edit.z + edit.nz > out.depth ||
+            (!out.edits.empty() && edit.tick < out.edits.back().tick))
+            return false;
+        const size_t n = static_cast<size_t>(edit.nx) * edit.ny * edit.nz;
+        if (!getRuns(rd, edit.planes, n * DENSE_PLANE_COUNT) || !getSigns(rd, edit.signs, n))
+            return false;
+        out.edits.push_back(std::move(edit));
+    }
+    return rd.ok;
+}
+
+static void applySigns(World &world, int x0, int y0, int z0, int nx, int nz,
+                       const std::vector<std::pair<int, std::string>> &signs)
+{
+    for (const auto &sign : signs)
+    {
+        const int cell = sign.first;
+        world.setSignText(x0 + cell % nx, y0 + cell / (nx * nz), z0 + (cell / nx) % nz, sign.second);
+    }
+}
+
+bool replayRestore(World &world, const Replay &replay)
+{
+    if (world.getWidth() != replay.width || world.getHeight() != replay.height || world.getDepth() != replay.depth)
+        return false;
+    world.importRegion(0, 0, 0, replay.width, replay.height, replay.depth, replay.planes.data());
+    applySigns(world, 0, 0, 0, replay.width, replay.depth, replay.signs);
+    world.takeEditedChunks();
+    world.setLogicTick(replay.startTick);
+    return true;
+}
+
+bool replayApply(World &world, const Replay &replay, size_t &cursor)
+{
+    const uint64_t tick = world.getLogicTick();
+    for (; cursor < replay.edits.size() && replay.edits[cursor].tick <= tick; ++cursor)
+    {
+        const ReplayEdit &e = replay.edits[cursor];
+        world.importRegion(e.x, e.y, e.z, e.nx, e.ny, e.nz, e.planes.data());
+        applySigns(world, e.x, e.y, e.z, e.nx, e.nz, e.signs);
+    }
+    return tick < replay.endTick;
+}
+
+uint64_t replayNextTick(const Replay &replay, size_t cursor)
+{
+    return cursor < replay.edits.size() ? std::min(replay.edits[cursor].tick, replay.endTick) : replay.endTick;
+}
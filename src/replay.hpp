@@ -0,0 +1,53 @@
+#pragma once
+
+#include "world.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Input replays (.replay). A replay holds the exact state of the world when recording started (every dense plane,
+// run-length coded, the sign texts and the logic tick), then each player edit as the state the touched cells were
+// left in, stamped with the logic tick it happened before. updateLogic depends on nothing but the world, so
+// applying every edit before its tick reproduces the recorded simulation, with or without rendering.
+
+// Recording. Note the cells or boxes an edit changes (placements, breaks, button presses, block settings,
+// pastes, undo/redo); replayCapture, called before each updateLogic, reads their state after the edits.
+void replayStartRecording(const World &world, uint32_t seed);
+bool replayRecording();
+void replayNoteCell(int x, int y, int z);
+void replayNoteRegion(int x, int y, int z, int nx, int ny, int nz);
+void replayCapture(const World &world);
+// Captures what is still noted and writes the replay; false if nothing was being recorded or the write failed
+bool replayStopRecording(const World &world, const std::string &path);
+
+// Playback
+struct ReplayEdit
+{
+    uint64_t tick = 0;
+    int x = 0, y = 0, z = 0;
+    int nx = 0, ny = 0, nz = 0;
+    std::vector<uint8_t> planes;                    // World::importRegion layout
+    std::vector<std::pair<int, std::string>> signs; // cell in the box, text
+};
+
+struct Replay
+{
+    int width = 0, height = 0, depth = 0;
+    uint32_t seed = 0;
+    uint64_t startTick = 0;
+    uint64_t endTick = 0;
+    std::vector<uint8_t> planes;                    // the whole world, World::densePlanes layout
+    std::vector<std::pair<int, std::string>> signs; // cell index, text
+    std::vector<ReplayEdit> edits;                  // in tick order
+};
+
+bool loadReplay(const std::string &path, Replay &out);
+// Puts the starting state in `world`, which must have the replay's size; not an edit
+bool replayRestore(World &world, const Replay &replay);
+// Applies the edits stamped with the world's current tick, from `cursor` on; call before each updateLogic. False
+// once the world has reached the replay's last tick (its edits applied).
+bool replayApply(World &world, const Replay &replay, size_t &cursor);
+// Tick of the next edit from `cursor` on, or the replay's last tick; the ticks before it can be skipped when settled
+uint64_t replayNextTick(const Replay &replay, size_t cursor);
@@ -0,0 +1,1451 @@
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "save.hpp"
+
+#include "bytes.hpp"
+#include "render.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ---------- Save / Load ----------
+struct SaveHeader
+{
+    char magic[8] = {'B', 'U', 'L', 'L', 'D', 'O', 'G', '\0'};
+    uint32_t version = 13;
+    uint32_t w = 0, h = 0, d = 0;
+    uint32_t seed = 0;
+};
+
+// Version 11 body: uint32 chunk edge, uint32 chunk count, a ChunkEntry per chunk (chunkIndex order), then the
+// chunk payloads. A payload is: uint8 palette size, palette (BlockType bytes), uint8 ChunkEncoding and its
+// indices, attribute bytes for each stateful cell in cell order (y, z, x), uint16 sign count and the signs.
+// Version 13 is the same with one more attribute byte for DFlipFlop cells, the previous clock level; a version
+// 11 flip-flop loads with it low.
+static const uint32_t SAVE_VERSION_CHUNKED = 11;
+static const uint32_t SAVE_VERSION_LATCH = 13;
+static const int SAVE_CHUNK = 16;
+static const int SAVE_CHUNK_CELLS = SAVE_CHUNK * SAVE_CHUNK * SAVE_CHUNK;
+
+enum ChunkEncoding : uint8_t
+{
+    EncodingUniform, // palette of one, no index data
+    EncodingPacked,  // ceil(log2(palette size)) bits per cell, LSB first
+    EncodingRuns     // uint16 run count, then {uint8 palette index, uint16 length} runs
+};
+
+// Version 12 (mapped) layout: SaveHeader, uint32 plane count, uint32 planes offset, zero padding up to
+// MAPPED_PLANES_OFFSET, the World dense planes exactly as World holds them (DensePlane order, totalSize() bytes
+// each), then the sign table as in versions 2-10. Only the bytes before the sign table are mapped.
+static const uint32_t SAVE_VERSION_MAPPED = 12;
+static const uint32_t MAPPED_PLANES_OFFSET = 64;
+
+struct ChunkEntry
+{
+    uint32_t offset; // from the start of the file
+    uint32_t size;
+};
+
+static int paletteBits(int paletteSize)
+{
+    int bits = 0;
+    while ((1 << bits) < paletteSize)
+        ++bits;
+    return bits;
+}
+
+// Power for every logic block, plus the settings of the blocks that have any
+static void putAttributes(std::vector<char> &out, const World &world, int x, int y, int z, BlockType b)
+{
+    put<uint8_t>(out, world.getPower(x, y, z));
+    if (b == BlockType::Button)
+    {
+        put<uint8_t>(out, world.getButtonState(x, y, z));
+        put<uint8_t>(out, world.getButtonValue(x, y, z));
+        put<uint8_t>(out, world.getButtonWidth(x, y, z));
+    }
+    else if (b == BlockType::Splitter || b == BlockType::Merger)
+    {
+        put<uint8_t>(out, world.getSplitterWidth(x, y, z));
+        put<uint8_t>(out, world.getSplitterOrder(x, y, z));
+    }
+    else if (b == BlockType::Clock)
+        put<uint8_t>(out, world.getClockFreq(x, y, z));
+    else if (b == BlockType::DFlipFlop)
+        put<uint8_t>(out, world.getButtonState(x, y, z)); // clock latch
+}
+
+// Setting writers for World::importRegion planes of `cells` cells, clamped as the World setters clamp
+static void storeButton(uint8_t *planes, size_t cells, size_t i, uint8_t value, uint8_t width)
+{
+    width = static_cast<uint8_t>(std::clamp<int>(width, 1, 8));
+    uint8_t mask = (width >= 8) ? 0xFFu : static_cast<uint8_t>((1u << width) - 1u);
+    planes[PlaneButtonWidth * cells + i] = width;
+    planes[PlaneButtonValue * cells + i] = static_cast<uint8_t>(value & mask);
+}
+
+static void storeSplitter(uint8_t *planes, size_t cells, size_t i, uint8_t width, uint8_t order)
+{
+    planes[PlaneSplitterWidth * cells + i] = static_cast<uint8_t>(std::clamp<int>(width, 1, 7));
+    planes[PlaneSplitterOrder * cells + i] = static_cast<uint8_t>(order & 0x1u);
+}
+
+static void storeClock(uint8_t *planes, size_t cells, size_t i, uint8_t freq)
+{
+    planes[PlaneClockFreq * cells + i] = static_cast<uint8_t>(std::clamp<int>(freq, 1, 255));
+}
+
+// The putAttributes bytes of cell i into importRegion planes; `latch` is false for payloads older than version 13
+static void getAttributes(ByteReader &rd, uint8_t *planes, size_t cells, size_t i, BlockType b, bool latch)
+{
+    planes[PlanePower * cells + i] = rd.get<uint8_t>();
+    if (b == BlockType::Button)
+    {
+        planes[PlaneButtonState * cells + i] = rd.get<uint8_t>();
+        uint8_t value = rd.get<uint8_t>();
+        uint8_t width = rd.get<uint8_t>();
+        storeButton(planes, cells, i, value, width == 0 ? 8 : width);
+    }
+    else if (b == BlockType::Splitter || b == BlockType::Merger)
+    {
+        uint8_t width = rd.get<uint8_t>();
+        storeSplitter(planes, cells, i, width, rd.get<uint8_t>());
+    }
+    else if (b == BlockType::Clock)
+        storeClock(planes, cells, i, rd.get<uint8_t>());
+    else if (b == BlockType::DFlipFlop && latch)
+        planes[PlaneButtonState * cells + i] = static_cast<uint8_t>(rd.get<uint8_t>() ? 1 : 0);
+}
+
+struct ChunkBox
+{
+    int x0, y0, z0;
+    int nx, ny, nz;
+    int cells() const { return nx * ny * nz; }
+};
+
+static ChunkBox saveChunkBox(const World &world, int cx, int cy, int cz)
+{
+    ChunkBox box;
+    box.x0 = cx * SAVE_CHUNK;
+    box.y0 = cy * SAVE_CHUNK;
+    box.z0 = cz * SAVE_CHUNK;
+    box.nx = std::min(SAVE_CHUNK, world.getWidth() - box.x0);
+    box.ny = std::min(SAVE_CHUNK, world.getHeight() - box.y0);
+    box.nz = std::min(SAVE_CHUNK, world.getDepth() - box.z0);
+    return box;
+}
+
+static ChunkBox chunkBoxFromIndex(const World &world, int chunk)
+{
+    const int chunksX = (world.getWidth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const int chunksZ = (world.getDepth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    return saveChunkBox(world, chunk % chunksX, chunk / (chunksX * chunksZ), (chunk / chunksX) % chunksZ);
+}
+
+static void encodeChunk(const World &world, const ChunkBox &box, std::vector<char> &out)
+{
+    BlockType cells[SAVE_CHUNK_CELLS];
+    uint8_t indices[SAVE_CHUNK_CELLS];
+    const int count = box.cells();
+    for (int y = 0; y < box.ny; ++y)
+    {
+        for (int z = 0; z < box.nz; ++z)
+            world.copyRow(box.x0, box.y0 + y, box.z0 + z, box.nx, cells + (y * box.nz + z) * box.nx);
+    }
+
+    // palette in first-seen order
+    uint8_t slot[BLOCK_TYPE_COUNT];
+    uint8_t palette[BLOCK_TYPE_COUNT];
+    int paletteSize = 0;
+    std::fill(slot, slot + BLOCK_TYPE_COUNT, uint8_t{0xFF});
+    int runs = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        uint8_t t = static_cast<uint8_t>(cells[i]);
+        if (slot[t] == 0xFF)
+        {
+            slot[t] = static_cast<uint8_t>(paletteSize);
+            palette[paletteSize++] = t;
+        }
+        indices[i] = slot[t];
+        if (i == 0 || indices[i] != indices[i - 1])
+            ++runs;
+    }
+    put<uint8_t>(out, static_cast<uint8_t>(paletteSize));
+    out.insert(out.end(), palette, palette + paletteSize);
+
+    const int bits = paletteBits(paletteSize);
+    const size_t packedBytes = (static_cast<size_t>(count) * bits + 7) / 8;
+    const size_t runBytes = sizeof(uint16_t) + static_cast<size_t>(runs) * 3;
+    if (paletteSize == 1)
+        put<uint8_t>(out, EncodingUniform);
+    else if (runBytes < packedBytes)
+    {
+        put<uint8_t>(out, EncodingRuns);
+        put<uint16_t>(out, static_cast<uint16_t>(runs));
+        int start = 0;
+        for (int i = 1; i <= count; ++i)
+        {
+            if (i < count && indices[i] == indices[start])
+                continue;
+            put<uint8_t>(out, indices[start]);
+            put<uint16_t>(out, static_cast<uint16_t>(i - start));
+            start = i;
+        }
+    }
+    else
+    {
+        put<uint8_t>(out, EncodingPacked);
+        uint32_t acc = 0;
+        int accBits = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            acc |= static_cast<uint32_t>(indices[i]) << accBits;
+            accBits += bits;
+            while (accBits >= 8)
+            {
+                out.push_back(static_cast<char>(acc & 0xFF));
+                acc >>= 8;
+                accBits -= 8;
+            }
+        }
+        if (accBits > 0)
+            out.push_back(static_cast<char>(acc & 0xFF));
+    }
+
+    uint16_t signCount = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        BlockType b = cells[i];
+        int x = box.x0 + i % box.nx;
+        int y = box.y0 + i / (box.nx * box.nz);
+        int z = box.z0 + (i / box.nx) % box.nz;
+        if (hasPorts(b))
+            putAttributes(out, world, x, y, z, b);
+        else if (b == BlockType::Sign && !world.getSignText(x, y, z).empty())
+            ++signCount;
+    }
+
+    put<uint16_t>(out, signCount);
+    for (int i = 0; signCount > 0 && i < count; ++i)
+    {
+        if (cells[i] != BlockType::Sign)
+            continue;
+        const std::string &txt =
+            world.getSignText(box.x0 + i % box.nx, box.y0 + i / (box.nx * box.nz), box.z0 + (i / box.nx) % box.nz);
+        if (txt.empty())
+            continue;
+        uint16_t len = static_cast<uint16_t>(std::min<size_t>(txt.size(), 65535));
+        put<uint16_t>(out, static_cast<uint16_t>(i));
+        put<uint16_t>(out, len);
+        out.insert(out.end(), txt.data(), txt.data() + len);
+    }
+}
+
+// A chunk payload parsed off the world, so decoding can run on another thread than applying
+struct DecodedChunk
+{
+    ChunkBox box;
+    std::vector<uint8_t> planes; // for World::importRegion
+    std::vector<std::pair<int, std::string>> signs;
+};
+
+static bool parseChunk(ByteReader &rd, const ChunkBox &box, bool latch, DecodedChunk &out)
+{
+    BlockType cells[SAVE_CHUNK_CELLS];
+    uint8_t indices[SAVE_CHUNK_CELLS];
+    const int count = box.cells();
+    out.box = box;
+    out.signs.clear();
+
+    int paletteSize = rd.get<uint8_t>();
+    const char *paletteBytes = rd.take(paletteSize);
+    if (!paletteBytes || paletteSize == 0)
+        return false;
+    BlockType palette[256];
+    for (int i = 0; i < paletteSize; ++i)
+    {
+        uint8_t t = static_cast<uint8_t>(paletteBytes[i]);
+        if (t >= BLOCK_TYPE_COUNT)
+            return false;
+        palette[i] = static_cast<BlockType>(t);
+    }
+
+    uint8_t encoding = rd.get<uint8_t>();
+    if (encoding == EncodingUniform)
+        std::fill(indices, indices + count, uint8_t{0});
+    else if (encoding == EncodingRuns)
+    {
+        int runs = rd.get<uint16_t>();
+        int filled = 0;
+        for (int r = 0; r < runs; ++r)
+        {
+            uint8_t idx = rd.get<uint8_t>();
+            int len = rd.get<uint16_t>();
+            if (!rd.ok || len > count - filled)
+                return false;
+            std::fill(indices + filled, indices + filled + len, idx);
+            filled += len;
+        }
+        if (filled != count)
+            return false;
+    }
+    else if (encoding == EncodingPacked)
+    {
+        const int bits = paletteBits(paletteSize);
+        const uint8_t *src =
+            reinterpret_cast<const uint8_t *>(rd.take((static_cast<size_t>(count) * bits + 7) / 8));
+        if (!src)
+            return false;
+        const uint32_t mask = (1u << bits) - 1;
+        uint32_t acc = 0;
+        int accBits = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            while (accBits < bits)
+            {
+                acc |= static_cast<uint32_t>(*src++) << accBits;
+                accBits += 8;
+            }
+            indices[i] = static_cast<uint8_t>(acc & mask);
+            acc >>= bits;
+            accBits -= bits;
+        }
+    }
+    else
+        return false;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (indices[i] >= paletteSize)
+            return false;
+        cells[i] = palette[indices[i]];
+    }
+    out.planes.resize(static_cast<size_t>(count) * DENSE_PLANE_COUNT);
+    World::defaultPlanes(cells, count, out.planes.data());
+    for (int i = 0; i < count; ++i)
+    {
+        if (hasPorts(cells[i]))
+            getAttributes(rd, out.planes.data(), count, i, cells[i], latch);
+    }
+
+    int signCount = rd.get<uint16_t>();
+    for (int s = 0; s < signCount && rd.ok; ++s)
+    {
+        int cell = rd.get<uint16_t>();
+        int len = rd.get<uint16_t>();
+        const char *txt = rd.take(len);
+        if (!txt || cell >= count)
+            return false;
+        if (cells[cell] == BlockType::Sign)
+            out.signs.emplace_back(cell, std::string(txt, txt + len));
+    }
+    return rd.ok;
+}
+
+static void applyChunk(World &world, const DecodedChunk &chunk)
+{
+    const ChunkBox &box = chunk.box;
+    world.importRegion(box.x0, box.y0, box.z0, box.nx, box.ny, box.nz, chunk.planes.data());
+    for (const auto &sign : chunk.signs)
+    {
+        int cell = sign.first;
+        world.setSignText(box.x0 + cell % box.nx, box.y0 + cell / (box.nx * box.nz),
+                          box.z0 + (cell / box.nx) % box.nz, sign.second);
+    }
+}
+
+static bool decodeChunk(ByteReader &rd, World &world, const ChunkBox &box, bool latch)
+{
+    DecodedChunk chunk;
+    if (!parseChunk(rd, box, latch, chunk))
+        return false;
+    applyChunk(world, chunk);
+    return true;
+}
+
+static void stopJournal();
+static void journalRebase(const World &world, const std::string &path);
+static void finishRebase(bool ok);
+
+// Read-write shared mapping of the first `length` bytes of an existing file
+struct FileMapping
+{
+    std::string path;
+    uint8_t *base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+static FileMapping gWorldMapping; // the file the world's dense planes live in, if any (one world at a time)
+
+static void closeMapping(FileMapping &m)
+{
+#ifdef _WIN32
+    if (m.base)
+        UnmapViewOfFile(m.base);
+    if (m.mapping)
+        CloseHandle(m.mapping);
+    if (m.file != INVALID_HANDLE_VALUE)
+        CloseHandle(m.file);
+#else
+    if (m.base)
+        munmap(m.base, m.length);
+    if (m.fd >= 0)
+        close(m.fd);
+#endif
+    m = FileMapping{};
+}
+
+static bool openMapping(FileMapping &m, const std::string &path, size_t length)
+{
+    m.path = path;
+    m.length = length;
+#ifdef _WIN32
+    m.file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m.file != INVALID_HANDLE_VALUE)
+        m.mapping = CreateFileMappingA(m.file, nullptr, PAGE_READWRITE, static_cast<DWORD>(uint64_t(length) >> 32),
+                                       static_cast<DWORD>(length & 0xFFFFFFFFu), nullptr);
+    if (m.mapping)
+        m.base = static_cast<uint8_t *>(MapViewOfFile(m.mapping, FILE_MAP_ALL_ACCESS, 0, 0, length));
+#else
+    m.fd = open(path.c_str(), O_RDWR);
+    if (m.fd >= 0)
+    {
+        void *p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, m.fd, 0);
+        if (p != MAP_FAILED)
+            m.base = static_cast<uint8_t *>(p);
+    }
+#endif
+    if (!m.base)
+    {
+        std::cerr << "Could not map " << path << "\n";
+        closeMapping(m);
+        return false;
+    }
+    return true;
+}
+
+// Writes dirty pages back to the file
+static bool flushMapping(const FileMapping &m)
+{
+#ifdef _WIN32
+    return FlushViewOfFile(m.base, m.length) && FlushFileBuffers(m.file);
+#else
+    return msync(m.base, m.length, MS_SYNC) == 0;
+#endif
+}
+
+static void putSignTable(std::vector<char> &out, const World &world)
+{
+    std::vector<std::pair<uint32_t, const std::string *>> signs;
+    const uint8_t *tiles = world.densePlanes() + PlaneTiles * static_cast<size_t>(world.totalSize());
+    for (int i = 0; i < world.totalSize(); ++i)
+    {
+        if (tiles[i] != static_cast<uint8_t>(BlockType::Sign))
+            continue;
+        int x, y, z;
+        world.cellCoords(i, x, y, z);
+        const std::string &txt = world.getSignText(x, y, z);
+        if (!txt.empty())
+            signs.emplace_back(static_cast<uint32_t>(i), &txt);
+    }
+    put<uint32_t>(out, static_cast<uint32_t>(signs.size()));
+    for (const auto &s : signs)
+    {
+        uint16_t len = static_cast<uint16_t>(std::min<size_t>(s.second->size(), 65535));
+        put<uint32_t>(out, s.first);
+        put<uint16_t>(out, len);
+        out.insert(out.end(), s.second->data(), s.second->data() + len);
+    }
+}
+
+// Signs sit past the mapped range; a stale longer table left behind is ignored thanks to its count
+static bool writeMappedSigns(const World &world, const std::string &path)
+{
+    std::vector<char> buf;
+    putSignTable(buf, world);
+    std::fstream io(path, std::ios::binary | std::ios::in | std::ios::out);
+    io.seekp(static_cast<std::streamoff>(MAPPED_PLANES_OFFSET + world.denseBytes()));
+    io.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    io.flush();
+    return static_cast<bool>(io);
+}
+
+bool saveMappedWorld(World &world, const std::string &path, uint32_t seed)
+{
+    const size_t mappedBytes = MAPPED_PLANES_OFFSET + world.denseBytes();
+    const bool live = gWorldMapping.base && gWorldMapping.path == path &&
+                      world.densePlanes() == gWorldMapping.base + MAPPED_PLANES_OFFSET;
+    if (!live)
+    {
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+        SaveHeader hdr;
+        hdr.version = SAVE_VERSION_MAPPED;
+        hdr.w = static_cast<uint32_t>(world.getWidth());
+        hdr.h = static_cast<uint32_t>(world.getHeight());
+        hdr.d = static_cast<uint32_t>(world.getDepth());
+        std::vector<char> head;
+        put(head, hdr);
+        put<uint32_t>(head, DENSE_PLANE_COUNT);
+        put<uint32_t>(head, MAPPED_PLANES_OFFSET);
+        head.resize(MAPPED_PLANES_OFFSET, 0);
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+            out.write(head.data(), static_cast<std::streamsize>(head.size()));
+            if (!out)
+                return false;
+        }
+        std::error_code ec;
+        std::filesystem::resize_file(path, mappedBytes, ec);
+        FileMapping m;
+        if (ec || !openMapping(m, path, mappedBytes))
+            return false;
+        // the world moves into the new file; the previous one (if any) is left as last saved
+        world.bindDenseStorage(m.base + MAPPED_PLANES_OFFSET, true);
+        closeMapping(gWorldMapping);
+        gWorldMapping = m;
+        // the file itself is the autosave from here on
+        stopJournal();
+    }
+    std::memcpy(gWorldMapping.base + offsetof(SaveHeader, seed), &seed, sizeof(seed));
+    return flushMapping(gWorldMapping) && writeMappedSigns(world, path);
+}
+
+bool mapWorldFile(World &world, const std::string &path, uint32_t &seedOut)
+{
+    const size_t mappedBytes = MAPPED_PLANES_OFFSET + world.denseBytes();
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    std::streamoff size = in.tellg();
+    SaveHeader hdr{};
+    uint32_t planeCount = 0, planesOffset = 0;
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
+    in.read(reinterpret_cast<char *>(&planeCount), sizeof(planeCount));
+    in.read(reinterpret_cast<char *>(&planesOffset), sizeof(planesOffset));
+    if (!in || std::string(hdr.magic, hdr.magic + 7) != "BULLDOG" || hdr.version != SAVE_VERSION_MAPPED)
+        return false;
+    if (hdr.w != static_cast<uint32_t>(world.getWidth()) || hdr.h != static_cast<uint32_t>(world.getHeight()) ||
+        hdr.d != static_cast<uint32_t>(world.getDepth()) || planeCount != DENSE_PLANE_COUNT ||
+        planesOffset != MAPPED_PLANES_OFFSET || size < static_cast<std::streamoff>(mappedBytes + sizeof(uint32_t)))
+        return false;
+
+    // Already the live file: its contents are the world as it stands
+    if (gWorldMapping.base && gWorldMapping.path == path &&
+        world.densePlanes() == gWorldMapping.base + MAPPED_PLANES_OFFSET)
+    {
+        seedOut = hdr.seed;
+        world.setLogicTick(0);
+        return true;
+    }
+
+    FileMapping m;
+    if (!openMapping(m, path, mappedBytes))
+        return false;
+    world.bindDenseStorage(m.base + MAPPED_PLANES_OFFSET, false);
+    closeMapping(gWorldMapping);
+    gWorldMapping = m;
+    stopJournal();
+
+    in.seekg(static_cast<std::streamoff>(mappedBytes));
+    uint32_t signCount = 0;
+    in.read(reinterpret_cast<char *>(&signCount), sizeof(signCount));
+    for (uint32_t i = 0; i < signCount && in; ++i)
+    {
+        uint32_t idx = 0;
+        uint16_t len = 0;
+        in.read(reinterpret_cast<char *>(&idx), sizeof(idx));
+        in.read(reinterpret_cast<char *>(&len), sizeof(len));
+        std::string txt(len, '\0');
+        if (len > 0)
+            in.read(&txt[0], len);
+        if (!in || idx >= static_cast<uint32_t>(world.totalSize()))
+            break;
+        int x, y, z;
+        world.cellCoords(static_cast<int>(idx), x, y, z);
+        if (world.get(x, y, z) == BlockType::Sign)
+            world.setSignText(x, y, z, txt);
+    }
+    seedOut = hdr.seed;
+    world.takeEditedChunks(); // a fresh load is not an edit
+    world.setLogicTick(0);
+    markAllChunksDirty();
+    return true;
+}
+
+void unmapWorld(World &world)
+{
+    if (!gWorldMapping.base || world.densePlanes() != gWorldMapping.base + MAPPED_PLANES_OFFSET)
+        return;
+    world.releaseDenseStorage();
+    closeMapping(gWorldMapping);
+}
+
+// Assembles a whole version 13 file in memory; `progress` (if any) goes from 0 to 1 as chunks are encoded
+static void encodeWorld(const World &world, uint32_t seed, std::vector<char> &buf, std::atomic<float> *progress)
+{
+    SaveHeader hdr;
+    hdr.w = static_cast<uint32_t>(world.getWidth());
+    hdr.h = static_cast<uint32_t>(world.getHeight());
+    hdr.d = static_cast<uint32_t>(world.getDepth());
+    hdr.seed = seed;
+
+    const int chunksX = (world.getWidth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const int chunksY = (world.getHeight() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const int chunksZ = (world.getDepth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const uint32_t chunkCount = static_cast<uint32_t>(chunksX * chunksY * chunksZ);
+
+    buf.clear();
+    buf.reserve(sizeof(hdr) + chunkCount * (sizeof(ChunkEntry) + 64));
+    put(buf, hdr);
+    put<uint32_t>(buf, SAVE_CHUNK);
+    put<uint32_t>(buf, chunkCount);
+    const size_t tableAt = buf.size();
+    buf.resize(tableAt + chunkCount * sizeof(ChunkEntry));
+    std::vector<ChunkEntry> table(chunkCount);
+    // y, z, x nesting visits chunks in index order
+    uint32_t idx = 0;
+    for (int cy = 0; cy < chunksY; ++cy)
+    {
+        for (int cz = 0; cz < chunksZ; ++cz)
+        {
+            for (int cx = 0; cx < chunksX; ++cx, ++idx)
+            {
+                table[idx].offset = static_cast<uint32_t>(buf.size());
+                encodeChunk(world, saveChunkBox(world, cx, cy, cz), buf);
+                table[idx].size = static_cast<uint32_t>(buf.size() - table[idx].offset);
+                if (progress)
+                    progress->store(static_cast<float>(idx + 1) / chunkCount, std::memory_order_relaxed);
+            }
+        }
+    }
+    std::memcpy(buf.data() + tableAt, table.data(), table.size() * sizeof(ChunkEntry));
+}
+
+// Writes a sibling temporary file and renames it over `path`, so the previous save stays intact until the new
+// one is complete
+static bool writeFileAtomically(const std::string &path, const std::vector<char> &buf)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (out)
+        {
+            out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+            out.flush();
+        }
+        if (!out)
+        {
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec)
+    {
+        std::cerr << "Could not replace " << path << ": " << ec.message() << "\n";
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool saveWorldToFile(const World &world, const std::string &path, uint32_t seed)
+{
+    std::vector<char> buf;
+    encodeWorld(world, seed, buf, nullptr);
+    return writeFileAtomically(path, buf);
+}
+
+struct AsyncSave
+{
+    std::thread worker;
+    std::string path;
+    std::atomic<float> progress{0.0f};
+    std::atomic<bool> finished{false}; // set by the worker once ok is final
+    bool ok = false;
+    bool settled = true;  // worker joined and the journal told
+    bool reported = true; // result handed to pollAsyncSave
+};
+
+static AsyncSave gAsyncSave;
+
+// Joins a worker that has finished and lets the journal act on its result, once
+static void settleAsyncSave()
+{
+    if (gAsyncSave.settled || !gAsyncSave.finished.load(std::memory_order_acquire))
+        return;
+    if (gAsyncSave.worker.joinable())
+        gAsyncSave.worker.join();
+    gAsyncSave.settled = true;
+    finishRebase(gAsyncSave.ok);
+}
+
+bool startAsyncSave(World &world, const std::string &path, uint32_t seed)
+{
+    if (asyncSaveRunning())
+        return false;
+    settleAsyncSave();
+    // the snapshot is a plain copy of the dense planes and signs; the live world keeps running meanwhile
+    auto snapshot = std::make_unique<World>(world);
+    world.takeEditedChunks(); // covered by the snapshot
+    journalRebase(world, path);
+    gAsyncSave.path = path;
+    gAsyncSave.progress.store(0.0f);
+    gAsyncSave.finished.store(false);
+    gAsyncSave.ok = false;
+    gAsyncSave.settled = false;
+    gAsyncSave.reported = false;
+    gAsyncSave.worker = std::thread(
+        [snap = std::move(snapshot), path, seed]()
+        {
+            std::vector<char> buf;
+            encodeWorld(*snap, seed, buf, &gAsyncSave.progress);
+            gAsyncSave.ok = writeFileAtomically(path, buf);
+            gAsyncSave.finished.store(true, std::memory_order_release);
+        });
+    return true;
+}
+
+bool asyncSaveRunning()
+{
+    return gAsyncSave.worker.joinable() && !gAsyncSave.finished.load(std::memory_order_acquire);
+}
+
+float asyncSaveProgress() { return gAsyncSave.progress.load(std::memory_order_relaxed); }
+
+bool pollAsyncSave(std::string &pathOut, bool &okOut)
+{
+    settleAsyncSave();
+    if (gAsyncSave.reported || !gAsyncSave.settled)
+        return false;
+    gAsyncSave.reported = true;
+    pathOut = gAsyncSave.path;
+    okOut = gAsyncSave.ok;
+    return true;
+}
+
+void waitForAsyncSave()
+{
+    if (gAsyncSave.worker.joinable())
+        gAsyncSave.worker.join();
+    settleAsyncSave();
+}
+
+static bool loadChunkedWorld(World &world, ByteReader &rd, const char *fileBegin, bool latch)
+{
+    const int chunksX = (world.getWidth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const int chunksY = (world.getHeight() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const int chunksZ = (world.getDepth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    uint32_t chunkEdge = rd.get<uint32_t>();
+    uint32_t chunkCount = rd.get<uint32_t>();
+    if (!rd.ok || chunkEdge != SAVE_CHUNK || chunkCount != static_cast<uint32_t>(chunksX * chunksY * chunksZ))
+        return false;
+    std::vector<ChunkEntry> table(chunkCount);
+    if (!rd.read(table.data(), table.size() * sizeof(ChunkEntry)))
+        return false;
+
+    const size_t fileSize = static_cast<size_t>(rd.end - fileBegin);
+    uint32_t idx = 0;
+    for (int cy = 0; cy < chunksY; ++cy)
+    {
+        for (int cz = 0; cz < chunksZ; ++cz)
+        {
+            for (int cx = 0; cx < chunksX; ++cx, ++idx)
+            {
+                const ChunkEntry &e = table[idx];
+                if (e.offset > fileSize || e.size > fileSize - e.offset)
+                    return false;
+                ByteReader chunk{fileBegin + e.offset, fileBegin + e.offset + e.size};
+                if (!decodeChunk(chunk, world, saveChunkBox(world, cx, cy, cz), latch))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Versions 1-10: one fixed-size record per voxel in index order, then a global sign table
+static bool loadLegacyWorld(World &world, const SaveHeader &hdr, ByteReader &rd)
+{
+    // records are in World index order, so each y layer goes in with one importRegion
+    const size_t layer = static_cast<size_t>(world.getWidth()) * world.getDepth();
+    const std::vector<BlockType> air(layer, BlockType::Air);
+    std::vector<uint8_t> planes(layer * DENSE_PLANE_COUNT);
+    for (size_t i = 0, n = layer * world.getHeight(); i < n; ++i)
+    {
+        const size_t cell = i % layer;
+        if (cell == 0)
+            World::defaultPlanes(air.data(), static_cast<int>(layer), planes.data());
+        uint8_t b = 0, p = 0, btn = 0, btnVal = 255;
+        uint8_t btnWidth = 0;
+        uint8_t splitWidth = 1;
+        uint8_t splitOrder = 0;
+        uint8_t clkFreq = 60;
+        rd.read(&b, 1);
+        rd.read(&p, 1);
+        rd.read(&btn, 1);
+        if (hdr.version >= 6)
+            rd.read(&btnVal, 1);
+        if (hdr.version >= 7)
+            rd.read(&btnWidth, 1);
+        if (hdr.version >= 9)
+        {
+            rd.read(&splitWidth, 1);
+            rd.read(&splitOrder, 1);
+        }
+        if (hdr.version >= 10)
+        {
+            rd.read(&clkFreq, 1);
+        }
+        else if (b == static_cast<uint8_t>(BlockType::Button))
+            btnWidth = 8; // legacy saves assume full 8-bit buttons
+        if (!rd.ok)
+            return false;
+
+        // Backward compatibility: versions 1–2 were saved before XorGate was inserted
+        // into the BlockType enum, so Led/Button/Wire/Sign indices moved.
+        if (hdr.version < 3)
+        {
+            // Old mapping:
+            // 13 = Led, 14 = Button, 15 = Wire, 16 = Sign
+            // New mapping:
+            // 14 = Led, 15 = Button, 16 = Wire, 17 = Sign
+            if (b == 13)
+                b = static_cast<uint8_t>(BlockType::Led);
+            else if (b == 14)
+                b = static_cast<uint8_t>(BlockType::Button);
+            else if (b == 15)
+                b = static_cast<uint8_t>(BlockType::Wire);
+            else if (b == 16)
+                b = static_cast<uint8_t>(BlockType::Sign);
+        }
+
+        planes[PlaneTiles * layer + cell] = b;
+        planes[PlanePower * layer + cell] = p;
+        planes[PlaneButtonState * layer + cell] = btn;
+        if (b == static_cast<uint8_t>(BlockType::Button))
+        {
+            // For maps saved before version 8, force default 1-bit value = 1
+            if (hdr.version < 8)
+            {
+                btnWidth = 1;
+                btnVal = 1;
+            }
+            storeButton(planes.data(), layer, cell, btnVal, btnWidth == 0 ? 8 : btnWidth);
+        }
+        if (b == static_cast<uint8_t>(BlockType::Splitter) || b == static_cast<uint8_t>(BlockType::Merger))
+        {
+            if (hdr.version < 9)
+            {
+                splitWidth = 1;
+                splitOrder = 0;
+            }
+            storeSplitter(planes.data(), layer, cell, splitWidth == 0 ? 1 : splitWidth, splitOrder);
+        }
+        if (b == static_cast<uint8_t>(BlockType::Clock))
+        {
+            if (hdr.version < 10)
+                clkFreq = 60;
+            storeClock(planes.data(), layer, cell, clkFreq == 0 ? 1 : clkFreq);
+        }
+        if (cell == layer - 1)
+            world.importRegion(0, static_cast<int>(i / layer), 0, world.getWidth(), 1, world.getDepth(), planes.data());
+    }
+
+    // Load sign texts for version >= 2
+    if (hdr.version >= 2)
+    {
+        uint32_t signCount = rd.get<uint32_t>();
+        if (!rd.ok)
+            return false;
+        for (uint32_t i = 0; i < signCount; ++i)
+        {
+            uint32_t idx = rd.get<uint32_t>();
+            uint16_t len = rd.get<uint16_t>();
+            const char *txt = rd.take(len);
+            if (!txt)
+                return false;
+            int x = static_cast<int>(idx % static_cast<uint32_t>(world.getWidth()));
+            int y = static_cast<int>((idx / static_cast<uint32_t>(world.getWidth())) /
+                                     static_cast<uint32_t>(world.getDepth()));
+            int z = static_cast<int>((idx / static_cast<uint32_t>(world.getWidth())) %
+                                     static_cast<uint32_t>(world.getDepth()));
+            if (world.inside(x, y, z) && world.get(x, y, z) == BlockType::Sign)
+            {
+                world.setSignText(x, y, z, std::string(txt, txt + len));
+            }
+        }
+    }
+    return true;
+}
+
+bool loadWorldFromFile(World &world, const std::string &path, uint32_t &seedOut)
+{
+    // One read for the whole file; both formats then parse from memory
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    std::streamoff size = in.tellg();
+    if (size < static_cast<std::streamoff>(sizeof(SaveHeader)))
+        return false;
+    std::vector<char> data(static_cast<size_t>(size));
+    in.seekg(0);
+    in.read(data.data(), size);
+    if (!in)
+        return false;
+
+    ByteReader rd{data.data(), data.data() + data.size()};
+    SaveHeader hdr{};
+    rd.read(&hdr, sizeof(hdr));
+    if (std::string(hdr.magic, hdr.magic + 7) != "BULLDOG")
+        return false;
+    if (hdr.version < 1 || hdr.version > SAVE_VERSION_LATCH)
+        return false;
+    if (hdr.w != static_cast<uint32_t>(world.getWidth()) || hdr.h != static_cast<uint32_t>(world.getHeight()) ||
+        hdr.d != static_cast<uint32_t>(world.getDepth()))
+        return false;
+
+    if (hdr.version == SAVE_VERSION_MAPPED)
+    {
+        // copied in rather than left mapped
+        bool ok = mapWorldFile(world, path, seedOut);
+        unmapWorld(world);
+        return ok;
+    }
+    // the loaders below write into the world, which must not be a map file's memory anymore
+    unmapWorld(world);
+
+    bool ok = hdr.version >= SAVE_VERSION_CHUNKED
+                  ? loadChunkedWorld(world, rd, data.data(), hdr.version == SAVE_VERSION_LATCH)
+                  : loadLegacyWorld(world, hdr, rd);
+    if (!ok)
+        return false;
+    seedOut = hdr.seed;
+    world.takeEditedChunks(); // a fresh load is not an edit
+    world.setLogicTick(0);
+    markAllChunksDirty();
+    return true;
+}
+
+// ---------- Streaming load ----------
+// The chunk column under the focus is applied before beginStreamingLoad returns; a worker decodes the rest in
+// order of distance from it and the main thread applies whatever is ready each frame.
+struct StreamingLoad
+{
+    std::thread worker;
+    std::string path;
+    std::vector<ChunkEntry> entries; // the worker's chunks, nearest first
+    std::vector<ChunkBox> boxes;     // matching entries
+    std::mutex lock;
+    std::vector<std::unique_ptr<DecodedChunk>> ready; // decoded, not yet applied
+    std::atomic<bool> finished{false};
+    std::atomic<bool> failed{false};
+    std::atomic<bool> cancel{false};
+    size_t applied = 0;
+    size_t total = 0; // chunks in the file
+    bool latch = false; // version 13 payloads
+    bool active = false;
+};
+static StreamingLoad gStream;
+
+static void streamWorker()
+{
+    std::ifstream in(gStream.path, std::ios::binary);
+    std::vector<char> payload;
+    size_t i = 0;
+    for (; i < gStream.entries.size() && !gStream.cancel; ++i)
+    {
+        const ChunkEntry &e = gStream.entries[i];
+        payload.resize(e.size);
+        in.seekg(e.offset);
+        in.read(payload.data(), e.size);
+        auto chunk = std::make_unique<DecodedChunk>();
+        ByteReader rd{payload.data(), payload.data() + payload.size()};
+        if (!in || !parseChunk(rd, gStream.boxes[i], gStream.latch, *chunk))
+            break;
+        std::lock_guard<std::mutex> guard(gStream.lock);
+        gStream.ready.push_back(std::move(chunk));
+    }
+    gStream.failed = i < gStream.entries.size() && !gStream.cancel;
+    gStream.finished = true;
+}
+
+void cancelStreamingLoad()
+{
+    if (!gStream.active)
+        return;
+    gStream.cancel = true;
+    gStream.worker.join();
+    gStream.ready.clear();
+    gStream.active = false;
+}
+
+bool beginStreamingLoad(World &world, const std::string &path, int focusX, int focusZ, uint32_t &seedOut)
+{
+    cancelStreamingLoad();
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    const std::streamoff fileSize = in.tellg();
+    in.seekg(0);
+    SaveHeader hdr{};
+    in.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
+    if (!in || std::string(hdr.magic, hdr.magic + 7) != "BULLDOG" ||
+        (hdr.version != SAVE_VERSION_CHUNKED && hdr.version != SAVE_VERSION_LATCH))
+        return false;
+    const bool latch = hdr.version == SAVE_VERSION_LATCH;
+    if (hdr.w != static_cast<uint32_t>(world.getWidth()) || hdr.h != static_cast<uint32_t>(world.getHeight()) ||
+        hdr.d != static_cast<uint32_t>(world.getDepth()))
+        return false;
+    const int chunksX = (world.getWidth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const int chunksY = (world.getHeight() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const int chunksZ = (world.getDepth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    uint32_t chunkEdge = 0, chunkCount = 0;
+    in.read(reinterpret_cast<char *>(&chunkEdge), sizeof(chunkEdge));
+    in.read(reinterpret_cast<char *>(&chunkCount), sizeof(chunkCount));
+    if (!in || chunkEdge != SAVE_CHUNK || chunkCount != static_cast<uint32_t>(chunksX * chunksY * chunksZ))
+        return false;
+    std::vector<ChunkEntry> table(chunkCount);
+    in.read(reinterpret_cast<char *>(table.data()), table.size() * sizeof(ChunkEntry));
+    if (!in)
+        return false;
+    for (const ChunkEntry &e : table)
+    {
+        if (e.offset > fileSize || e.size > fileSize - e.offset)
+            return false;
+    }
+
+    // Column under the focus first, then by horizontal chunk distance; bottom to top within a column
+    const int fx = std::clamp(focusX, 0, world.getWidth() - 1) / SAVE_CHUNK;
+    const int fz = std::clamp(focusZ, 0, world.getDepth() - 1) / SAVE_CHUNK;
+    std::vector<std::pair<int, uint32_t>> order(chunkCount);
+    for (uint32_t idx = 0; idx < chunkCount; ++idx)
+    {
+        int dx = static_cast<int>(idx) % chunksX - fx;
+        int dz = (static_cast<int>(idx) / chunksX) % chunksZ - fz;
+        order[idx] = {dx * dx + dz * dz, idx};
+    }
+    std::sort(order.begin(), order.end());
+
+    // the focus column is parsed before the world is touched, so a bad file leaves it as it was
+    std::vector<std::unique_ptr<DecodedChunk>> column;
+    size_t i = 0;
+    for (; i < order.size() && order[i].first == 0; ++i)
+    {
+        const ChunkEntry &e = table[order[i].second];
+        std::vector<char> payload(e.size);
+        in.seekg(e.offset);
+        in.read(payload.data(), e.size);
+        ByteReader rd{payload.data(), payload.data() + payload.size()};
+        column.push_back(std::make_unique<DecodedChunk>());
+        if (!in || !parseChunk(rd, chunkBoxFromIndex(world, static_cast<int>(order[i].second)), latch, *column.back()))
+            return false;
+    }
+    unmapWorld(world);
+    stopJournal(); // the previous world's journal no longer describes what is loaded
+    world.clear();
+    markAllChunksDirty();
+    for (const auto &chunk : column)
+        applyChunk(world, *chunk);
+
+    gStream.path = path;
+    gStream.entries.clear();
+    gStream.boxes.clear();
+    for (; i < order.size(); ++i)
+    {
+        gStream.entries.push_back(table[order[i].second]);
+        gStream.boxes.push_back(chunkBoxFromIndex(world, static_cast<int>(order[i].second)));
+    }
+    gStream.finished = false;
+    gStream.failed = false;
+    gStream.cancel = false;
+    gStream.total = chunkCount;
+    gStream.latch = latch;
+    gStream.applied = chunkCount - gStream.entries.size();
+    gStream.active = true;
+    gStream.worker = std::thread(streamWorker);
+    seedOut = hdr.seed;
+    return true;
+}
+
+bool streamingLoadActive()
+{
+    return gStream.active;
+}
+
+float streamingLoadProgress()
+{
+    return gStream.total == 0 ? 1.0f : static_cast<float>(gStream.applied) / gStream.total;
+}
+
+bool pumpStreamingLoad(World &world, std::string &pathOut, bool &okOut)
+{
+    if (!gStream.active)
+        return false;
+    const bool finished = gStream.finished; // read before taking the last batch
+    std::vector<std::unique_ptr<DecodedChunk>> batch;
+    {
+        std::lock_guard<std::mutex> guard(gStream.lock);
+        batch.swap(gStream.ready);
+    }
+    for (const auto &chunk : batch)
+        applyChunk(world, *chunk); // redraws what it covers
+    gStream.applied += batch.size();
+    if (!finished)
+        return false;
+
+    gStream.worker.join();
+    gStream.active = false;
+    world.takeEditedChunks(); // a fresh load is not an edit
+    pathOut = gStream.path;
+    okOut = !gStream.failed;
+    return true;
+}
+
+// ---------- Autosave journal ----------
+// `<map>.journal` is a JournalHeader followed by records: a JournalRecord and a version 13 chunk payload (version
+// 11 in version 1 journals) holding the chunk's full state. Replaying applies records in order, so a later record
+// for a chunk wins; a torn or corrupt record ends the replay. While the base map is being rewritten the journal
+// so far is kept as `.journal.old`.
+struct JournalHeader
+{
+    char magic[8] = {'B', 'D', 'J', 'O', 'U', 'R', 'N', '\0'};
+    uint32_t version = 2;
+    uint32_t w = 0, h = 0, d = 0;
+};
+
+struct JournalRecord
+{
+    uint32_t chunk; // v11 chunk table index
+    uint32_t size;
+    uint32_t checksum; // FNV-1a of the payload
+};
+
+static const char *JOURNAL_EXT = ".journal";
+static const char *JOURNAL_OLD_EXT = ".journal.old";
+static const size_t JOURNAL_COMPACT_MIN = 256 * 1024; // compaction once the journal passes this and 4x the base
+
+struct Journal
+{
+    std::string basePath; // map the journal patches; empty while autosave is off
+    size_t bytes = 0;
+    size_t baseBytes = 0;
+    float sinceFlush = 0.0f;
+    bool rebasePending = false;        // a full save started by journalRebase is running
+    bool baseMissing = false;          // no save of this world to basePath started yet
+    std::vector<std::string> retired; // journals that save supersedes
+};
+
+static Journal gJournal;
+
+static uint32_t fnv1a(const char *data, size_t n)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i)
+    {
+        h ^= static_cast<uint8_t>(data[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void removeFile(const std::string &path)
+{
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+static size_t fileSizeOrZero(const std::string &path)
+{
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<size_t>(size);
+}
+
+static bool readWholeFile(const std::string &path, std::vector<char> &data)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    data.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(in);
+}
+
+static bool resetJournalFile(const World &world, const std::string &journalPath)
+{
+    JournalHeader hdr;
+    hdr.w = static_cast<uint32_t>(world.getWidth());
+    hdr.h = static_cast<uint32_t>(world.getHeight());
+    hdr.d = static_cast<uint32_t>(world.getDepth());
+    std::ofstream out(journalPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    gJournal.bytes = sizeof(hdr);
+    return static_cast<bool>(out);
+}
+
+// Appends the records of `from` to `to`, creating `to` with from's header if needed
+static void appendJournal(const std::string &from, const std::string &to)
+{
+    std::vector<char> data;
+    if (!readWholeFile(from, data) || data.size() <= sizeof(JournalHeader))
+        return;
+    const bool fresh = fileSizeOrZero(to) < sizeof(JournalHeader);
+    std::ofstream out(to, std::ios::binary | (fresh ? std::ios::trunc : std::ios::app));
+    size_t skip = fresh ? 0 : sizeof(JournalHeader);
+    out.write(data.data() + skip, static_cast<std::streamsize>(data.size() - skip));
+}
+
+// Applies every intact record of a journal; returns how many
+static int replayJournal(World &world, const std::string &journalPath)
+{
+    std::vector<char> data;
+    if (!readWholeFile(journalPath, data))
+        return 0;
+    ByteReader rd{data.data(), data.data() + data.size()};
+    JournalHeader hdr{};
+    rd.read(&hdr, sizeof(hdr));
+    if (!rd.ok || std::string(hdr.magic, hdr.magic + 7) != "BDJOURN" || hdr.version < 1 || hdr.version > 2 ||
+        hdr.w != static_cast<uint32_t>(world.getWidth()) || hdr.h != static_cast<uint32_t>(world.getHeight()) ||
+        hdr.d != static_cast<uint32_t>(world.getDepth()))
+        return 0;
+    const int chunksX = (world.getWidth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const int chunksY = (world.getHeight() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const int chunksZ = (world.getDepth() + SAVE_CHUNK - 1) / SAVE_CHUNK;
+    const uint32_t chunkCount = static_cast<uint32_t>(chunksX * chunksY * chunksZ);
+    int applied = 0;
+    while (rd.pos < rd.end)
+    {
+        JournalRecord rec{};
+        rd.read(&rec, sizeof(rec));
+        const char *payload = rd.take(rec.size);
+        if (!payload || rec.chunk >= chunkCount || fnv1a(payload, rec.size) != rec.checksum)
+            break;
+        ByteReader chunk{payload, payload + rec.size};
+        if (!decodeChunk(chunk, world, chunkBoxFromIndex(world, static_cast<int>(rec.chunk)), hdr.version >= 2))
+            break;
+        ++applied;
+    }
+    return applied;
+}
+
+static bool flushJournal(World &world)
+{
+    std::vector<int> chunks = world.takeEditedChunks();
+    if (chunks.empty())
+        return true;
+    std::vector<char> buf;
+    std::vector<char> payload;
+    for (int c : chunks)
+    {
+        payload.clear();
+        encodeChunk(world, chunkBoxFromIndex(world, c), payload);
+        JournalRecord rec{static_cast<uint32_t>(c), static_cast<uint32_t>(payload.size()),
+                          fnv1a(payload.data(), payload.size())};
+        put(buf, rec);
+        buf.insert(buf.end(), payload.begin(), payload.end());
+    }
+    std::ofstream out(gJournal.basePath + JOURNAL_EXT, std::ios::binary | std::ios::app);
+    out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    out.flush();
+    if (!out)
+        return false;
+    gJournal.bytes += buf.size();
+    return true;
+}
+
+static void stopJournal()
+{
+    if (gJournal.basePath.empty())
+        return;
+    removeFile(gJournal.basePath + JOURNAL_EXT);
+    removeFile(gJournal.basePath + JOURNAL_OLD_EXT);
+    gJournal = Journal{};
+}
+
+// A full save of the world to `path` was just snapshotted. New records go to path's journal from now on; the
+// journals that save makes redundant are deleted once it is on disk (finishRebase).
+static void journalRebase(const World &world, const std::string &path)
+{
+    if (gJournal.basePath.empty())
+        return;
+    const std::string journal = gJournal.basePath + JOURNAL_EXT;
+    if (gJournal.basePath == path)
+    {
+        appendJournal(journal, path + JOURNAL_OLD_EXT);
+        gJournal.retired = {path + JOURNAL_OLD_EXT};
+    }
+    else
+    {
+        gJournal.retired = {journal, gJournal.basePath + JOURNAL_OLD_EXT};
+        removeFile(path + JOURNAL_OLD_EXT);
+        gJournal.basePath = path;
+    }
+    resetJournalFile(world, path + JOURNAL_EXT);
+    gJournal.rebasePending = true;
+    gJournal.baseMissing = false;
+}
+
+static void finishRebase(bool ok)
+{
+    if (!gJournal.rebasePending)
+        return;
+    gJournal.rebasePending = false;
+    // on failure the retired journals stay, so recovery still has base + old records + new records
+    if (ok)
+    {
+        for (const auto &p : gJournal.retired)
+            removeFile(p);
+        gJournal.baseBytes = fileSizeOrZero(gJournal.basePath);
+    }
+    gJournal.retired.clear();
+}
+
+void startAutosave(World &world, const std::string &path, bool baseOnDisk)
+{
+    if (!gJournal.basePath.empty() && gJournal.basePath != path)
+        stopJournal();
+    gJournal = Journal{};
+    gJournal.basePath = path;
+    gJournal.baseMissing = !baseOnDisk;
+    gJournal.baseBytes = fileSizeOrZero(path);
+    world.takeEditedChunks();
+    removeFile(path + JOURNAL_OLD_EXT);
+    resetJournalFile(world, path + JOURNAL_EXT);
+}
+
+void autosaveTick(World &world, uint32_t seed, float dt, float intervalSeconds)
+{
+    if (intervalSeconds <= 0.0f)
+        return;
+    gJournal.sinceFlush += dt;
+    if (gJournal.sinceFlush < intervalSeconds)
+        return;
+    gJournal.sinceFlush = 0.0f;
+
+    // a mapped world already writes into its file; autosave just forces the dirty pages out
+    if (gWorldMapping.base && world.densePlanes() == gWorldMapping.base + MAPPED_PLANES_OFFSET)
+    {
+        if (!flushMapping(gWorldMapping) || !writeMappedSigns(world, gWorldMapping.path))
+            std::cerr << "Autosave flush failed: " << gWorldMapping.path << "\n";
+        return;
+    }
+    if (gJournal.basePath.empty())
+        return;
+    // records need a base to patch: the first edits write the whole world instead
+    if (gJournal.baseMissing)
+    {
+        if (world.hasEditedChunks() && !asyncSaveRunning())
+            startAsyncSave(world, gJournal.basePath, seed);
+        return;
+    }
+    if (!flushJournal(world))
+        std::cerr << "Autosave journal write failed: " << gJournal.basePath << JOURNAL_EXT << "\n";
+    if (gJournal.bytes > std::max(JOURNAL_COMPACT_MIN, gJournal.baseBytes * 4) && !asyncSaveRunning())
+        startAsyncSave(world, gJournal.basePath, seed);
+}
+
+bool recoverFromJournal(World &world, const std::string &mapsDir, std::string &pathOut, uint32_t &seedOut)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    std::vector<std::pair<fs::file_time_type, std::string>> bases;
+    for (auto &entry : fs::directory_iterator(mapsDir, ec))
+    {
+        std::string name = entry.path().string();
+        std::string base;
+        for (const char *ext : {JOURNAL_EXT, JOURNAL_OLD_EXT})
+        {
+            size_t len = std::strlen(ext);
+            if (name.size() > len && name.compare(name.size() - len, len, ext) == 0)
+                base = name.substr(0, name.size() - len);
+        }
+        // a journal holding nothing but its header has nothing to recover
+        if (!base.empty() && entry.is_regular_file() && entry.file_size() > sizeof(JournalHeader))
+            bases.emplace_back(entry.last_write_time(), base);
+    }
+    std::sort(bases.begin(), bases.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    for (const auto &candidate : bases)
+    {
+        const std::string &base = candidate.second;
+        uint32_t seed = 0;
+        if (!loadWorldFromFile(world, base, seed))
+            continue;
+        int applied = replayJournal(world, base + JOURNAL_OLD_EXT) + replayJournal(world, base + JOURNAL_EXT);
+        std::cout << "Journal: " << applied << " chunk(s) restored on " << base << "\n";
+        markAllChunksDirty();
+        // fold the journals back into the base; they are only deleted once it is written
+        gJournal = Journal{};
+        gJournal.basePath = base;
+        gJournal.baseBytes = fileSizeOrZero(base);
+        gJournal.bytes = fileSizeOrZero(base + JOURNAL_EXT);
+        startAsyncSave(world, base, seed);
+        pathOut = base;
+        seedOut = seed;
+        return true;
+    }
+    return false;
+}
+
+void stopAutosave(World &world, uint32_t seed)
+{
+    cancelStreamingLoad();
+    waitForAsyncSave();
+    if (gWorldMapping.base && world.densePlanes() == gWorldMapping.base + MAPPED_PLANES_OFFSET)
+    {
+        flushMapping(gWorldMapping);
+        writeMappedSigns(world, gWorldMapping.path);
+        return;
+    }
+    if (gJournal.basePath.empty())
+        return;
+    // a world nobody edited has nothing worth writing
+    if (gJournal.baseMissing && !world.hasEditedChunks())
+    {
+        stopJournal();
+        return;
+    }
+    // a clean exit folds everything into the base, leaving nothing to recover next start
+    if (saveWorldToFile(world, gJournal.basePath, seed))
+        stopJournal();
+    else
+        flushJournal(world);
+}
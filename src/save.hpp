@@ -0,0 +1,60 @@
+#pragma once
+
+#include "world.hpp"
+
+#include <cstdint>
+#include <string>
+
+// .bulldog world files. Saves are written as version 13: 16^3 chunks behind an offset table, each with a
+// block palette, bit-packed or run-length indices and attribute bytes only for blocks that carry state.
+// Version 11 (the same without the flip-flop clock latch) and versions 1-10 (a fixed record per voxel) still load.
+bool saveWorldToFile(const World &world, const std::string &path, uint32_t seed);
+bool loadWorldFromFile(World &world, const std::string &path, uint32_t &seedOut);
+
+// Background version 13 saves. The world is copied (dense planes and signs, a few milliseconds) and the copy
+// is encoded and written on a worker thread. Files go through a temporary sibling renamed over `path`, so an
+// interrupted save never leaves a truncated map. One save runs at a time; start fails while one is running.
+// Clears the world's edited-chunk list (the snapshot covers it) and moves the autosave journal to `path`.
+bool startAsyncSave(World &world, const std::string &path, uint32_t seed);
+bool asyncSaveRunning();
+float asyncSaveProgress(); // 0..1
+// Reports a finished save once, with its path and result
+bool pollAsyncSave(std::string &pathOut, bool &okOut);
+// Blocks until the running save (if any) is on disk
+void waitForAsyncSave();
+
+// Progressive version 11 and 13 loads. The world is cleared and the chunk column under (focusX, focusZ) applied before
+// this returns; a worker thread decodes the remaining chunks nearest-first and pumpStreamingLoad applies them on
+// the caller's thread. Logic that needs the whole circuit must wait for the load to finish. False (world
+// untouched) for other versions or a bad header; a damaged chunk ends the load with okOut false.
+bool beginStreamingLoad(World &world, const std::string &path, int focusX, int focusZ, uint32_t &seedOut);
+bool streamingLoadActive();
+float streamingLoadProgress(); // 0..1
+// Applies the chunks decoded since the last call; reports the finished load once, with its path and result
+bool pumpStreamingLoad(World &world, std::string &pathOut, bool &okOut);
+// Stops the worker, leaving whatever was applied
+void cancelStreamingLoad();
+
+// Mapped map files (version 12): a fixed header followed by the World dense planes byte for byte, then the sign
+// table. Mapping one points the world straight at the file, so loading is header validation plus an mmap and
+// pages fault in as they are touched. Edits land in the file's pages; saving to the mapped file only flushes
+// them (msync) and rewrites the signs. Saving to another path writes a fresh mapped file and moves the world
+// into it. loadWorldFromFile copies a mapped file in and detaches the world from any mapping first.
+bool saveMappedWorld(World &world, const std::string &path, uint32_t seed);
+// False (world untouched) if `path` is not a mapped file matching the world's size
+bool mapWorldFile(World &world, const std::string &path, uint32_t &seedOut);
+// Copies the dense planes back to memory and closes the mapping, if any
+void unmapWorld(World &world);
+
+// Autosave. Every interval the chunks edited since the last flush (World::takeEditedChunks) are appended to
+// `<map>.journal`, so the cost follows the edits rather than the world size. Once the journal outgrows the
+// base it is compacted by a background save of the base. A mapped world is flushed with msync instead.
+// startAutosave: `path` must already hold the world as it is (just loaded or saved), unless baseOnDisk is false
+// (a generated world): then the first flush with edits writes the whole world to `path` instead of a record.
+void startAutosave(World &world, const std::string &path, bool baseOnDisk = true);
+void autosaveTick(World &world, uint32_t seed, float dt, float intervalSeconds);
+// Finds the newest journal left in mapsDir by a crash, loads its base and replays it, then starts rewriting the
+// base in the background. False if there was nothing to recover.
+bool recoverFromJournal(World &world, const std::string &mapsDir, std::string &pathOut, uint32_t &seedOut);
+// Clean shutdown: waits for a running save, folds the journal into the base and removes it
+void stopAutosave(World &world, uint32_t seed);
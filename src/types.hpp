@@ -14,7 +14,7 @@
 #include <string>
 #include <vector>
 
-enum class BlockType
+enum class BlockType : uint8_t
 {
     Air,
     Grass,
@@ -45,13 +45,6 @@ enum class BlockType
     Clock
 };
 
-struct BlockInfo
-{
-    std::string name;
-    bool solid;
-    std::array<float, 3> color;
-};
-
 struct Player
 {
     float x = 0.0f;
@@ -118,12 +111,24 @@ struct Vertex
     float r, g, b;
 };
 
+// Slice of the shared chunk vertex arena (see gfxArenaStore), in vertices
+struct ArenaRange
+{
+    GLint first = 0;
+    GLsizei count = 0;
+};
+
 struct ChunkMesh
 {
-    std::vector<Vertex> verts;
-    std::vector<Vertex> glassVerts;
-    GLuint vbo = 0;
-    GLuint glassVbo = 0;
+    ArenaRange range;                 // opaque quads
+    ArenaRange glassRange;            // glass quads
+    std::vector<float> glassCenters;  // xyz per glass quad, kept for back-to-front sorting
+    std::vector<GLuint> glassOrder;   // glass triangles sorted back-to-front, relative to glassRange.first
+    int64_t glassSortKey = -1;
+    float boundsMin[3] = {0.0f, 0.0f, 0.0f}; // tight AABB of opaque + glass geometry
+    float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+    uint16_t faceLinks = 0x7FFF; // one bit per pair of chunk faces joined through open voxels
+    bool lod = false; // built by buildChunkLodMesh
     bool dirty = true;
 };
 
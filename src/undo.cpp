@@ -0,0 +1,244 @@
+#include "undo.hpp"
+
+#include "clipboard.hpp"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// State of one cell (region null) or of a box (region set), at (x, y, z)
+struct UndoItem
+{
+    int x = 0, y = 0, z = 0;
+    uint8_t cell[DENSE_PLANE_COUNT] = {};
+    std::string sign;
+    std::unique_ptr<Clipboard> region;
+};
+
+struct UndoStep
+{
+    std::vector<UndoItem> items; // in recording order
+    size_t bytes = 0;
+};
+
+// Ring of steps: new steps go on the back of `undo`, the front is dropped when over capacity
+struct UndoHistory
+{
+    std::deque<UndoStep> undo;
+    std::deque<UndoStep> redo;
+    size_t bytes = 0; // both stacks
+    size_t capacity = size_t{32} << 20;
+    int groupDepth = 0;
+};
+static UndoHistory gUndo;
+
+static size_t itemBytes(const UndoItem &item)
+{
+    size_t bytes = sizeof(UndoItem) + item.sign.size();
+    if (item.region)
+    {
+        const Clipboard &clip = *item.region;
+        bytes += sizeof(Clipboard) + clip.tiles.size() + clip.attributes.size() * sizeof(Clipboard::CellAttributes);
+        for (const auto &sign : clip.signs)
+            bytes += sizeof(sign) + sign.second.size();
+    }
+    return bytes;
+}
+
+static size_t stepBytes(const UndoStep &step)
+{
+    size_t bytes = sizeof(UndoStep);
+    for (const UndoItem &item : step.items)
+        bytes += itemBytes(item);
+    return bytes;
+}
+
+static void trimHistory()
+{
+    // oldest undo steps first, then the redo steps furthest away; the next step either way is always kept,
+    // even when it alone is over capacity
+    while (gUndo.bytes > gUndo.capacity && gUndo.undo.size() > 1)
+    {
+        gUndo.bytes -= gUndo.undo.front().bytes;
+        gUndo.undo.pop_front();
+    }
+    while (gUndo.bytes > gUndo.capacity && gUndo.redo.size() > 1)
+    {
+        gUndo.bytes -= gUndo.redo.front().bytes;
+        gUndo.redo.pop_front();
+    }
+}
+
+static void captureItem(const World &world, UndoItem &item)
+{
+    if (item.region)
+    {
+        Clipboard &clip = *item.region;
+        copyToClipboard(world, item.x, item.y, item.z, item.x + clip.nx - 1, item.y + clip.ny - 1,
+                        item.z + clip.nz - 1, clip);
+        return;
+    }
+    world.exportRegion(item.x, item.y, item.z, 1, 1, 1, item.cell);
+    item.sign = world.getSignText(item.x, item.y, item.z);
+}
+
+static void restoreItem(World &world, const UndoItem &item)
+{
+    if (item.region)
+    {
+        pasteClipboard(world, *item.region, item.x, item.y, item.z);
+        return;
+    }
+    world.importRegion(item.x, item.y, item.z, 1, 1, 1, item.cell);
+    if (!item.sign.empty())
+        world.setSignText(item.x, item.y, item.z, item.sign);
+}
+
+// Puts the item's state in the world and keeps the world's state in the item instead
+static void swapItem(World &world, UndoItem &item)
+{
+    UndoItem current;
+    current.x = item.x;
+    current.y = item.y;
+    current.z = item.z;
+    if (item.region)
+    {
+        current.region = std::make_unique<Clipboard>();
+        current.region->nx = item.region->nx;
+        current.region->ny = item.region->ny;
+        current.region->nz = item.region->nz;
+    }
+    captureItem(world, current);
+    restoreItem(world, item);
+    item = std::move(current);
+}
+
+static void record(UndoItem item, const World &world)
+{
+    captureItem(world, item);
+    const bool single = gUndo.groupDepth == 0;
+    if (single)
+        undoBeginGroup();
+    UndoStep &step = gUndo.undo.back();
+    const size_t bytes = itemBytes(item);
+    step.items.push_back(std::move(item));
+    step.bytes += bytes;
+    gUndo.bytes += bytes;
+    if (single)
+        undoEndGroup();
+}
+
+void undoSetCapacity(size_t bytes)
+{
+    gUndo.capacity = bytes;
+    trimHistory();
+}
+
+void undoBeginGroup()
+{
+    if (gUndo.groupDepth++ > 0)
+        return;
+    // a new edit makes the undone steps unreachable
+    for (const UndoStep &step : gUndo.redo)
+        gUndo.bytes -= step.bytes;
+    gUndo.redo.clear();
+    gUndo.undo.emplace_back();
+    gUndo.undo.back().bytes = sizeof(UndoStep);
+    gUndo.bytes += sizeof(UndoStep);
+}
+
+void undoEndGroup()
+{
+    if (gUndo.groupDepth == 0 || --gUndo.groupDepth > 0)
+        return;
+    if (gUndo.undo.back().items.empty())
+    {
+        gUndo.bytes -= gUndo.undo.back().bytes;
+        gUndo.undo.pop_back();
+    }
+    trimHistory();
+}
+
+void undoRecordCell(const World &world, int x, int y, int z)
+{
+    if (!world.inside(x, y, z))
+        return;
+    UndoItem item;
+    item.x = x;
+    item.y = y;
+    item.z = z;
+    record(std::move(item), world);
+}
+
+void undoRecordRegion(const World &world, int x, int y, int z, int nx, int ny, int nz)
+{
+    UndoItem item;
+    item.x = x;
+    item.y = y;
+    item.z = z;
+    item.region = std::make_unique<Clipboard>();
+    item.region->nx = nx;
+    item.region->ny = ny;
+    item.region->nz = nz;
+    record(std::move(item), world);
+}
+
+// Swaps a step's items with the world, last recorded first when undoing so a cell recorded twice ends up in its
+// earliest state, first recorded first when redoing
+static void applyStep(World &world, std::deque<UndoStep> &from, std::deque<UndoStep> &to, bool reverse,
+                      std::vector<std::array<int, 6>> *touched)
+{
+    UndoStep step = std::move(from.back());
+    from.pop_back();
+    if (touched)
+    {
+        for (const UndoItem &item : step.items)
+        {
+            if (item.region)
+                touched->push_back({item.x, item.y, item.z, item.region->nx, item.region->ny, item.region->nz});
+            else
+                touched->push_back({item.x, item.y, item.z, 1, 1, 1});
+        }
+    }
+    if (reverse)
+    {
+        for (auto it = step.items.rbegin(); it != step.items.rend(); ++it)
+            swapItem(world, *it);
+    }
+    else
+    {
+        for (UndoItem &item : step.items)
+            swapItem(world, item);
+    }
+    gUndo.bytes -= step.bytes;
+    step.bytes = stepBytes(step);
+    gUndo.bytes += step.bytes;
+    to.push_back(std::move(step));
+    trimHistory();
+}
+
+bool undoStep(World &world, std::vector<std::array<int, 6>> *touched)
+{
+    if (gUndo.undo.empty() || gUndo.groupDepth > 0)
+        return false;
+    applyStep(world, gUndo.undo, gUndo.redo, true, touched);
+    return true;
+}
+
+bool redoStep(World &world, std::vector<std::array<int, 6>> *touched)
+{
+    if (gUndo.redo.empty() || gUndo.groupDepth > 0)
+        return false;
+    applyStep(world, gUndo.redo, gUndo.undo, false, touched);
+    return true;
+}
+
+void undoClear()
+{
+    gUndo.undo.clear();
+    gUndo.redo.clear();
+    gUndo.bytes = 0;
+    gUndo.groupDepth = 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "world.hpp"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Undo/redo of player edits. Record the cells an edit is about to change (before changing them); everything
+// recorded between undoBeginGroup and undoEndGroup is one step, a record outside a group is a step of its own.
+// A step keeps only the previous state: a cell's plane bytes and sign text, or a box as a Clipboard, so undoing a
+// paste is itself one paste. Undo and redo swap that state with the world's. The oldest steps are dropped once
+// the history outgrows its capacity.
+void undoSetCapacity(size_t bytes);
+void undoBeginGroup();
+void undoEndGroup();
+void undoRecordCell(const World &world, int x, int y, int z);
+// Box of nx*ny*nz cells at (x, y, z), inside the world
+void undoRecordRegion(const World &world, int x, int y, int z, int nx, int ny, int nz);
+// False when there is nothing to undo / redo. `touched`, if given, receives the boxes the step rewrote as
+// {x, y, z, nx, ny, nz}.
+bool undoStep(World &world, std::vector<std::array<int, 6>> *touched = nullptr);
+bool redoStep(World &world, std::vector<std::array<int, 6>> *touched = nullptr);
+// Forgets every step (another world was loaded)
+void undoClear();
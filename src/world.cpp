@@ -1,41 +1,40 @@
 #include "world.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstring>
 #include <random>
 
 // Forward declaration for render dirty marking
-void markChunkFromBlock(int x, int y, int z);
-
-const std::map<BlockType, BlockInfo> BLOCKS = {
-    {BlockType::Air, {"Air", false, {0.7f, 0.85f, 1.0f}}},
-    {BlockType::Grass, {"Grass", true, {0.2f, 0.7f, 0.2f}}},
-    {BlockType::Dirt, {"Dirt", true, {0.62f, 0.4f, 0.22f}}},
-    {BlockType::Stone, {"Stone", true, {0.78f, 0.78f, 0.78f}}},
-    {BlockType::Wood, {"Wood", true, {0.8f, 0.65f, 0.45f}}},
-    {BlockType::Leaves, {"Leaves", true, {0.25f, 0.6f, 0.25f}}},
-    {BlockType::Water, {"Water", false, {0.2f, 0.4f, 0.9f}}},
-    {BlockType::Plank, {"Plank", true, {0.75f, 0.6f, 0.4f}}},
-    {BlockType::Sand, {"Sand", true, {0.9f, 0.8f, 0.6f}}},
-    {BlockType::Glass, {"Glass", true, {0.82f, 0.93f, 0.98f}}},
-    {BlockType::AndGate, {"AND", true, {0.18f, 0.7f, 0.32f}}},
-    {BlockType::OrGate, {"OR", true, {0.92f, 0.56f, 0.18f}}},
-    {BlockType::NotGate, {"NOT", true, {0.45f, 0.25f, 0.7f}}},
-    {BlockType::XorGate, {"XOR", true, {0.2f, 0.5f, 0.9f}}},
-    {BlockType::DFlipFlop, {"FLIPFLOP D", true, {0.2f, 0.78f, 0.72f}}},
-    {BlockType::AddGate, {"ADD", true, {0.9f, 0.42f, 0.3f}}},
-    {BlockType::Counter, {"Counter", true, {0.8f, 0.8f, 0.25f}}},
-    {BlockType::Led, {"LED", true, {0.95f, 0.9f, 0.2f}}},
-    {BlockType::Button, {"Button", true, {0.6f, 0.2f, 0.2f}}},
-    {BlockType::Wire, {"Wire", true, {0.55f, 0.57f, 0.6f}}},
-    {BlockType::Sign, {"Sign", false, {0.85f, 0.7f, 0.45f}}},
-    {BlockType::Splitter, {"Splitter", true, {0.2f, 0.75f, 0.7f}}},
-    {BlockType::Merger, {"Merger", true, {0.75f, 0.4f, 0.85f}}},
-    {BlockType::Decoder, {"Decoder", true, {0.35f, 0.55f, 0.85f}}},
-    {BlockType::Multiplexer, {"Mux", true, {0.55f, 0.35f, 0.85f}}},
-    {BlockType::Comparator, {"Comparator", true, {0.25f, 0.52f, 0.86f}}},
-    {BlockType::Clock, {"CLK", true, {0.9f, 0.82f, 0.25f}}},
-};
+bool markChunkFromBlock(int x, int y, int z);
+
+SimStats gSimStats;
+bool gSimStatsEnabled = false;
+
+// Runs stmt only when updateLogic collects counters; nothing at all in builds without LOGICRAFT_SIM_STATS
+#ifdef LOGICRAFT_SIM_STATS
+#define SIM_STAT(stmt)                                                                                                 \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (collectStats)                                                                                              \
+        {                                                                                                              \
+            stmt;                                                                                                      \
+        }                                                                                                              \
+    } while (0)
+#else
+#define SIM_STAT(stmt)                                                                                                 \
+    do                                                                                                                 \
+    {                                                                                                                  \
+    } while (0)
+#endif
+
+const char *simPhaseName(SimPhase phase)
+{
+    static const char *const names[SIM_PHASE_COUNT] = {"gate_scan", "output_writes", "wire_propagation",
+                                                       "led_pass",  "dff_commit",    "dirty_scan"};
+    return names[phase];
+}
 
 const std::vector<BlockType> HOTBAR = {BlockType::Dirt, BlockType::Grass, BlockType::Wood,
                                        BlockType::Stone, BlockType::Glass, BlockType::NotGate,
@@ -49,39 +48,272 @@ const std::vector<BlockType> INVENTORY_ALLOWED = {BlockType::Dirt, BlockType::Gr
                                                   BlockType::Decoder, BlockType::Multiplexer, BlockType::Comparator,
                                                   BlockType::Clock};
 
-bool isSolid(BlockType b) { return BLOCKS.at(b).solid; }
+World::World(int w, int h, int d)
+    : width(w), height(h), depth(d), ownedDense(static_cast<size_t>(w) * h * d * DENSE_PLANE_COUNT, 0),
+      typeCellPos(w * h * d, -1)
+{
+    const int edge = 1 << EDIT_CHUNK_SHIFT;
+    editChunksX = (w + edge - 1) / edge;
+    editChunksZ = (d + edge - 1) / edge;
+    editedFlags.assign(static_cast<size_t>(editChunksX) * editChunksZ * ((h + edge - 1) / edge), 0);
+    pointPlanes(ownedDense.data());
+    std::fill_n(powerWidth, totalSize(), uint8_t{8});
+    std::fill_n(splitterWidth, totalSize(), uint8_t{1});
+}
 
-bool occludesFaces(BlockType b)
+World::World(const World &other)
+    : width(other.width), height(other.height), depth(other.depth),
+      ownedDense(other.dense, other.dense + other.denseBytes()), signText(other.signText),
+      typeCells(other.typeCells), typeCellPos(other.typeCellPos), logicTick(other.logicTick),
+      editChunksX(other.editChunksX), editChunksZ(other.editChunksZ), editedFlags(other.editedFlags),
+      editedChunks(other.editedChunks)
 {
-    if (b == BlockType::Wire)
-        return false;
-    if (b == BlockType::Glass)
-        return false;
-    return isSolid(b);
+    pointPlanes(ownedDense.data());
 }
 
-bool isTransparent(BlockType b)
+void World::pointPlanes(uint8_t *base)
 {
-    if (b == BlockType::Wire)
-        return true;
-    if (b == BlockType::Glass)
-        return true;
-    return !isSolid(b);
+    const size_t n = static_cast<size_t>(totalSize());
+    dense = base;
+    tiles = reinterpret_cast<BlockType *>(base + PlaneTiles * n);
+    power = base + PlanePower * n;
+    powerWidth = base + PlanePowerWidth * n;
+    buttonState = base + PlaneButtonState * n;
+    buttonValue = base + PlaneButtonValue * n;
+    buttonWidth = base + PlaneButtonWidth * n;
+    splitterWidth = base + PlaneSplitterWidth * n;
+    splitterOrder = base + PlaneSplitterOrder * n;
+    clockFreq = base + PlaneClockFreq * n;
 }
 
-World::World(int w, int h, int d)
-    : width(w), height(h), depth(d), tiles(w * h * d, BlockType::Air), power(w * h * d, 0),
-      powerWidth(w * h * d, 8), buttonState(w * h * d, 0), buttonValue(w * h * d, 0),
-      buttonWidth(w * h * d, 0), splitterWidth(w * h * d, 1), splitterOrder(w * h * d, 0),
-      clockFreq(w * h * d, 0), signText(w * h * d)
+void World::bindDenseStorage(uint8_t *base, bool copyCurrent)
+{
+    if (base == dense)
+        return;
+    if (copyCurrent)
+    {
+        std::copy(dense, dense + denseBytes(), base);
+        pointPlanes(base);
+    }
+    else
+    {
+        pointPlanes(base);
+        signText.clear();
+        rebuildTypeCells();
+        unsettle(true);
+    }
+    // the heap copy is dead weight while bound
+    std::vector<uint8_t>().swap(ownedDense);
+}
+
+void World::releaseDenseStorage()
+{
+    if (!denseStorageBound())
+        return;
+    ownedDense.assign(dense, dense + denseBytes());
+    pointPlanes(ownedDense.data());
+}
+
+void World::noteEdit(int x, int y, int z)
+{
+    int c = (x >> EDIT_CHUNK_SHIFT) + editChunksX * ((z >> EDIT_CHUNK_SHIFT) + editChunksZ * (y >> EDIT_CHUNK_SHIFT));
+    if (editedFlags[c])
+        return;
+    editedFlags[c] = 1;
+    editedChunks.push_back(c);
+}
+
+// Once per chunk of the box. Render chunks share the edit chunk size; the one-cell border reaches neighbours
+// whose faces against the box may change.
+void World::noteRegion(int x0, int y0, int z0, int nx, int ny, int nz)
+{
+    const int s = EDIT_CHUNK_SHIFT;
+    for (int cy = y0 >> s; cy <= (y0 + ny - 1) >> s; ++cy)
+    {
+        for (int cz = z0 >> s; cz <= (z0 + nz - 1) >> s; ++cz)
+        {
+            for (int cx = x0 >> s; cx <= (x0 + nx - 1) >> s; ++cx)
+                noteEdit(cx << s, cy << s, cz << s);
+        }
+    }
+    const int bx0 = std::max(x0 - 1, 0), bx1 = std::min(x0 + nx, width - 1);
+    const int by0 = std::max(y0 - 1, 0), by1 = std::min(y0 + ny, height - 1);
+    const int bz0 = std::max(z0 - 1, 0), bz1 = std::min(z0 + nz, depth - 1);
+    for (int cy = by0 >> s; cy <= by1 >> s; ++cy)
+    {
+        for (int cz = bz0 >> s; cz <= bz1 >> s; ++cz)
+        {
+            for (int cx = bx0 >> s; cx <= bx1 >> s; ++cx)
+                markChunkFromBlock(cx << s, cy << s, cz << s);
+        }
+    }
+}
+
+std::vector<int> World::takeEditedChunks()
+{
+    std::vector<int> out;
+    out.swap(editedChunks);
+    for (int c : out)
+        editedFlags[c] = 0;
+    return out;
+}
+
+void World::rebuildTypeCells()
+{
+    for (auto &cells : typeCells)
+        cells.clear();
+    std::fill(typeCellPos.begin(), typeCellPos.end(), -1);
+    const int n = totalSize();
+    for (int i = 0; i < n; ++i)
+        trackCell(tiles[i], i);
+}
+
+// Block types whose cells World keeps a list of (label billboards need them every frame, the clock wheel is
+// rebuilt from the Clocks)
+static int indexedTypeSlot(BlockType b)
+{
+    switch (b)
+    {
+    case BlockType::Button:
+        return 0;
+    case BlockType::Counter:
+        return 1;
+    case BlockType::Clock:
+        return 2;
+    default:
+        return -1;
+    }
+}
+
+void World::trackCell(BlockType b, int idx)
+{
+    int slot = indexedTypeSlot(b);
+    if (slot < 0)
+        return;
+    typeCellPos[idx] = static_cast<int>(typeCells[slot].size());
+    typeCells[slot].push_back(idx);
+}
+
+void World::untrackCell(BlockType b, int idx)
+{
+    int slot = indexedTypeSlot(b);
+    if (slot < 0)
+        return;
+    // swap-remove: move the last entry into the freed position
+    std::vector<int> &cells = typeCells[slot];
+    int pos = typeCellPos[idx];
+    int last = cells.back();
+    cells[pos] = last;
+    typeCellPos[last] = pos;
+    cells.pop_back();
+    typeCellPos[idx] = -1;
+}
+
+const std::vector<int> &World::blocksOfType(BlockType b) const
+{
+    static const std::vector<int> none;
+    int slot = indexedTypeSlot(b);
+    return slot < 0 ? none : typeCells[slot];
+}
+
+// A Clock's output is high for the first half of each period of two half periods
+static uint64_t clockHalfPeriod(uint8_t freq)
+{
+    if (freq == 0)
+        freq = 1;
+    return 256 - freq;
+}
+
+// First tick from `from` on at which the output changes (goes high or low)
+static uint64_t clockEdgeFrom(uint64_t from, uint64_t half)
+{
+    const uint64_t phase = from % (2 * half);
+    if (phase == 0 || phase == half)
+        return from;
+    return from - phase + (phase < half ? half : 2 * half);
+}
+
+void World::unsettle(bool clocksChanged)
+{
+    settled = false;
+    if (clocksChanged)
+        clockWheelStale = true;
+}
+
+void World::scheduleClocks(uint64_t from)
+{
+    clockWheel.resize(CLOCK_WHEEL_SLOTS);
+    for (auto &slot : clockWheel)
+        slot.clear();
+    for (int idx : typeCells[indexedTypeSlot(BlockType::Clock)])
+    {
+        const uint64_t edge = clockEdgeFrom(from, clockHalfPeriod(clockFreq[idx]));
+        clockWheel[edge % CLOCK_WHEEL_SLOTS].push_back(idx);
+    }
+    clockWheelStale = false;
+}
+
+void World::setLogicTick(uint64_t tick)
 {
+    logicTick = tick;
+    unsettle(true);
+}
+
+int World::nextLogicTick()
+{
+    ++logicTick;
+    if (clockWheelStale)
+        scheduleClocks(logicTick);
+    std::vector<int> &slot = clockWheel[logicTick % CLOCK_WHEEL_SLOTS];
+    if (slot.empty())
+        return 0;
+    // the next edge is half a period on, always in another slot
+    std::vector<int> due;
+    due.swap(slot);
+    for (int idx : due)
+        clockWheel[(logicTick + clockHalfPeriod(clockFreq[idx])) % CLOCK_WHEEL_SLOTS].push_back(idx);
+    return static_cast<int>(due.size());
+}
+
+uint64_t World::skipSettledTicks(uint64_t maxTicks)
+{
+    if (!settled || clockWheelStale)
+        return 0;
+    // every Clock has its next edge less than a turn ahead; without Clocks nothing is scheduled at all
+    uint64_t skip = maxTicks;
+    if (!typeCells[indexedTypeSlot(BlockType::Clock)].empty())
+    {
+        skip = 0;
+        while (skip < maxTicks && clockWheel[(logicTick + skip + 1) % CLOCK_WHEEL_SLOTS].empty())
+            ++skip;
+    }
+    logicTick += skip;
+    return skip;
 }
 
 BlockType World::get(int x, int y, int z) const { return tiles[index(x, y, z)]; }
 
+void World::copyRow(int x, int y, int z, int count, BlockType *out) const
+{
+    std::fill(out, out + count, BlockType::Air);
+    if (y < 0 || y >= height || z < 0 || z >= depth)
+        return;
+    int begin = std::max(x, 0);
+    int end = std::min(x + count, width);
+    if (begin < end)
+        std::copy(tiles + index(begin, y, z), tiles + index(end - 1, y, z) + 1, out + (begin - x));
+}
+
 void World::set(int x, int y, int z, BlockType b)
 {
+    noteEdit(x, y, z);
     int idx = index(x, y, z);
+    unsettle(tiles[idx] == BlockType::Clock || b == BlockType::Clock);
+    if (tiles[idx] != b)
+    {
+        untrackCell(tiles[idx], idx);
+        trackCell(b, idx);
+    }
     tiles[idx] = b;
     power[idx] = 0;
     powerWidth[idx] = 8;
@@ -115,25 +347,155 @@ void World::set(int x, int y, int z, BlockType b)
         clockFreq[idx] = 60; // default frequency
     }
     if (b != BlockType::Sign)
-        signText[idx].clear();
+        signText.erase(idx);
+}
+
+void World::defaultPlanes(const BlockType *types, int count, uint8_t *planes)
+{
+    const size_t n = static_cast<size_t>(count);
+    std::memset(planes, 0, n * DENSE_PLANE_COUNT);
+    std::memcpy(planes + PlaneTiles * n, types, n);
+    std::memset(planes + PlanePowerWidth * n, 8, n);
+    std::memset(planes + PlaneSplitterWidth * n, 1, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (types[i] == BlockType::Button)
+        {
+            planes[PlaneButtonValue * n + i] = 1;
+            planes[PlaneButtonWidth * n + i] = 1;
+        }
+        else if (types[i] == BlockType::Clock)
+            planes[PlaneClockFreq * n + i] = 60;
+    }
+}
+
+void World::fillRegion(int x0, int y0, int z0, int nx, int ny, int nz, BlockType b)
+{
+    noteRegion(x0, y0, z0, nx, ny, nz);
+    unsettle(true);
+    uint8_t value[DENSE_PLANE_COUNT];
+    defaultPlanes(&b, 1, value);
+    const size_t n = static_cast<size_t>(totalSize());
+    for (int y = y0; y < y0 + ny; ++y)
+    {
+        for (int z = z0; z < z0 + nz; ++z)
+        {
+            const int row = index(x0, y, z);
+            for (int idx = row; idx < row + nx; ++idx)
+            {
+                BlockType old = tiles[idx];
+                if (old == b)
+                    continue;
+                untrackCell(old, idx);
+                trackCell(b, idx);
+                if (old == BlockType::Sign)
+                    signText.erase(idx);
+            }
+            for (int p = 0; p < DENSE_PLANE_COUNT; ++p)
+            {
+                // set() keeps the state byte when placing a Button (a pressed button stays pressed)
+                if (p == PlaneButtonState && b == BlockType::Button)
+                    continue;
+                std::memset(dense + p * n + row, value[p], nx);
+            }
+        }
+    }
+}
+
+void World::importRegion(int x0, int y0, int z0, int nx, int ny, int nz, const uint8_t *planes)
+{
+    noteRegion(x0, y0, z0, nx, ny, nz);
+    unsettle(true);
+    const size_t n = static_cast<size_t>(totalSize());
+    const size_t boxCells = static_cast<size_t>(nx) * ny * nz;
+    const BlockType *types = reinterpret_cast<const BlockType *>(planes + PlaneTiles * boxCells);
+    size_t src = 0;
+    for (int y = y0; y < y0 + ny; ++y)
+    {
+        for (int z = z0; z < z0 + nz; ++z, src += nx)
+        {
+            const int row = index(x0, y, z);
+            for (int i = 0; i < nx; ++i)
+            {
+                BlockType old = tiles[row + i];
+                if (old == BlockType::Sign)
+                    signText.erase(row + i);
+                if (old != types[src + i])
+                {
+                    untrackCell(old, row + i);
+                    trackCell(types[src + i], row + i);
+                }
+            }
+            for (int p = 0; p < DENSE_PLANE_COUNT; ++p)
+                std::memcpy(dense + p * n + row, planes + p * boxCells + src, nx);
+        }
+    }
+}
+
+void World::exportRegion(int x0, int y0, int z0, int nx, int ny, int nz, uint8_t *planes) const
+{
+    const size_t n = static_cast<size_t>(totalSize());
+    const size_t boxCells = static_cast<size_t>(nx) * ny * nz;
+    size_t dst = 0;
+    for (int y = y0; y < y0 + ny; ++y)
+    {
+        for (int z = z0; z < z0 + nz; ++z, dst += nx)
+        {
+            const int row = index(x0, y, z);
+            for (int p = 0; p < DENSE_PLANE_COUNT; ++p)
+                std::memcpy(planes + p * boxCells + dst, dense + p * n + row, nx);
+        }
+    }
+}
+
+void World::copyRegion(const World &src, int sx, int sy, int sz, int nx, int ny, int nz, int dx, int dy, int dz)
+{
+    // through a buffer, so an overlapping copy within one world reads the box before writing it
+    std::vector<uint8_t> planes(static_cast<size_t>(nx) * ny * nz * DENSE_PLANE_COUNT);
+    src.exportRegion(sx, sy, sz, nx, ny, nz, planes.data());
+    std::vector<std::pair<int, std::string>> signs;
+    for (const auto &entry : src.signText)
+    {
+        int x, y, z;
+        src.cellCoords(entry.first, x, y, z);
+        if (x >= sx && x < sx + nx && y >= sy && y < sy + ny && z >= sz && z < sz + nz)
+            signs.emplace_back(index(x - sx + dx, y - sy + dy, z - sz + dz), entry.second);
+    }
+    importRegion(dx, dy, dz, nx, ny, nz, planes.data());
+    for (auto &sign : signs)
+        signText[sign.first] = std::move(sign.second);
 }
 
 uint8_t World::getPower(int x, int y, int z) const { return power[index(x, y, z)]; }
 
 uint8_t World::getPowerWidth(int x, int y, int z) const { return powerWidth[index(x, y, z)]; }
 
-void World::setPower(int x, int y, int z, uint8_t v) { power[index(x, y, z)] = v; }
+void World::setPower(int x, int y, int z, uint8_t v)
+{
+    unsettle(false);
+    power[index(x, y, z)] = v;
+}
 
-void World::setPowerWidth(int x, int y, int z, uint8_t w) { powerWidth[index(x, y, z)] = w; }
+void World::setPowerWidth(int x, int y, int z, uint8_t w)
+{
+    unsettle(false);
+    powerWidth[index(x, y, z)] = w;
+}
 
 uint8_t World::getButtonState(int x, int y, int z) const { return buttonState[index(x, y, z)]; }
 
-void World::setButtonState(int x, int y, int z, uint8_t v) { buttonState[index(x, y, z)] = v; }
+void World::setButtonState(int x, int y, int z, uint8_t v)
+{
+    unsettle(false);
+    buttonState[index(x, y, z)] = v;
+}
 
 uint8_t World::getButtonValue(int x, int y, int z) const { return buttonValue[index(x, y, z)]; }
 
 void World::setButtonValue(int x, int y, int z, uint8_t v)
 {
+    noteEdit(x, y, z);
+    unsettle(false);
     int i = index(x, y, z);
     uint8_t width = buttonWidth[i];
     if (width == 0)
@@ -146,6 +508,8 @@ uint8_t World::getButtonWidth(int x, int y, int z) const { return buttonWidth[in
 
 void World::setButtonWidth(int x, int y, int z, uint8_t bits)
 {
+    noteEdit(x, y, z);
+    unsettle(false);
     int i = index(x, y, z);
     uint8_t clamped = static_cast<uint8_t>(std::clamp<int>(bits, 1, 8));
     buttonWidth[i] = clamped;
@@ -156,12 +520,16 @@ void World::setButtonWidth(int x, int y, int z, uint8_t bits)
 uint8_t World::getSplitterWidth(int x, int y, int z) const { return splitterWidth[index(x, y, z)]; }
 void World::setSplitterWidth(int x, int y, int z, uint8_t bits)
 {
+    noteEdit(x, y, z);
+    unsettle(false);
     int i = index(x, y, z);
     splitterWidth[i] = static_cast<uint8_t>(std::clamp<int>(bits, 1, 7));
 }
 uint8_t World::getSplitterOrder(int x, int y, int z) const { return splitterOrder[index(x, y, z)]; }
 void World::setSplitterOrder(int x, int y, int z, uint8_t order)
 {
+    noteEdit(x, y, z);
+    unsettle(false);
     int i = index(x, y, z);
     splitterOrder[i] = static_cast<uint8_t>(order & 0x1u);
 }
@@ -169,6 +537,8 @@ void World::setSplitterOrder(int x, int y, int z, uint8_t order)
 uint8_t World::getClockFreq(int x, int y, int z) const { return clockFreq[index(x, y, z)]; }
 void World::setClockFreq(int x, int y, int z, uint8_t freq)
 {
+    noteEdit(x, y, z);
+    unsettle(true);
     int i = index(x, y, z);
     uint8_t clamped = static_cast<uint8_t>(std::clamp<int>(freq, 1, 255));
     clockFreq[i] = clamped;
@@ -176,18 +546,28 @@ void World::setClockFreq(int x, int y, int z, uint8_t freq)
 
 void World::toggleButton(int x, int y, int z)
 {
+    noteEdit(x, y, z);
+    unsettle(false);
     int idx = index(x, y, z);
     buttonState[idx] = buttonState[idx] ? 0 : 1;
 }
 
 int World::index(int x, int y, int z) const { return (y * depth + z) * width + x; }
 
-int World::totalSize() const { return static_cast<int>(tiles.size()); }
+void World::cellCoords(int idx, int &x, int &y, int &z) const
+{
+    x = idx % width;
+    z = (idx / width) % depth;
+    y = idx / (width * depth);
+}
+
+int World::totalSize() const { return width * height * depth; }
 
 void World::overwritePower(const std::vector<uint8_t> &next, const std::vector<uint8_t> &nextW)
 {
-    power = next;
-    powerWidth = nextW;
+    unsettle(false);
+    std::copy(next.begin(), next.end(), power);
+    std::copy(nextW.begin(), nextW.end(), powerWidth);
 }
 
 int World::getWidth() const { return width; }
@@ -199,40 +579,43 @@ void World::generate(unsigned seed)
     std::mt19937 rng(seed);
     (void)rng;
 
+    // one layer at a time: each is a contiguous run of every plane
     int surface = height / 4;
-    std::fill(power.begin(), power.end(), 0);
-    std::fill(powerWidth.begin(), powerWidth.end(), 8);
-    std::fill(buttonState.begin(), buttonState.end(), 0);
-    std::fill(buttonWidth.begin(), buttonWidth.end(), 0);
-    std::fill(splitterWidth.begin(), splitterWidth.end(), 1);
-    std::fill(splitterOrder.begin(), splitterOrder.end(), 0);
-    for (int z = 0; z < depth; ++z)
+    for (int y = 0; y < height; ++y)
     {
-        for (int x = 0; x < width; ++x)
+        BlockType b = BlockType::Air;
+        if (y == 0)
         {
-            for (int y = 0; y < height; ++y)
-            {
-                BlockType b = BlockType::Air;
-                if (y == 0)
-                {
-                    b = BlockType::Stone;
-                }
-                else if (y < surface - 2)
-                {
-                    b = BlockType::Stone;
-                }
-                else if (y < surface - 1)
-                {
-                    b = BlockType::Dirt;
-                }
-                else if (y == surface - 1)
-                {
-                    b = BlockType::Grass;
-                }
-                set(x, y, z, b);
-            }
+            b = BlockType::Stone;
+        }
+        else if (y < surface - 2)
+        {
+            b = BlockType::Stone;
         }
+        else if (y < surface - 1)
+        {
+            b = BlockType::Dirt;
+        }
+        else if (y == surface - 1)
+        {
+            b = BlockType::Grass;
+        }
+        fillRegion(0, y, 0, width, 1, depth, b);
     }
+    signText.clear();
+}
+
+void World::clear()
+{
+    std::fill_n(dense, denseBytes(), uint8_t{0});
+    std::fill_n(powerWidth, totalSize(), uint8_t{8});
+    std::fill_n(splitterWidth, totalSize(), uint8_t{1});
+    signText.clear();
+    for (auto &cells : typeCells)
+        cells.clear();
+    std::fill(typeCellPos.begin(), typeCellPos.end(), -1);
+    logicTick = 0;
+    unsettle(true);
 }
 
 bool World::inside(int x, int y, int z) const
@@ -255,18 +638,21 @@ int World::surfaceY(int x, int z) const
 const std::string &World::getSignText(int x, int y, int z) const
 {
     static const std::string empty;
-    int idx = index(x, y, z);
-    if (idx < 0 || idx >= static_cast<int>(signText.size()))
+    if (!inside(x, y, z))
         return empty;
-    return signText[idx];
+    auto it = signText.find(index(x, y, z));
+    return it == signText.end() ? empty : it->second;
 }
 
 void World::setSignText(int x, int y, int z, const std::string &text)
 {
-    int idx = index(x, y, z);
-    if (idx < 0 || idx >= static_cast<int>(signText.size()))
+    if (!inside(x, y, z))
         return;
-    signText[idx] = text;
+    noteEdit(x, y, z);
+    if (text.empty())
+        signText.erase(index(x, y, z));
+    else
+        signText[index(x, y, z)] = text;
     markChunkFromBlock(x, y, z);
 }
 
@@ -397,14 +783,44 @@ HitInfo raycast(const World &world, float ox, float oy, float oz, float dx, floa
     return {0, 0, 0, 0, 0, 0, false};
 }
 
-void updateLogic(World &world)
+[[maybe_unused]] static void publishSimStats(SimStats &stats)
+{
+    // the gate scan visits every cell; keep the logic blocks (LEDs are lit by their own pass, one visit each too)
+    for (int t = 0; t < BLOCK_TYPE_COUNT; ++t)
+    {
+        BlockType b = static_cast<BlockType>(t);
+        if (!hasPorts(b) || b == BlockType::Wire)
+            stats.evaluated[t] = 0;
+    }
+    gSimStats = stats;
+}
+
+bool updateLogic(World &world)
 {
-    static uint64_t clockTick = 0;
-    ++clockTick;
+    [[maybe_unused]] const bool collectStats = gSimStatsEnabled;
+    SimStats stats;
+    const int clockEdges = world.nextLogicTick();
+    const uint64_t clockTick = world.getLogicTick();
+    SIM_STAT(stats.clockEdges = clockEdges);
+    // the last tick changed nothing, and without an edge this one would read exactly the same inputs
+    if (world.logicSettled() && clockEdges == 0)
+    {
+        SIM_STAT(stats.skipped = true; publishSimStats(stats));
+        return false;
+    }
+    std::chrono::steady_clock::time_point phaseStart;
+    [[maybe_unused]] auto endPhase = [&](SimPhase phase)
+    {
+        auto now = std::chrono::steady_clock::now();
+        stats.phaseMs[phase] = std::chrono::duration<double, std::milli>(now - phaseStart).count();
+        phaseStart = now;
+    };
+    SIM_STAT(phaseStart = std::chrono::steady_clock::now());
     int total = world.totalSize();
     std::vector<uint8_t> next(total, 0);
     std::vector<uint8_t> nextWidth(total, 8);
     std::vector<uint8_t> sourcesVal(total, 0);
+    // cells driven by each output port (see outputCell), with matching value / width lists below
     std::vector<std::array<int, 3>> gateOutputs;
     std::vector<std::array<int, 3>> notOutputs;
     std::vector<std::array<int, 3>> addSumOutputs;
@@ -489,19 +905,18 @@ void updateLogic(World &world)
         {
             next[i] = val;
             nextWidth[i] = clampedW;
-            queue.push_back(i);
         }
         else if ((next[i] | val) != next[i])
         {
             next[i] |= val;
             nextWidth[i] = std::max<uint8_t>(nextWidth[i], clampedW);
-            queue.push_back(i);
         }
         else if (clampedW > nextWidth[i])
-        {
             nextWidth[i] = clampedW;
-            queue.push_back(i);
-        }
+        else
+            return;
+        queue.push_back(i);
+        SIM_STAT(++stats.wirePushes; stats.peakQueue = std::max<uint32_t>(stats.peakQueue, queue.size()));
     };
 
     for (int y = 0; y < world.getHeight(); ++y)
@@ -521,20 +936,33 @@ void updateLogic(World &world)
             {
                 BlockType b = world.get(x, y, z);
                 uint8_t out = 0;
+                // ports resolved through the block trait table
+                auto inPower = [&](int port)
+                {
+                    auto c = inputCell(b, port, x, y, z);
+                    return powerAt(c[0], c[1], c[2]);
+                };
+                auto inWidth = [&](int port)
+                {
+                    auto c = inputCell(b, port, x, y, z);
+                    return widthAt(c[0], c[1], c[2]);
+                };
+                auto outCell = [&](int port)
+                { return outputCell(b, port, x, y, z); };
                 switch (b)
                 {
                 case BlockType::AndGate:
                 {
-                    uint8_t inA = powerAt(x - 1, y, z);
-                    uint8_t inB = powerAt(x + 1, y, z);
-                    uint8_t w = static_cast<uint8_t>(std::min(widthAt(x - 1, y, z), widthAt(x + 1, y, z)));
+                    uint8_t inA = inPower(0);
+                    uint8_t inB = inPower(1);
+                    uint8_t w = static_cast<uint8_t>(std::min(inWidth(0), inWidth(1)));
                     if (w == 0)
                         w = 8;
                     uint8_t mask = w >= 8 ? 0xFFu : static_cast<uint8_t>((1u << w) - 1u);
                     out = static_cast<uint8_t>((inA & mask) & (inB & mask));
                     if (out)
                     {
-                        gateOutputs.push_back({x, y, z});
+                        gateOutputs.push_back(outCell(0));
                         gateOutVal.push_back(out);
                         gateOutWidth.push_back(w);
                     }
@@ -542,16 +970,16 @@ void updateLogic(World &world)
                 }
                 case BlockType::OrGate:
                 {
-                    uint8_t inA = powerAt(x - 1, y, z);
-                    uint8_t inB = powerAt(x + 1, y, z);
-                    uint8_t w = static_cast<uint8_t>(std::min(widthAt(x - 1, y, z), widthAt(x + 1, y, z)));
+                    uint8_t inA = inPower(0);
+                    uint8_t inB = inPower(1);
+                    uint8_t w = static_cast<uint8_t>(std::min(inWidth(0), inWidth(1)));
                     if (w == 0)
                         w = 8;
                     uint8_t mask = w >= 8 ? 0xFFu : static_cast<uint8_t>((1u << w) - 1u);
                     out = static_cast<uint8_t>((inA & mask) | (inB & mask));
                     if (out)
                     {
-                        gateOutputs.push_back({x, y, z});
+                        gateOutputs.push_back(outCell(0));
                         gateOutVal.push_back(out);
                         gateOutWidth.push_back(w);
                     }
@@ -559,16 +987,16 @@ void updateLogic(World &world)
                 }
                 case BlockType::XorGate:
                 {
-                    uint8_t inA = powerAt(x - 1, y, z);
-                    uint8_t inB = powerAt(x + 1, y, z);
-                    uint8_t w = static_cast<uint8_t>(std::min(widthAt(x - 1, y, z), widthAt(x + 1, y, z)));
+                    uint8_t inA = inPower(0);
+                    uint8_t inB = inPower(1);
+                    uint8_t w = static_cast<uint8_t>(std::min(inWidth(0), inWidth(1)));
                     if (w == 0)
                         w = 8;
                     uint8_t mask = w >= 8 ? 0xFFu : static_cast<uint8_t>((1u << w) - 1u);
                     out = static_cast<uint8_t>((inA & mask) ^ (inB & mask));
                     if (out)
                     {
-                        gateOutputs.push_back({x, y, z});
+                        gateOutputs.push_back(outCell(0));
                         gateOutVal.push_back(out);
                         gateOutWidth.push_back(w);
                     }
@@ -582,11 +1010,11 @@ void updateLogic(World &world)
                         storedW = 8;
                     uint8_t storedMask = storedW >= 8 ? 0xFFu : static_cast<uint8_t>((1u << storedW) - 1u);
                     storedQ &= storedMask;
-                    uint8_t dIn = powerAt(x + 1, y, z);        // D on +X
-                    uint8_t dW = widthAt(x + 1, y, z);
+                    uint8_t dIn = inPower(0); // D on +X
+                    uint8_t dW = inWidth(0);
                     if (dW == 0)
                         dW = 8;
-                    uint8_t clk = powerAt(x - 1, y, z) ? 1 : 0; // CLK on -X (bool)
+                    uint8_t clk = inPower(1) ? 1 : 0; // CLK on -X (bool)
                     uint8_t prevClk = world.getButtonState(x, y, z) ? 1 : 0;
                     uint8_t nextQ = storedQ;
                     uint8_t nextW = storedW ? storedW : dW;
@@ -599,7 +1027,7 @@ void updateLogic(World &world)
 
                     if (nextQ)
                     {
-                        gateOutputs.push_back({x, y, z});
+                        gateOutputs.push_back(outCell(0));
                         gateOutVal.push_back(nextQ);
                         gateOutWidth.push_back(nextW);
                     }
@@ -614,29 +1042,29 @@ void updateLogic(World &world)
                 }
                 case BlockType::AddGate:
                 {
-                    uint8_t wP = widthAt(x - 1, y, z);
-                    uint8_t wQ = widthAt(x + 1, y, z);
+                    uint8_t wP = inWidth(0);
+                    uint8_t wQ = inWidth(1);
                     uint8_t bitWidth = static_cast<uint8_t>(std::min<uint8_t>(std::max<uint8_t>(wP ? wP : 1, wQ ? wQ : 1), 8));
                     if (bitWidth == 0)
                         bitWidth = 1;
                     uint8_t mask = bitWidth >= 8 ? 0xFFu : static_cast<uint8_t>((1u << bitWidth) - 1u);
 
-                    uint8_t p = powerAt(x - 1, y, z) & mask;   // P on -X
-                    uint8_t q = powerAt(x + 1, y, z) & mask;   // Q on +X
-                    uint8_t cin = powerAt(x, y, z - 1) ? 1 : 0; // Cin on -Z (bool)
+                    uint8_t p = inPower(0) & mask;   // P on -X
+                    uint8_t q = inPower(1) & mask;   // Q on +X
+                    uint8_t cin = inPower(2) ? 1 : 0; // Cin on -Z (bool)
                     uint16_t res = static_cast<uint16_t>(p) + static_cast<uint16_t>(q) +
                                    static_cast<uint16_t>(cin);
                     uint8_t sum = static_cast<uint8_t>(res & mask);
                     uint8_t cout = (res >> bitWidth) ? 0xFF : 0x00;
                     if (sum)
                     {
-                        addSumOutputs.push_back({x, y, z});
+                        addSumOutputs.push_back(outCell(0));
                         addSumVal.push_back(sum);
                         addSumWidth.push_back(bitWidth);
                     }
                     if (cout)
                     {
-                        addCoutOutputs.push_back({x, y, z});
+                        addCoutOutputs.push_back(outCell(1));
                         addCoutVal.push_back(cout);
                         addCoutWidth.push_back(1);
                     }
@@ -645,15 +1073,15 @@ void updateLogic(World &world)
                 }
                 case BlockType::NotGate:
                 {
-                    uint8_t w = widthAt(x + 1, y, z);
+                    uint8_t w = inWidth(0);
                     if (w == 0)
                         w = 8;
                     uint8_t mask = w >= 8 ? 0xFFu : static_cast<uint8_t>((1u << w) - 1u);
-                    uint8_t inA = powerAt(x + 1, y, z) & mask; // input on +X (right)
+                    uint8_t inA = inPower(0) & mask; // input on +X (right)
                     out = static_cast<uint8_t>(~inA & mask);
                     if (out)
                     {
-                        notOutputs.push_back({x, y, z});
+                        notOutputs.push_back(outCell(0));
                         notOutVal.push_back(out);
                         notOutWidth.push_back(w);
                     }
@@ -674,19 +1102,19 @@ void updateLogic(World &world)
                 case BlockType::Counter:
                 {
                     // Single input on +X
-                    uint8_t val = powerAt(x + 1, y, z);
+                    uint8_t val = inPower(0);
                     next[idx(x, y, z)] = val;
-                    nextWidth[idx(x, y, z)] = widthAt(x + 1, y, z);
+                    nextWidth[idx(x, y, z)] = inWidth(0);
                     out = 0;
                     break;
                 }
                 case BlockType::Splitter:
                 {
-                    uint8_t busW = widthAt(x, y, z - 1);
+                    uint8_t busW = inWidth(0);
                     if (busW == 0)
                         busW = 1;
                     uint8_t busMask = busW >= 8 ? 0xFFu : static_cast<uint8_t>((1u << busW) - 1u);
-                    uint8_t busVal = powerAt(x, y, z - 1) & busMask;
+                    uint8_t busVal = inPower(0) & busMask;
                     uint8_t wParam = world.getSplitterWidth(x, y, z);
                     uint8_t order = world.getSplitterOrder(x, y, z);
                     uint8_t w1 = std::clamp<uint8_t>(wParam, 1, static_cast<uint8_t>(std::max<int>(1, busW - 1)));
@@ -704,10 +1132,12 @@ void updateLogic(World &world)
                         out2 = busVal & mask2;                     // LSB chunk -> B2 (+X)
                         out1 = static_cast<uint8_t>((busVal >> w2) & mask1); // MSB chunk -> B1 (-X)
                     }
+                    auto b1 = outCell(0);
+                    auto b2 = outCell(1);
                     if (out1)
-                        pushWire(x - 1, y, z, out1, w1); // B1 on -X
+                        pushWire(b1[0], b1[1], b1[2], out1, w1); // B1 on -X
                     if (out2)
-                        pushWire(x + 1, y, z, out2, w2); // B2 on +X
+                        pushWire(b2[0], b2[1], b2[2], out2, w2); // B2 on +X
                     out = 0;
                     break;
                 }
@@ -715,8 +1145,8 @@ void updateLogic(World &world)
                 {
                     uint8_t wParam = world.getSplitterWidth(x, y, z);
                     uint8_t order = world.getSplitterOrder(x, y, z);
-                    uint8_t inW1 = widthAt(x - 1, y, z);
-                    uint8_t inW2 = widthAt(x + 1, y, z);
+                    uint8_t inW1 = inWidth(0);
+                    uint8_t inW2 = inWidth(1);
                     if (inW1 == 0)
                         inW1 = 8;
                     if (inW2 == 0)
@@ -725,28 +1155,29 @@ void updateLogic(World &world)
                     uint8_t w2 = static_cast<uint8_t>(std::max<int>(1, std::min<int>(8 - w1, inW2)));
                     uint8_t mask1 = w1 >= 8 ? 0xFFu : static_cast<uint8_t>((1u << w1) - 1u);
                     uint8_t mask2 = w2 >= 8 ? 0xFFu : static_cast<uint8_t>((1u << w2) - 1u);
-                    uint8_t in1 = powerAt(x - 1, y, z) & mask1;
-                    uint8_t in2 = powerAt(x + 1, y, z) & mask2;
+                    uint8_t in1 = inPower(0) & mask1;
+                    uint8_t in2 = inPower(1) & mask2;
                     uint8_t busW = static_cast<uint8_t>(std::min<int>(8, w1 + w2));
                     uint8_t busVal = 0;
                     if (order == 0)
                         busVal = static_cast<uint8_t>(in1 | static_cast<uint8_t>(in2 << w1)); // B1 in LSB
                     else
                         busVal = static_cast<uint8_t>((in1 << w2) | in2); // B1 in MSB
+                    auto bus = outCell(0);
                     if (busVal)
-                        pushWire(x, y, z + 1, busVal, busW); // BUS out on +Z
+                        pushWire(bus[0], bus[1], bus[2], busVal, busW); // BUS out on +Z
                     out = 0;
                     break;
                 }
                 case BlockType::Decoder:
                 {
-                    uint8_t selW = widthAt(x - 1, y, z);
+                    uint8_t selW = inWidth(0);
                     if (selW == 0)
                         selW = 8;
                     uint8_t effectiveSelW = std::max<uint8_t>(1, std::min<uint8_t>(selW, 3)); // clamp to 1-3 bits (up to 8 outs)
                     uint8_t selMask = effectiveSelW >= 8 ? 0xFFu : static_cast<uint8_t>((1u << effectiveSelW) - 1u);
-                    uint8_t selVal = powerAt(x - 1, y, z) & selMask;
-                    bool enable = (powerAt(x + 1, y, z) & 0x1u) != 0;
+                    uint8_t selVal = inPower(0) & selMask;
+                    bool enable = (inPower(1) & 0x1u) != 0;
                     if (enable)
                     {
                         uint8_t bit = static_cast<uint8_t>(selVal & 0x7u);
@@ -754,7 +1185,8 @@ void updateLogic(World &world)
                         {
                             uint8_t outVal = static_cast<uint8_t>(1u << bit);
                             uint8_t outW = static_cast<uint8_t>(1u << effectiveSelW);
-                            pushWire(x, y, z + 1, outVal, outW);
+                            auto o = outCell(0);
+                            pushWire(o[0], o[1], o[2], outVal, outW);
                         }
                     }
                     out = 0;
@@ -762,53 +1194,46 @@ void updateLogic(World &world)
                 }
                 case BlockType::Multiplexer:
                 {
-                    uint8_t selW = widthAt(x - 1, y, z);
+                    uint8_t selW = inWidth(0);
                     if (selW == 0)
                         selW = 8;
                     uint8_t effectiveSelW = std::max<uint8_t>(1, std::min<uint8_t>(selW, 2)); // 2 bits max
                     uint8_t selMask = static_cast<uint8_t>((1u << effectiveSelW) - 1u);
-                    uint8_t selVal = powerAt(x - 1, y, z) & selMask;
+                    uint8_t selVal = inPower(0) & selMask;
 
-                    auto inputVal = [&](int dx, int dy, int dz, uint8_t &wOut) -> uint8_t
+                    auto inputVal = [&](int port, uint8_t &wOut) -> uint8_t
                     {
-                        wOut = widthAt(x + dx, y + dy, z + dz);
+                        wOut = inWidth(port);
                         if (wOut == 0)
                             wOut = 8;
                         uint8_t mask = wOut >= 8 ? 0xFFu : static_cast<uint8_t>((1u << wOut) - 1u);
-                        return static_cast<uint8_t>(powerAt(x + dx, y + dy, z + dz) & mask);
+                        return static_cast<uint8_t>(inPower(port) & mask);
                     };
 
                     uint8_t widths[4] = {0, 0, 0, 0};
                     uint8_t values[4] = {0, 0, 0, 0};
-                    // Inputs: 0=-Z, 1=+Z, 2=-Y, 3=+Y
-                    values[0] = inputVal(0, 0, -1, widths[0]);
-                    values[1] = inputVal(0, 0, 1, widths[1]);
-                    values[2] = inputVal(0, -1, 0, widths[2]);
-                    values[3] = inputVal(0, 1, 0, widths[3]);
+                    // Inputs: 0=-Z, 1=+Z, 2=-Y, 3=+Y (ports 1-4, port 0 is SEL)
+                    for (int i = 0; i < 4; ++i)
+                        values[i] = inputVal(i + 1, widths[i]);
 
                     uint8_t idxSel = static_cast<uint8_t>(selVal & 0x3u);
                     uint8_t outVal = values[idxSel];
                     uint8_t outWidth = widths[idxSel];
+                    auto o = outCell(0);
                     if (outVal)
-                        pushWire(x + 1, y, z, outVal, outWidth);
+                        pushWire(o[0], o[1], o[2], outVal, outWidth);
                     else
-                        setPower(x + 1, y, z, 0, outWidth);
+                        setPower(o[0], o[1], o[2], 0, outWidth);
                     out = 0;
                     break;
                 }
                 case BlockType::Clock:
                 {
-                    uint8_t freq = world.getClockFreq(x, y, z);
-                    if (freq == 0)
-                        freq = 1;
-                    uint16_t halfPeriod = static_cast<uint16_t>(256 - freq);
-                    if (halfPeriod == 0)
-                        halfPeriod = 1;
-                    uint16_t period = static_cast<uint16_t>(halfPeriod * 2);
-                    bool high = (clockTick % period) < halfPeriod;
+                    const uint64_t halfPeriod = clockHalfPeriod(world.getClockFreq(x, y, z));
+                    bool high = (clockTick % (2 * halfPeriod)) < halfPeriod;
                     if (high)
                     {
-                        gateOutputs.push_back({x, y, z});
+                        gateOutputs.push_back(outCell(0));
                         gateOutVal.push_back(1u);
                         gateOutWidth.push_back(1u);
                     }
@@ -817,25 +1242,14 @@ void updateLogic(World &world)
                 }
                 case BlockType::Comparator:
                 {
-                    uint8_t wA = widthAt(x - 1, y, z);
-                    uint8_t wB = widthAt(x + 1, y, z);
-                    BlockType bLeft = world.inside(x - 1, y, z) ? world.get(x - 1, y, z) : BlockType::Air;
-                    BlockType bRight = world.inside(x + 1, y, z) ? world.get(x + 1, y, z) : BlockType::Air;
-                    bool leftConnected = (bLeft == BlockType::Wire || bLeft == BlockType::Button || bLeft == BlockType::Led ||
-                                          bLeft == BlockType::AndGate || bLeft == BlockType::OrGate ||
-                                          bLeft == BlockType::XorGate || bLeft == BlockType::NotGate ||
-                                          bLeft == BlockType::DFlipFlop || bLeft == BlockType::AddGate ||
-                                          bLeft == BlockType::Counter || bLeft == BlockType::Splitter ||
-                                          bLeft == BlockType::Merger || bLeft == BlockType::Decoder ||
-                                          bLeft == BlockType::Multiplexer || bLeft == BlockType::Comparator ||
-                                          bLeft == BlockType::Clock);
-                    bool rightConnected =
-                        (bRight == BlockType::Wire || bRight == BlockType::Button || bRight == BlockType::Led ||
-                         bRight == BlockType::AndGate || bRight == BlockType::OrGate || bRight == BlockType::XorGate ||
-                         bRight == BlockType::NotGate || bRight == BlockType::DFlipFlop || bRight == BlockType::AddGate ||
-                         bRight == BlockType::Counter || bRight == BlockType::Splitter || bRight == BlockType::Merger ||
-                         bRight == BlockType::Decoder || bRight == BlockType::Multiplexer || bRight == BlockType::Comparator ||
-                         bRight == BlockType::Clock);
+                    auto left = inputCell(b, 0, x, y, z);
+                    auto right = inputCell(b, 1, x, y, z);
+                    uint8_t wA = inWidth(0);
+                    uint8_t wB = inWidth(1);
+                    bool leftConnected = world.inside(left[0], left[1], left[2]) &&
+                                         hasPorts(world.get(left[0], left[1], left[2]));
+                    bool rightConnected = world.inside(right[0], right[1], right[2]) &&
+                                          hasPorts(world.get(right[0], right[1], right[2]));
                     if (!leftConnected && !rightConnected)
                     {
                         out = 0;
@@ -849,12 +1263,12 @@ void updateLogic(World &world)
                     uint8_t w = static_cast<uint8_t>(std::max<uint8_t>(1, std::min<uint8_t>(std::min(wA, wB), 8)));
                     uint16_t mask16 = w >= 8 ? 0xFFu : static_cast<uint16_t>((1u << w) - 1u);
                     // Swap A/B semantics: left face is B, right face is A
-                    uint8_t bVal = static_cast<uint8_t>(powerAt(x - 1, y, z) & mask16);
-                    uint8_t a = static_cast<uint8_t>(powerAt(x + 1, y, z) & mask16);
+                    uint8_t bVal = static_cast<uint8_t>(inPower(0) & mask16);
+                    uint8_t a = static_cast<uint8_t>(inPower(1) & mask16);
                     uint8_t outW = 1;
-                    compGtOutputs.push_back({x, y, z});
-                    compEqOutputs.push_back({x, y, z});
-                    compLtOutputs.push_back({x, y, z});
+                    compGtOutputs.push_back(outCell(0));
+                    compEqOutputs.push_back(outCell(1));
+                    compLtOutputs.push_back(outCell(2));
                     compGtVal.push_back(a > bVal ? 1u : 0u);
                     compEqVal.push_back(a == bVal ? 1u : 0u);
                     compLtVal.push_back(a < bVal ? 1u : 0u);
@@ -868,6 +1282,7 @@ void updateLogic(World &world)
                     out = 0;
                     break;
                 }
+                SIM_STAT(++stats.evaluated[static_cast<int>(b)]);
                 if (out && b == BlockType::Button)
                 {
                     sourcesVal[idx(x, y, z)] = out;
@@ -878,9 +1293,14 @@ void updateLogic(World &world)
         }
     }
 
+    SIM_STAT(endPhase(SimGateScan));
+
     for (int i = 0; i < total; ++i)
         if (sourcesVal[i])
+        {
             queue.push_back(i);
+            SIM_STAT(++stats.wirePushes; stats.peakQueue = std::max<uint32_t>(stats.peakQueue, queue.size()));
+        }
 
     for (size_t idxOut = 0; idxOut < gateOutputs.size(); ++idxOut)
     {
@@ -889,7 +1309,7 @@ void updateLogic(World &world)
         uint8_t w = gateOutWidth[idxOut];
         int ox = g[0];
         int oy = g[1];
-        int oz = g[2] + 1;
+        int oz = g[2];
         if (!world.inside(ox, oy, oz))
             continue;
         BlockType outB = world.get(ox, oy, oz);
@@ -910,7 +1330,7 @@ void updateLogic(World &world)
         uint8_t w = addSumWidth[idxOut];
         int ox = g[0];
         int oy = g[1];
-        int oz = g[2] + 1; // S toward +Z
+        int oz = g[2];
         if (!world.inside(ox, oy, oz))
             continue;
         BlockType outB = world.get(ox, oy, oz);
@@ -930,7 +1350,7 @@ void updateLogic(World &world)
         uint8_t val = addCoutVal[idxOut];
         uint8_t w = addCoutWidth[idxOut];
         int ox = g[0];
-        int oy = g[1] - 1; // Cout downward
+        int oy = g[1];
         int oz = g[2];
         if (!world.inside(ox, oy, oz))
             continue;
@@ -946,16 +1366,16 @@ void updateLogic(World &world)
     }
 
     auto pushComparatorOut = [&](const std::vector<std::array<int, 3>> &outs, const std::vector<uint8_t> &vals,
-                                 const std::vector<uint8_t> &widths, int dx, int dy, int dz)
+                                 const std::vector<uint8_t> &widths)
     {
         for (size_t idxOut = 0; idxOut < outs.size(); ++idxOut)
         {
             const auto &g = outs[idxOut];
             uint8_t val = vals[idxOut];
             uint8_t w = widths[idxOut];
-            int ox = g[0] + dx;
-            int oy = g[1] + dy;
-            int oz = g[2] + dz;
+            int ox = g[0];
+            int oy = g[1];
+            int oz = g[2];
             if (!world.inside(ox, oy, oz))
                 continue;
             if (val)
@@ -965,9 +1385,9 @@ void updateLogic(World &world)
         }
     };
     // ">": -Z, "=": +Z, "<": -Y
-    pushComparatorOut(compGtOutputs, compGtVal, compGtWidth, 0, 0, -1);
-    pushComparatorOut(compEqOutputs, compEqVal, compEqWidth, 0, 0, 1);
-    pushComparatorOut(compLtOutputs, compLtVal, compLtWidth, 0, -1, 0);
+    pushComparatorOut(compGtOutputs, compGtVal, compGtWidth);
+    pushComparatorOut(compEqOutputs, compEqVal, compEqWidth);
+    pushComparatorOut(compLtOutputs, compLtVal, compLtWidth);
 
     // NOT outputs go toward -X only (input on +X)
     for (size_t idxOut = 0; idxOut < notOutputs.size(); ++idxOut)
@@ -975,7 +1395,7 @@ void updateLogic(World &world)
         const auto &g = notOutputs[idxOut];
         uint8_t val = notOutVal[idxOut];
         uint8_t w = notOutWidth[idxOut];
-        int ox = g[0] - 1;
+        int ox = g[0];
         int oy = g[1];
         int oz = g[2];
         if (!world.inside(ox, oy, oz))
@@ -991,10 +1411,13 @@ void updateLogic(World &world)
         }
     }
 
+    SIM_STAT(endPhase(SimOutputWrites));
+
     while (!queue.empty())
     {
         int i = queue.back();
         queue.pop_back();
+        SIM_STAT(++stats.wirePops);
         int x = i % world.getWidth();
         int y = (i / world.getWidth()) / world.getDepth();
         int z = (i / world.getWidth()) % world.getDepth();
@@ -1014,6 +1437,8 @@ void updateLogic(World &world)
         }
     }
 
+    SIM_STAT(endPhase(SimWirePropagation));
+
     auto nextAtNonLed = [&](int x, int y, int z) -> uint8_t
     {
         if (!world.inside(x, y, z))
@@ -1042,13 +1467,18 @@ void updateLogic(World &world)
         }
     }
 
+    SIM_STAT(endPhase(SimLedPass));
+
+    bool changed = false;
     for (int flat : dffIndices)
     {
         int x = flat % world.getWidth();
         int y = (flat / world.getWidth()) / world.getDepth();
         int z = (flat / world.getWidth()) % world.getDepth();
+        changed |= world.getButtonState(x, y, z) != dffNextClk[flat];
         world.setButtonState(x, y, z, dffNextClk[flat]);
     }
+    SIM_STAT(endPhase(SimDffCommit));
 
     for (int y = 0; y < world.getHeight(); ++y)
     {
@@ -1059,9 +1489,19 @@ void updateLogic(World &world)
                 uint8_t old = world.getPower(x, y, z);
                 uint8_t nw = next[idx(x, y, z)];
                 if (old != nw)
-                    markChunkFromBlock(x, y, z);
+                {
+                    [[maybe_unused]] bool newlyDirty = markChunkFromBlock(x, y, z);
+                    SIM_STAT(++stats.changedVoxels; stats.dirtyChunks += newlyDirty);
+                }
             }
         }
     }
+    const uint8_t *planes = world.densePlanes();
+    changed = changed || std::memcmp(planes + PlanePower * static_cast<size_t>(total), next.data(), total) != 0 ||
+              std::memcmp(planes + PlanePowerWidth * static_cast<size_t>(total), nextWidth.data(), total) != 0;
     world.overwritePower(next, nextWidth);
+    if (!changed)
+        world.setLogicSettled();
+    SIM_STAT(endPhase(SimDirtyScan); publishSimStats(stats));
+    return true;
 }
@@ -1,25 +1,66 @@
 #pragma once
 
+#include "blocks.hpp"
 #include "types.hpp"
 
-#include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
-extern const std::map<BlockType, BlockInfo> BLOCKS;
 extern const std::vector<BlockType> HOTBAR;
 extern const std::vector<BlockType> INVENTORY_ALLOWED;
 
-bool isSolid(BlockType b);
-bool isTransparent(BlockType b);
-bool occludesFaces(BlockType b);
+// Clock edges are scheduled on a timer wheel of this many ticks. A Clock's half period is at most 255 ticks, so
+// every scheduled edge is less than one turn ahead and a slot only ever holds the edges of one tick.
+constexpr int CLOCK_WHEEL_SLOTS = 512;
+
+// Edits are tracked per 16^3 chunk, the same grid and index order as the .bulldog v11 chunk table
+constexpr int EDIT_CHUNK_SHIFT = 4;
+
+// The world's dense per-cell state: one byte plane of totalSize() cells per entry, stored back to back in this
+// order. Planes are World-owned heap memory, or external memory of the same layout (a mapped map file).
+enum DensePlane
+{
+    PlaneTiles,
+    PlanePower,
+    PlanePowerWidth,
+    PlaneButtonState,
+    PlaneButtonValue,
+    PlaneButtonWidth,
+    PlaneSplitterWidth,
+    PlaneSplitterOrder,
+    PlaneClockFreq,
+    DENSE_PLANE_COUNT
+};
 
 class World
 {
 public:
     World(int w, int h, int d);
+    // Deep copy into World-owned planes, whatever the source's storage (save snapshots)
+    World(const World &other);
+    World &operator=(const World &) = delete;
 
     BlockType get(int x, int y, int z) const;
+    // Copies `count` cells starting at (x, y, z) along +X into out; cells outside the world read as Air
+    void copyRow(int x, int y, int z, int count, BlockType *out) const;
     void set(int x, int y, int z, BlockType b);
+
+    // Bulk edits of the nx*ny*nz box at (x0, y0, z0), which must lie inside the world. Planes are written a row
+    // at a time and edits/redraws are noted once per chunk rather than per cell.
+    // Same result as set(b) on every cell of the box
+    void fillRegion(int x0, int y0, int z0, int nx, int ny, int nz, BlockType b);
+    // Copies `planes` in as is: DENSE_PLANE_COUNT planes of nx*ny*nz bytes, cells in y, z, x order (see
+    // defaultPlanes). Sign texts in the box are dropped.
+    void importRegion(int x0, int y0, int z0, int nx, int ny, int nz, const uint8_t *planes);
+    // The reverse of importRegion (sign texts are not included)
+    void exportRegion(int x0, int y0, int z0, int nx, int ny, int nz, uint8_t *planes) const;
+    // Blocks, attributes and sign texts of a box of src copied to (dx, dy, dz); src may be this world, even
+    // with overlapping boxes
+    void copyRegion(const World &src, int sx, int sy, int sz, int nx, int ny, int nz, int dx, int dy, int dz);
+    // importRegion planes for `count` cells of the given types, as set() leaves fresh blocks
+    static void defaultPlanes(const BlockType *types, int count, uint8_t *planes);
+
     uint8_t getPower(int x, int y, int z) const;
     uint8_t getPowerWidth(int x, int y, int z) const;
     void setPower(int x, int y, int z, uint8_t v);
@@ -38,32 +79,88 @@ public:
     void setClockFreq(int x, int y, int z, uint8_t freq);
     void toggleButton(int x, int y, int z);
     int index(int x, int y, int z) const;
+    void cellCoords(int idx, int &x, int &y, int &z) const;
     int totalSize() const;
     void overwritePower(const std::vector<uint8_t> &next, const std::vector<uint8_t> &nextWidth);
     int getWidth() const;
     int getHeight() const;
     int getDepth() const;
     void generate(unsigned seed);
+    // All air with default attributes and no signs, logic tick 0. Not an edit; the caller redraws.
+    void clear();
+    // Logic ticks run on this world so far; Clock phases follow it, so a world's simulation depends on its own
+    // state only (replays). Loading a map restarts it at 0.
+    uint64_t getLogicTick() const { return logicTick; }
+    void setLogicTick(uint64_t tick);
+    // Logic schedule (updateLogic). The world is settled when its last logic tick changed nothing; any change to
+    // its cells or tick unsettles it. A settled world can only change again at a Clock edge, so the edges are
+    // kept on a timer wheel and the ticks between them need no evaluation.
+    bool logicSettled() const { return settled; }
+    void setLogicSettled() { settled = true; }
+    // Moves to the next logic tick and returns how many Clocks have an edge (their output changes) at it; those
+    // come off the wheel with their next edge scheduled
+    int nextLogicTick();
+    // While settled, moves the tick forward by up to maxTicks, stopping just before the next Clock edge; returns
+    // the ticks skipped, each one the same as an updateLogic that evaluates nothing
+    uint64_t skipSettledTicks(uint64_t maxTicks);
     bool inside(int x, int y, int z) const;
     int surfaceY(int x, int z) const;
 
+    const uint8_t *densePlanes() const { return dense; }
+    size_t denseBytes() const { return static_cast<size_t>(totalSize()) * DENSE_PLANE_COUNT; }
+    // Moves the dense planes into external memory of denseBytes(); the memory must stay valid until the next
+    // bind or release. With copyCurrent false the memory's contents become the world (sign texts are cleared).
+    void bindDenseStorage(uint8_t *base, bool copyCurrent);
+    // Moves the dense planes back into World-owned memory
+    void releaseDenseStorage();
+    bool denseStorageBound() const { return dense != ownedDense.data(); }
+
+    // Chunks changed by set and the bulk edits, sign texts, button presses and the button/splitter/clock settings
+    // since the last call, in first-edit order. Simulation updates (power, latch state) are not edits.
+    std::vector<int> takeEditedChunks();
+    bool hasEditedChunks() const { return !editedChunks.empty(); }
+
     const std::string &getSignText(int x, int y, int z) const;
     void setSignText(int x, int y, int z, const std::string &text);
 
+    // Cell indices of every Button / Counter / Clock, kept current by set(). Other types return an empty list.
+    const std::vector<int> &blocksOfType(BlockType b) const;
+
 private:
+    void trackCell(BlockType b, int idx);
+    void untrackCell(BlockType b, int idx);
+    void pointPlanes(uint8_t *base);
+    void rebuildTypeCells();
+    void noteEdit(int x, int y, int z);
+    void noteRegion(int x0, int y0, int z0, int nx, int ny, int nz);
+    void unsettle(bool clocksChanged);
+    void scheduleClocks(uint64_t from);
+
     int width;
     int height;
     int depth;
-    std::vector<BlockType> tiles;
-    std::vector<uint8_t> power;
-    std::vector<uint8_t> powerWidth;
-    std::vector<uint8_t> buttonState;
-    std::vector<uint8_t> buttonValue;
-    std::vector<uint8_t> buttonWidth;
-    std::vector<uint8_t> splitterWidth;
-    std::vector<uint8_t> splitterOrder;
-    std::vector<uint8_t> clockFreq;
-    std::vector<std::string> signText;
+    std::vector<uint8_t> ownedDense; // plane memory unless bound elsewhere
+    uint8_t *dense = nullptr;        // start of the planes in use
+    BlockType *tiles = nullptr;
+    uint8_t *power = nullptr;
+    uint8_t *powerWidth = nullptr;
+    uint8_t *buttonState = nullptr;
+    uint8_t *buttonValue = nullptr;
+    uint8_t *buttonWidth = nullptr;
+    uint8_t *splitterWidth = nullptr;
+    uint8_t *splitterOrder = nullptr;
+    uint8_t *clockFreq = nullptr;
+    std::unordered_map<int, std::string> signText; // signs that have text, by cell index
+    std::array<std::vector<int>, 3> typeCells; // per indexed type, see indexedTypeSlot
+    std::vector<int> typeCellPos;              // per cell: position in its typeCells list, or -1
+    uint64_t logicTick = 0;
+    bool settled = false;
+    bool clockWheelStale = true;              // Clocks placed, removed or retuned since it was built
+    std::vector<std::vector<int>> clockWheel; // Clock cells by edge tick modulo CLOCK_WHEEL_SLOTS
+    int editChunksX = 0;
+    int editChunksZ = 0;
+    std::vector<uint8_t> editedFlags; // per edit chunk
+    std::vector<int> editedChunks;
 };
 
 HitInfo raycast(const World &world, float ox, float oy, float oz, float dx, float dy, float dz, float maxDist);
@@ -71,4 +168,40 @@ HitInfo raycast(const World &world, float ox, float oy, float oz, float dx, floa
 bool collidesAt(const World &world, float px, float py, float pz, float playerHeight);
 bool blockIntersectsPlayer(const Player &player, int bx, int by, int bz, float playerHeight);
 
-void updateLogic(World &world);
+// One logic tick. False when the world was settled and no Clock had an edge: the tick evaluated nothing.
+bool updateLogic(World &world);
+
+// Counters of the last updateLogic call (F6 panel, --sim-stats runs), collected while gSimStatsEnabled is set.
+// Builds without LOGICRAFT_SIM_STATS (a CMake option, on by default) leave the collection code out entirely.
+#ifdef LOGICRAFT_SIM_STATS
+constexpr bool SIM_STATS_BUILT = true;
+#else
+constexpr bool SIM_STATS_BUILT = false;
+#endif
+
+enum SimPhase
+{
+    SimGateScan,
+    SimOutputWrites,
+    SimWirePropagation,
+    SimLedPass,
+    SimDffCommit,
+    SimDirtyScan,
+    SIM_PHASE_COUNT
+};
+
+struct SimStats
+{
+    std::array<uint32_t, BLOCK_TYPE_COUNT> evaluated{}; // logic blocks by type; wires count as wirePops
+    uint32_t wirePushes = 0;
+    uint32_t wirePops = 0;
+    uint32_t peakQueue = 0;     // largest wire queue during propagation
+    uint32_t changedVoxels = 0; // cells whose power changed
+    uint32_t dirtyChunks = 0;   // render chunks newly marked for a rebuild
+    std::array<double, SIM_PHASE_COUNT> phaseMs{};
+    uint32_t clockEdges = 0; // Clocks whose output changed this tick
+    bool skipped = false;    // settled world, no Clock edge: nothing evaluated
+};
+extern SimStats gSimStats;
+extern bool gSimStatsEnabled;
+const char *simPhaseName(SimPhase phase);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the headless tests: a failed CHECK prints where and the test exits non-zero
+inline int gCheckFailures = 0;
+
+#define CHECK(cond)                                                                                                    \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);                            \
+            ++gCheckFailures;                                                                                          \
+        }                                                                                                              \
+    } while (0)
@@ -0,0 +1,242 @@
+#include "replay.hpp"
+#include "undo.hpp"
+#include "world.hpp"
+
+#include "check.hpp"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+// The Clock timer wheel against a world that evaluates every tick: after each edit that moves a Clock edge
+// (placing, removing or retuning a Clock, undo/redo, replay edits) the skipping world must stay identical to it,
+// and a settled world must only wake up at edges.
+
+constexpr int W = 48, H = 32, D = 48;
+constexpr int Y = H / 4; // first air layer above generate's terrain
+
+static void placeClock(World &w, int x, int z, uint8_t freq, int wireLength)
+{
+    w.set(x, Y, z, BlockType::Clock);
+    w.setClockFreq(x, Y, z, freq);
+    for (int i = 1; i <= wireLength; ++i)
+        w.set(x + i, Y, z, i % 7 == 0 ? BlockType::NotGate : BlockType::Wire);
+    w.set(x + 3, Y, z + 1, BlockType::Led);
+}
+
+static void buildCircuit(World &w)
+{
+    w.generate(1);
+    placeClock(w, 2, 4, 1, 25);
+    placeClock(w, 2, 10, 128, 20);
+    // DFF: D on +X from a fast clock, CLK on -X from a slow one
+    w.set(22, Y, 16, BlockType::Clock);
+    w.setClockFreq(22, Y, 16, 240);
+    w.set(21, Y, 16, BlockType::Wire);
+    w.set(18, Y, 16, BlockType::Clock);
+    w.setClockFreq(18, Y, 16, 3);
+    w.set(19, Y, 16, BlockType::Wire);
+    w.set(20, Y, 16, BlockType::DFlipFlop);
+    w.set(20, Y, 17, BlockType::Wire);
+}
+
+struct Pair
+{
+    World fast{W, H, D}; // skips settled ticks
+    World ref{W, H, D};  // unsettled before every tick, so every tick is evaluated
+    int evaluated = 0;   // ticks the fast world evaluated
+    bool diverged = false;
+
+    Pair()
+    {
+        buildCircuit(fast);
+        buildCircuit(ref);
+    }
+
+    template <typename Edit> void edit(Edit e)
+    {
+        e(fast);
+        e(ref);
+    }
+
+    // The undo history is global: undo/redo run on the fast world, the reference copies the cells they rewrote
+    void mirror(const std::vector<std::array<int, 6>> &boxes)
+    {
+        for (const auto &b : boxes)
+        {
+            std::vector<uint8_t> planes(static_cast<size_t>(b[3]) * b[4] * b[5] * DENSE_PLANE_COUNT);
+            fast.exportRegion(b[0], b[1], b[2], b[3], b[4], b[5], planes.data());
+            ref.importRegion(b[0], b[1], b[2], b[3], b[4], b[5], planes.data());
+        }
+    }
+
+    // Runs `ticks` ticks, applying `replay` edits when given; false once the worlds differ
+    bool run(int ticks, const Replay *replay = nullptr)
+    {
+        size_t fastCursor = 0, refCursor = 0;
+        for (int t = 0; t < ticks && !diverged; ++t)
+        {
+            if (replay)
+            {
+                replayApply(fast, *replay, fastCursor);
+                replayApply(ref, *replay, refCursor);
+            }
+            if (fast.skipSettledTicks(1) == 0)
+                evaluated += updateLogic(fast);
+            ref.setPower(0, 0, 0, ref.getPower(0, 0, 0));
+            CHECK(updateLogic(ref));
+            diverged = fast.getLogicTick() != ref.getLogicTick() ||
+                       std::memcmp(fast.densePlanes(), ref.densePlanes(), fast.denseBytes()) != 0;
+            CHECK(!diverged);
+        }
+        return !diverged;
+    }
+
+    // Ticks the fast world evaluates over `ticks` ticks
+    int evaluatedOver(int ticks, const Replay *replay = nullptr)
+    {
+        const int before = evaluated;
+        run(ticks, replay);
+        return evaluated - before;
+    }
+};
+
+static void testSettledWorldSleeps()
+{
+    Pair p;
+    CHECK(p.run(1100));
+    // edges every 255, 128, 16 and 253 ticks, plus a few ticks of propagation after each
+    CHECK(p.evaluated < 400);
+
+    // skipping ahead stops right before the next edge
+    World &w = p.fast;
+    while (!w.logicSettled())
+        updateLogic(w);
+    const uint64_t skipped = w.skipSettledTicks(10000);
+    CHECK(skipped > 0 && skipped < 255);
+    CHECK(w.skipSettledTicks(10000) == 0);
+    CHECK(updateLogic(w));
+}
+
+static void testPlaceClock()
+{
+    Pair p;
+    p.run(300);
+    p.edit([](World &w) { placeClock(w, 2, 30, 250, 12); });
+    CHECK(p.run(600));
+    // a half period of 6 ticks wakes the world at least 100 times in 600 ticks
+    CHECK(p.evaluatedOver(600) >= 100);
+
+    // set() alone, at the default frequency
+    p.edit(
+        [](World &w)
+        {
+            w.set(2, Y, 36, BlockType::Clock);
+            w.set(3, Y, 36, BlockType::Wire);
+        });
+    CHECK(p.run(600));
+}
+
+static void testRemoveClocks()
+{
+    Pair p;
+    p.run(300);
+    p.edit(
+        [](World &w)
+        {
+            for (int z : {4, 10, 16})
+                for (int x = 0; x < W; ++x)
+                    if (w.get(x, Y, z) == BlockType::Clock)
+                        w.set(x, Y, z, BlockType::Air);
+        });
+    CHECK(p.run(50));
+    // no Clock left: nothing is scheduled and a settled world never wakes up
+    CHECK(p.evaluatedOver(1000) == 0);
+}
+
+static void testRetuneClock()
+{
+    Pair p;
+    p.run(200);
+    p.edit([](World &w) { w.setClockFreq(2, Y, 4, 254); });
+    CHECK(p.run(300));
+    p.edit([](World &w) { w.setClockFreq(2, Y, 10, 1); });
+    CHECK(p.run(600));
+}
+
+static void testUndoRedo()
+{
+    Pair p;
+    p.run(150);
+    undoClear();
+    undoRecordCell(p.fast, 2, Y, 22);
+    p.edit(
+        [](World &w)
+        {
+            w.set(2, Y, 22, BlockType::Clock);
+            w.setClockFreq(2, Y, 22, 220);
+            w.set(3, Y, 22, BlockType::Wire);
+        });
+    CHECK(p.run(200));
+    std::vector<std::array<int, 6>> touched;
+    CHECK(undoStep(p.fast, &touched));
+    p.mirror(touched);
+    CHECK(p.run(200));
+    touched.clear();
+    CHECK(redoStep(p.fast, &touched));
+    p.mirror(touched);
+    CHECK(p.run(200));
+    // retuned, then undone back to the first frequency
+    undoRecordCell(p.fast, 2, Y, 22);
+    p.edit([](World &w) { w.setClockFreq(2, Y, 22, 10); });
+    CHECK(p.run(150));
+    touched.clear();
+    CHECK(undoStep(p.fast, &touched));
+    p.mirror(touched);
+    CHECK(p.run(300));
+    undoClear();
+}
+
+static void testReplayApply()
+{
+    // a replay that places a fast Clock, retunes it, then removes the slow one
+    Pair p;
+    p.run(100);
+    Replay replay;
+    replay.width = W;
+    replay.height = H;
+    replay.depth = D;
+    replay.startTick = 0;
+    replay.endTick = 100000;
+    auto cellEdit = [](uint64_t tick, int x, int z, BlockType b, uint8_t freq)
+    {
+        ReplayEdit e;
+        e.tick = tick;
+        e.x = x;
+        e.y = Y;
+        e.z = z;
+        e.nx = e.ny = e.nz = 1;
+        e.planes.resize(DENSE_PLANE_COUNT);
+        World::defaultPlanes(&b, 1, e.planes.data());
+        if (b == BlockType::Clock)
+            e.planes[PlaneClockFreq] = freq;
+        return e;
+    };
+    const uint64_t now = p.fast.getLogicTick();
+    replay.edits.push_back(cellEdit(now + 40, 30, 30, BlockType::Clock, 200));
+    replay.edits.push_back(cellEdit(now + 41, 31, 30, BlockType::Wire, 0));
+    replay.edits.push_back(cellEdit(now + 300, 30, 30, BlockType::Clock, 90));
+    replay.edits.push_back(cellEdit(now + 500, 2, 4, BlockType::Air, 0));
+    CHECK(p.run(900, &replay));
+}
+
+int main()
+{
+    testSettledWorldSleeps();
+    testPlaceClock();
+    testRemoveClocks();
+    testRetuneClock();
+    testUndoRedo();
+    testReplayApply();
+    return gCheckFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,3 @@
+// The tests run World without a renderer: redraw marks have nowhere to go
+bool markChunkFromBlock(int, int, int) { return false; }
+void markAllChunksDirty() {}
@@ -0,0 +1,127 @@
+#include "save.hpp"
+#include "world.hpp"
+
+#include "check.hpp"
+
+#include <filesystem>
+#include <string>
+
+// Chunked saves, streaming loads and the autosave journal bring back the state a circuit runs on, not only the
+// blocks: D flip-flop clock latches included, or a flip-flop with its clock held high re-latches after a load
+
+static const int W = 40, H = 24, D = 40;
+
+// Flip-flops with the latch set and clear, in different chunks, plus settings of the other stateful blocks
+static void build(World &w)
+{
+    w.clear();
+    w.set(1, 1, 1, BlockType::DFlipFlop);
+    w.setButtonState(1, 1, 1, 1);
+    w.set(2, 1, 1, BlockType::DFlipFlop);
+    w.setButtonState(2, 1, 1, 0);
+    w.set(33, 20, 35, BlockType::DFlipFlop);
+    w.setButtonState(33, 20, 35, 1);
+    w.setPower(33, 20, 35, 1);
+    w.set(5, 2, 5, BlockType::Button);
+    w.setButtonWidth(5, 2, 5, 4);
+    w.setButtonValue(5, 2, 5, 9);
+    w.setButtonState(5, 2, 5, 1);
+    w.set(6, 2, 5, BlockType::Clock);
+    w.setClockFreq(6, 2, 5, 200);
+}
+
+static void checkBuilt(const World &w)
+{
+    CHECK(w.get(1, 1, 1) == BlockType::DFlipFlop && w.getButtonState(1, 1, 1) == 1);
+    CHECK(w.get(2, 1, 1) == BlockType::DFlipFlop && w.getButtonState(2, 1, 1) == 0);
+    CHECK(w.get(33, 20, 35) == BlockType::DFlipFlop && w.getButtonState(33, 20, 35) == 1);
+    CHECK(w.getPower(33, 20, 35) == 1);
+    CHECK(w.getButtonWidth(5, 2, 5) == 4 && w.getButtonValue(5, 2, 5) == 9 && w.getButtonState(5, 2, 5) == 1);
+    CHECK(w.getClockFreq(6, 2, 5) == 200);
+}
+
+static void testSaveLoad(const std::string &path)
+{
+    World saved(W, H, D), loaded(W, H, D);
+    build(saved);
+    uint32_t seed = 0;
+    CHECK(saveWorldToFile(saved, path, 77));
+    CHECK(loadWorldFromFile(loaded, path, seed));
+    CHECK(seed == 77);
+    checkBuilt(loaded);
+}
+
+static void testStreamingLoad(const std::string &path)
+{
+    World saved(W, H, D), loaded(W, H, D);
+    build(saved);
+    uint32_t seed = 0;
+    CHECK(saveWorldToFile(saved, path, 77));
+    // focus on one flip-flop's column so both the up-front column and the worker's chunks are covered
+    CHECK(beginStreamingLoad(loaded, path, 1, 1, seed));
+    std::string donePath;
+    bool ok = false;
+    while (!pumpStreamingLoad(loaded, donePath, ok))
+    {
+    }
+    CHECK(ok && donePath == path);
+    checkBuilt(loaded);
+}
+
+static void testJournal(const std::filesystem::path &dir)
+{
+    const std::string path = (dir / "journal.bulldog").string();
+    World live(W, H, D), recovered(W, H, D);
+    live.clear();
+    CHECK(saveWorldToFile(live, path, 5));
+    startAutosave(live, path);
+    build(live);
+    autosaveTick(live, 5, 1.0f, 0.5f); // appends the edited chunks to the journal
+
+    std::string recoveredPath;
+    uint32_t seed = 0;
+    CHECK(recoverFromJournal(recovered, dir.string(), recoveredPath, seed));
+    CHECK(recoveredPath == path && seed == 5);
+    checkBuilt(recovered);
+    stopAutosave(recovered, seed);
+}
+
+// A generated world is only written once it is edited
+static void testLazyBase(const std::filesystem::path &dir)
+{
+    const std::string path = (dir / "autosave.bulldog").string();
+    World live(W, H, D), loaded(W, H, D);
+    live.clear();
+    startAutosave(live, path, false);
+    autosaveTick(live, 5, 1.0f, 0.5f);
+    waitForAsyncSave();
+    CHECK(!std::filesystem::exists(path));
+
+    build(live);
+    autosaveTick(live, 5, 1.0f, 0.5f);
+    waitForAsyncSave();
+    uint32_t seed = 0;
+    CHECK(loadWorldFromFile(loaded, path, seed));
+    checkBuilt(loaded);
+    stopAutosave(live, 5);
+
+    // nothing edited: the clean exit does not write it either
+    const std::string untouched = (dir / "untouched.bulldog").string();
+    startAutosave(live, untouched, false);
+    stopAutosave(live, 5);
+    CHECK(!std::filesystem::exists(untouched));
+}
+
+int main()
+{
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "logicraft_save_roundtrip_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "journal");
+    testSaveLoad((dir / "saved.bulldog").string());
+    testStreamingLoad((dir / "streamed.bulldog").string());
+    testJournal(dir / "journal");
+    testLazyBase(dir);
+    fs::remove_all(dir);
+    return gCheckFailures == 0 ? 0 : 1;
+}
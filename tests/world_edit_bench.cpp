@@ -0,0 +1,145 @@
+#include "world.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+// Bulk World edits against the per-cell path they replace (set() plus one setter per attribute), on a
+// 256x64x256 world by default. Prints key/value lines: "<case> set_ms <t> bulk_ms <t> speedup <x>", the best of
+// `runs` timings each. Usage: world_edit_bench [runs [width height depth]]
+
+static double bestMs(int runs, const std::function<void()> &prepare, const std::function<void()> &run)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r)
+    {
+        prepare();
+        auto start = std::chrono::steady_clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+static void report(const char *name, double setMs, double bulkMs)
+{
+    std::printf("%s set_ms %.3f bulk_ms %.3f speedup %.1f\n", name, setMs, bulkMs, setMs / std::max(bulkMs, 1e-6));
+}
+
+// One cell's planes written through the per-cell API, as the loaders did before importRegion
+static void setCell(World &w, int x, int y, int z, const uint8_t *planes, size_t n, size_t i)
+{
+    const BlockType b = static_cast<BlockType>(planes[PlaneTiles * n + i]);
+    w.set(x, y, z, b);
+    w.setPower(x, y, z, planes[PlanePower * n + i]);
+    w.setPowerWidth(x, y, z, planes[PlanePowerWidth * n + i]);
+    w.setButtonState(x, y, z, planes[PlaneButtonState * n + i]);
+    if (b == BlockType::Button)
+    {
+        w.setButtonWidth(x, y, z, planes[PlaneButtonWidth * n + i]);
+        w.setButtonValue(x, y, z, planes[PlaneButtonValue * n + i]);
+    }
+    else if (b == BlockType::Splitter || b == BlockType::Merger)
+    {
+        w.setSplitterWidth(x, y, z, planes[PlaneSplitterWidth * n + i]);
+        w.setSplitterOrder(x, y, z, planes[PlaneSplitterOrder * n + i]);
+    }
+    else if (b == BlockType::Clock)
+        w.setClockFreq(x, y, z, planes[PlaneClockFreq * n + i]);
+}
+
+int main(int argc, char **argv)
+{
+    const int runs = std::max(1, argc >= 2 ? std::atoi(argv[1]) : 5);
+    const int width = std::max(16, argc >= 5 ? std::atoi(argv[2]) : 256);
+    const int height = std::max(16, argc >= 5 ? std::atoi(argv[3]) : 64);
+    const int depth = std::max(16, argc >= 5 ? std::atoi(argv[4]) : 256);
+    World world(width, height, depth);
+    std::printf("size %dx%dx%d\nruns %d\n", width, height, depth, runs);
+
+    // generate: the terrain layers, cell by cell or a layer per fillRegion
+    const int surface = height / 4;
+    auto layer = [&](int y)
+    {
+        if (y < surface - 2)
+            return BlockType::Stone;
+        if (y < surface - 1)
+            return BlockType::Dirt;
+        return y == surface - 1 ? BlockType::Grass : BlockType::Air;
+    };
+    double setMs = bestMs(runs, [&] { world.clear(); },
+                          [&]
+                          {
+                              for (int y = 0; y < height; ++y)
+                                  for (int z = 0; z < depth; ++z)
+                                      for (int x = 0; x < width; ++x)
+                                          world.set(x, y, z, layer(y));
+                          });
+    double bulkMs = bestMs(runs, [&] { world.clear(); }, [&] { world.generate(1); });
+    report("generate", setMs, bulkMs);
+
+    // fill a box of a logic block
+    const int nx = std::min(64, width), ny = std::min(44, height - surface), nz = std::min(64, depth);
+    const int x0 = 0, y0 = surface, z0 = 0;
+    setMs = bestMs(runs, [&] { world.generate(1); },
+                   [&]
+                   {
+                       for (int y = y0; y < y0 + ny; ++y)
+                           for (int z = z0; z < z0 + nz; ++z)
+                               for (int x = x0; x < x0 + nx; ++x)
+                                   world.set(x, y, z, BlockType::Wire);
+                   });
+    bulkMs = bestMs(runs, [&] { world.generate(1); },
+                    [&] { world.fillRegion(x0, y0, z0, nx, ny, nz, BlockType::Wire); });
+    report("fill", setMs, bulkMs);
+
+    // import a box of mixed blocks and attributes, as a map load does
+    const size_t boxCells = static_cast<size_t>(nx) * ny * nz;
+    std::vector<BlockType> types(boxCells);
+    const BlockType mix[] = {BlockType::Wire, BlockType::Air, BlockType::NotGate, BlockType::Button,
+                             BlockType::Clock, BlockType::Stone, BlockType::Splitter, BlockType::Led};
+    for (size_t i = 0; i < boxCells; ++i)
+        types[i] = mix[(i * 5 + i / 7) % 8];
+    std::vector<uint8_t> planes(boxCells * DENSE_PLANE_COUNT);
+    World::defaultPlanes(types.data(), static_cast<int>(boxCells), planes.data());
+    for (size_t i = 0; i < boxCells; ++i)
+        planes[PlanePower * boxCells + i] = static_cast<uint8_t>(i % 3);
+    setMs = bestMs(runs, [&] { world.generate(1); },
+                   [&]
+                   {
+                       size_t i = 0;
+                       for (int y = y0; y < y0 + ny; ++y)
+                           for (int z = z0; z < z0 + nz; ++z)
+                               for (int x = x0; x < x0 + nx; ++x, ++i)
+                                   setCell(world, x, y, z, planes.data(), boxCells, i);
+                   });
+    bulkMs = bestMs(runs, [&] { world.generate(1); },
+                    [&] { world.importRegion(x0, y0, z0, nx, ny, nz, planes.data()); });
+    report("import", setMs, bulkMs);
+
+    // copy that box beside itself
+    const int dx = std::max(0, std::min(x0 + nx, width - nx));
+    std::vector<uint8_t> cell(DENSE_PLANE_COUNT);
+    auto prepareCopy = [&]
+    {
+        world.generate(1);
+        world.importRegion(x0, y0, z0, nx, ny, nz, planes.data());
+    };
+    setMs = bestMs(runs, prepareCopy,
+                   [&]
+                   {
+                       for (int y = 0; y < ny; ++y)
+                           for (int z = 0; z < nz; ++z)
+                               for (int x = 0; x < nx; ++x)
+                               {
+                                   world.exportRegion(x0 + x, y0 + y, z0 + z, 1, 1, 1, cell.data());
+                                   setCell(world, dx + x, y0 + y, z0 + z, cell.data(), 1, 0);
+                               }
+                   });
+    bulkMs = bestMs(runs, prepareCopy, [&] { world.copyRegion(world, x0, y0, z0, nx, ny, nz, dx, y0, z0); });
+    report("copy", setMs, bulkMs);
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "world.hpp"
+
+#include "check.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// The bulk edits against the per-cell API they replace: same planes, sign texts, type lists and edited chunks
+
+static const BlockType MIXED[] = {BlockType::Stone,  BlockType::Button,    BlockType::Clock,     BlockType::Sign,
+                                  BlockType::Wire,   BlockType::Splitter,  BlockType::Merger,    BlockType::DFlipFlop,
+                                  BlockType::Counter, BlockType::NotGate,  BlockType::Air};
+
+// Every kind of per-cell state set away from its default, the same way on every call
+static void scatter(World &w)
+{
+    w.clear();
+    int i = 0;
+    for (int y = 0; y < w.getHeight(); ++y)
+        for (int z = 0; z < w.getDepth(); ++z)
+            for (int x = 0; x < w.getWidth(); ++x, ++i)
+            {
+                BlockType b = MIXED[(i * 7 + y) % (sizeof(MIXED) / sizeof(MIXED[0]))];
+                w.set(x, y, z, b);
+                w.setPower(x, y, z, static_cast<uint8_t>(i * 13));
+                w.setPowerWidth(x, y, z, static_cast<uint8_t>(1 + i % 8));
+                w.setButtonState(x, y, z, static_cast<uint8_t>(i & 1)); // DFF latch or pressed button
+                if (b == BlockType::Button)
+                {
+                    w.setButtonWidth(x, y, z, 4);
+                    w.setButtonValue(x, y, z, 9);
+                }
+                else if (b == BlockType::Clock)
+                    w.setClockFreq(x, y, z, 200);
+                else if (b == BlockType::Splitter || b == BlockType::Merger)
+                {
+                    w.setSplitterWidth(x, y, z, 3);
+                    w.setSplitterOrder(x, y, z, 1);
+                }
+                else if (b == BlockType::Sign)
+                    w.setSignText(x, y, z, "s" + std::to_string(i));
+            }
+    w.takeEditedChunks();
+}
+
+static std::vector<int> sorted(std::vector<int> v)
+{
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+static bool sameWorld(const World &a, const World &b)
+{
+    if (a.denseBytes() != b.denseBytes() || std::memcmp(a.densePlanes(), b.densePlanes(), a.denseBytes()) != 0)
+        return false;
+    for (BlockType t : {BlockType::Button, BlockType::Counter, BlockType::Clock})
+        if (sorted(a.blocksOfType(t)) != sorted(b.blocksOfType(t)))
+            return false;
+    for (int y = 0; y < a.getHeight(); ++y)
+        for (int z = 0; z < a.getDepth(); ++z)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (a.getSignText(x, y, z) != b.getSignText(x, y, z))
+                    return false;
+    return true;
+}
+
+static void testFillMatchesSet()
+{
+    World bulk(40, 24, 40), cells(40, 24, 40);
+    const int x0 = 5, y0 = 3, z0 = 9, nx = 27, ny = 17, nz = 20;
+    for (BlockType b : MIXED)
+    {
+        scatter(bulk);
+        scatter(cells);
+        bulk.fillRegion(x0, y0, z0, nx, ny, nz, b);
+        for (int y = y0; y < y0 + ny; ++y)
+            for (int z = z0; z < z0 + nz; ++z)
+                for (int x = x0; x < x0 + nx; ++x)
+                    cells.set(x, y, z, b);
+        CHECK(sameWorld(bulk, cells));
+        CHECK(sorted(bulk.takeEditedChunks()) == sorted(cells.takeEditedChunks()));
+    }
+}
+
+static void testImportExportRoundTrip()
+{
+    World src(40, 24, 40), dst(40, 24, 40);
+    scatter(src);
+    const int nx = 13, ny = 9, nz = 17;
+    std::vector<uint8_t> planes(static_cast<size_t>(nx) * ny * nz * DENSE_PLANE_COUNT);
+    src.exportRegion(4, 2, 6, nx, ny, nz, planes.data());
+    dst.importRegion(20, 10, 15, nx, ny, nz, planes.data());
+    std::vector<uint8_t> back(planes.size());
+    dst.exportRegion(20, 10, 15, nx, ny, nz, back.data());
+    CHECK(planes == back);
+    // the type lists follow the imported cells
+    for (BlockType t : {BlockType::Button, BlockType::Counter, BlockType::Clock})
+        for (int idx : dst.blocksOfType(t))
+        {
+            int x, y, z;
+            dst.cellCoords(idx, x, y, z);
+            CHECK(dst.get(x, y, z) == t);
+        }
+}
+
+static void testCopyRegion()
+{
+    World src(40, 24, 40), bulk(40, 24, 40), cells(40, 24, 40);
+    scatter(src);
+    const int sx = 3, sy = 2, sz = 4, nx = 15, ny = 10, nz = 12, dx = 20, dy = 11, dz = 25;
+    bulk.copyRegion(src, sx, sy, sz, nx, ny, nz, dx, dy, dz);
+    for (int y = 0; y < ny; ++y)
+        for (int z = 0; z < nz; ++z)
+            for (int x = 0; x < nx; ++x)
+            {
+                std::vector<uint8_t> cell(DENSE_PLANE_COUNT);
+                src.exportRegion(sx + x, sy + y, sz + z, 1, 1, 1, cell.data());
+                cells.importRegion(dx + x, dy + y, dz + z, 1, 1, 1, cell.data());
+                const std::string &text = src.getSignText(sx + x, sy + y, sz + z);
+                if (!text.empty())
+                    cells.setSignText(dx + x, dy + y, dz + z, text);
+            }
+    CHECK(sameWorld(bulk, cells));
+
+    // overlapping, within one world: the box is read before it is written
+    World self(40, 24, 40), expect(40, 24, 40);
+    scatter(self);
+    scatter(expect);
+    expect.copyRegion(self, 2, 2, 2, 20, 12, 20, 0, 0, 0);
+    self.copyRegion(self, 2, 2, 2, 20, 12, 20, 0, 0, 0);
+    CHECK(sameWorld(self, expect));
+}
+
+int main()
+{
+    testFillMatchesSet();
+    testImportExportRoundTrip();
+    testCopyRegion();
+    return gCheckFailures == 0 ? 0 : 1;
+}